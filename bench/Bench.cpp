@@ -0,0 +1,129 @@
+#include "Bench.h"
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <stdlib.h>
+
+//----------------------------------------------------------------------------
+// Zählender Allocator. Vor jedem Block liegt seine Größe, damit delete den
+// aktuellen Stand korrekt abziehen kann.
+//----------------------------------------------------------------------------
+static Bench::AllocStats counters;
+static constexpr size_t kHeader = alignof(max_align_t);
+
+static void* countedAlloc(size_t size) {
+    uint8_t *p = (uint8_t*)malloc(size + kHeader);
+    if (!p) return nullptr;
+    memcpy(p, &size, sizeof(size));
+    counters.allocs++;
+    counters.bytes += size;
+    counters.current += size;
+    if (counters.current > counters.peak) counters.peak = counters.current;
+    NativeHost::heapUsed = counters.current;
+    return p + kHeader;
+}
+
+static void countedFree(void *ptr) {
+    if (!ptr) return;
+    uint8_t *p = (uint8_t*)ptr - kHeader;
+    size_t size;
+    memcpy(&size, p, sizeof(size));
+    counters.current -= size;
+    NativeHost::heapUsed = counters.current;
+    free(p);
+}
+
+void* operator new(size_t size) {
+    void *p = countedAlloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void operator delete(void *ptr) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, size_t) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, const std::nothrow_t&) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t&) noexcept { countedFree(ptr); }
+
+namespace Bench {
+
+const AllocStats& allocStats() {
+    return counters;
+}
+
+void resetPeak() {
+    counters.peak = counters.current;
+}
+
+Result run(const char *name, uint64_t minIterations, const std::function<size_t()> &fn) {
+    return run(name, minIterations, fn, 0, nullptr);
+}
+
+Result run(const char *name, uint64_t minIterations, const std::function<size_t()> &fn,
+           uint64_t every, const std::function<void()> &reset) {
+    using Clock = std::chrono::steady_clock;
+    Result r;
+    r.name = name;
+
+    // Aufwärmen: Caches (PageCache, TemplateEngine) füllen, nicht mitzählen
+    r.wireBytes = fn();
+    if (every) reset();
+
+    size_t base = counters.current;
+    resetPeak();
+    uint64_t allocs = counters.allocs;
+    uint64_t bytes = counters.bytes;
+    Clock::duration elapsed{};
+    auto start = Clock::now();
+    auto minTime = std::chrono::milliseconds(kMinTimeMs);
+    while (r.iterations < minIterations || elapsed + (Clock::now() - start) < minTime) {
+        fn();
+        r.iterations++;
+        if (every && r.iterations % every == 0) {
+            elapsed += Clock::now() - start;
+            // Allokationen von reset() zählen nicht zum Fall
+            uint64_t a = counters.allocs, b = counters.bytes;
+            size_t peak = counters.peak;
+            reset();
+            allocs += counters.allocs - a;
+            bytes += counters.bytes - b;
+            counters.peak = std::max(peak, counters.current);
+            start = Clock::now();
+        }
+    }
+    elapsed += Clock::now() - start;
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+
+    r.nsPerOp = ns / r.iterations;
+    r.opsPerSec = 1e9 / r.nsPerOp;
+    r.allocsPerOp = (double)(counters.allocs - allocs) / r.iterations;
+    r.bytesPerOp = (double)(counters.bytes - bytes) / r.iterations;
+    r.peakHeap = counters.peak - base;
+    return r;
+}
+
+String toJson(const std::vector<Result> &results) {
+    String json = "{\n  \"results\": [\n";
+    char line[256];
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &r = results[i];
+        snprintf(line, sizeof(line),
+                 "    {\"name\": \"%s\", \"iterations\": %llu, \"ops_per_sec\": %.1f, \"ns_per_op\": %.1f, "
+                 "\"allocs_per_op\": %.2f, \"bytes_per_op\": %.1f, \"peak_heap\": %zu, \"wire_bytes\": %zu",
+                 r.name.c_str(), (unsigned long long)r.iterations, r.opsPerSec, r.nsPerOp,
+                 r.allocsPerOp, r.bytesPerOp, r.peakHeap, r.wireBytes);
+        json += line;
+        for (const auto &e : r.extra) {
+            snprintf(line, sizeof(line), ", \"%s\": %.2f", e.first.c_str(), e.second);
+            json += line;
+        }
+        json += i + 1 < results.size() ? "},\n" : "}\n";
+    }
+    json += "  ]\n}\n";
+    return json;
+}
+
+} // namespace Bench
@@ -0,0 +1,56 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+
+//----------------------------------------------------------------------------
+// Bench
+// Minimaler Microbenchmark-Rahmen für den Host (env:native_bench). Ein
+// eigener operator new/delete zählt Allokationen, Bytes und den Spitzenwert
+// des Heaps während eines Falls; NativeHost::heapUsed wird mitgeführt, damit
+// ESP.getFreeHeap() auf dem Host etwas Sinnvolles meldet.
+//
+// Jeder Fall läuft mindestens minIterations mal und mindestens kMinTimeMs
+// lang. Ergebnisse als JSON (toJson), zum Vergleich zwischen Commits siehe
+// tools/bench_compare.py.
+//----------------------------------------------------------------------------
+namespace Bench {
+
+struct Result {
+    String   name;
+    uint64_t iterations = 0;
+    double   opsPerSec = 0;
+    double   nsPerOp = 0;
+    double   allocsPerOp = 0;
+    double   bytesPerOp = 0;     // angeforderte Bytes pro Durchlauf
+    size_t   peakHeap = 0;       // höchster Heap-Stand über dem Stand vor dem Fall
+    size_t   wireBytes = 0;      // Antwortgröße (Header + Body), 0 = nicht zutreffend
+    std::vector<std::pair<String, double>> extra;   // fallspezifische Kennzahlen
+};
+
+struct AllocStats {
+    uint64_t allocs = 0;
+    uint64_t bytes = 0;
+    size_t   current = 0;
+    size_t   peak = 0;
+};
+
+constexpr uint32_t kMinTimeMs = 200;
+
+const AllocStats& allocStats();
+void resetPeak();
+
+// fn ist ein Durchlauf; Rückgabe = Antwortbytes (für wireBytes), sonst 0
+Result run(const char *name, uint64_t minIterations, const std::function<size_t()> &fn);
+// Wie oben; nach dem Aufwärmen und alle every Durchläufe läuft reset() außerhalb
+// von Zeit- und Allokationsmessung (z.B. eine Queue leeren, die sonst voll liefe)
+Result run(const char *name, uint64_t minIterations, const std::function<size_t()> &fn,
+           uint64_t every, const std::function<void()> &reset);
+
+String toJson(const std::vector<Result> &results);
+
+} // namespace Bench
+
+#endif
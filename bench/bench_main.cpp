@@ -0,0 +1,381 @@
+//----------------------------------------------------------------------------
+// Microbenchmarks (env:native_bench)
+//   pio run -e native_bench && .pio/build/native_bench/program [bench.json]
+// Läuft gegen die echten Routen von WebServerClass, mit den Stand-ins aus
+// lib/NativeHost statt Netzwerk und Flash.
+//----------------------------------------------------------------------------
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <ConfigManager.h>
+#include <esp_partition.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "Bench.h"
+#include "WebServerClass.h"
+#include "static_pages.h"
+#include "RouteTable.h"
+#include "AssetBundle.h"
+
+static WebServerClass webServer;
+
+// Antwort abholen wie AsyncTCP (Segmente zu 1436 Byte), Rückgabe = Bytes auf der Leitung
+static size_t drain(AsyncWebServerRequest &request) {
+    AsyncWebServerResponse *response = request.hostResponse();
+    if (!response) return 0;
+    return response->headerBytes() + request.hostDrain();
+}
+
+static size_t get(const char *url) {
+    AsyncWebServerRequest request(HTTP_GET, url);
+    AsyncWebServer::hostInstance(80)->hostHandle(request);
+    return drain(request);
+}
+
+// Frames und Bytes auf der Leitung (Payload + Frame-Header) aller Clients
+static void wsWire(AsyncWebSocket *ws, uint64_t &frames, uint64_t &bytes) {
+    frames = bytes = 0;
+    for (AsyncWebSocketClient *client : ws->getClients()) {
+        frames += client->hostFramesSent();
+        bytes += client->hostWireBytes();
+    }
+}
+
+// 8 Clients, JSON oder mit Subprotokoll binär; wire_bytes = mittlere Bytes je
+// Sekunde an alle, wire_bytes_per_frame = mittlere Framegröße
+static Bench::Result wsPublish(const char *name, AsyncWebSocket *ws, bool binary) {
+    for (int i = 0; i < 8; i++) {
+        AsyncWebServerRequest upgrade(HTTP_GET, "/ws");
+        if (binary) upgrade.hostHeader("Sec-WebSocket-Protocol", WsProtocol::kSubprotocol);
+        ws->hostConnect(&upgrade);
+    }
+    // Snapshots an die neuen Clients vorab, gemessen werden nur Deltas
+    NativeHost::advanceMillis(1000);
+    webServer.loop();
+    ws->hostDrainAll();
+
+    uint64_t frames0, bytes0, frames, bytes;
+    wsWire(ws, frames0, bytes0);
+    Bench::Result r = Bench::run(name, 200, [&] {
+        uint64_t before, wire;
+        wsWire(ws, frames, before);
+        NativeHost::advanceMillis(1000);
+        webServer.loop();
+        ws->hostDrainAll();
+        wsWire(ws, frames, wire);
+        return (size_t)(wire - before);
+    });
+    wsWire(ws, frames, bytes);
+    r.wireBytes = (bytes - bytes0) / (r.iterations + 1);     // mit Aufwärmen
+    r.extra.push_back({"wire_bytes_per_frame", frames > frames0 ? (double)(bytes - bytes0) / (frames - frames0) : 0});
+    while (!ws->getClients().empty()) ws->hostDisconnect(ws->getClients().front());
+    return r;
+}
+
+// Früheres sendDynamicPage: ganze Seite als String, Platzhalter per replace()
+static size_t legacyDynamicPage(const char *content, const std::map<String, String> &replacements) {
+    AsyncWebServerRequest request(HTTP_GET, "/status");
+    String output = html_template;
+    output.replace("_BODY_CONTENT_", content);
+    for (auto const &pair : replacements) {
+        output.replace("%" + pair.first + "%", pair.second);
+    }
+    request.send(200, "text/html", output);
+    return drain(request);
+}
+
+// Routentabellen mit N erzeugten Pfaden "/api/r000".."/api/rNNN" für den
+// Vergleich Handler-Kette gegen RouteTable; der Handler antwortet nur
+struct RouteBench {
+    void hit(AsyncWebServerRequest *request) { request->send(204); }
+};
+
+template <size_t N>
+struct RoutePaths {
+    char text[N][12] = {};
+    constexpr RoutePaths() {
+        for (size_t i = 0; i < N; i++) {
+            const char prefix[] = "/api/r";
+            for (size_t k = 0; k < 6; k++) text[i][k] = prefix[k];
+            text[i][6] = (char)('0' + i / 100);
+            text[i][7] = (char)('0' + i / 10 % 10);
+            text[i][8] = (char)('0' + i % 10);
+        }
+    }
+};
+template <size_t N> constexpr RoutePaths<N> kRoutePaths{};
+
+template <size_t N>
+struct RouteSet {
+    RouteTable::Route<RouteBench> items[N] = {};
+    constexpr RouteSet() {
+        for (size_t i = 0; i < N; i++) {
+            items[i] = {kRoutePaths<N>.text[i], HTTP_GET, AdmissionControl::CHEAP, &RouteBench::hit};
+        }
+    }
+};
+template <size_t N> constexpr RouteSet<N> kRouteSet{};
+template <size_t N> constexpr auto kRouteIndex = RouteTable::index(kRouteSet<N>.items);
+
+// Letzte registrierte Route, für die Kette der ungünstigste Fall.
+// setup_allocs = Allokationen beim Einrichten (Handler, std::function, String)
+template <size_t N>
+static void routeLookup(std::vector<Bench::Result> &results) {
+    static RouteBench target;
+    const char *last = kRoutePaths<N>.text[N - 1];
+    auto lookup = [last](AsyncWebServer &server) {
+        AsyncWebServerRequest request(HTTP_GET, last);
+        server.hostHandle(request);
+        return drain(request);
+    };
+
+    uint64_t allocs = Bench::allocStats().allocs;
+    AsyncWebServer chainServer(9000 + N);
+    for (size_t i = 0; i < N; i++) {
+        chainServer.on(kRoutePaths<N>.text[i], HTTP_GET, [](AsyncWebServerRequest *request) {
+            target.hit(request);
+        });
+    }
+    double chainSetup = (double)(Bench::allocStats().allocs - allocs);
+    Bench::Result chain = Bench::run((String("route_chain_") + String((int)N)).c_str(), 10000,
+                                     [&] { return lookup(chainServer); });
+    chain.extra.push_back({"setup_allocs", chainSetup});
+    results.push_back(chain);
+
+    allocs = Bench::allocStats().allocs;
+    AsyncWebServer tableServer(9500 + N);
+    RouteTable::Dispatcher<RouteBench> dispatcher;
+    dispatcher.install(&target, kRouteSet<N>.items, kRouteIndex<N>);
+    tableServer.addHandler(&dispatcher);
+    double tableSetup = (double)(Bench::allocStats().allocs - allocs);
+    Bench::Result table = Bench::run((String("route_table_") + String((int)N)).c_str(), 10000,
+                                     [&] { return lookup(tableServer); });
+    table.extra.push_back({"setup_allocs", tableSetup});
+    results.push_back(table);
+}
+
+// data/ aus SPIFFS gegen das eingeblendete Asset-Bundle: Suche, Auslieferung,
+// erstes Laden einer Seite. Der SPIFFS-Stand-in ist eine std::map im RAM, auf
+// dem Gerät kostet open() deutlich mehr (lineare Suche über die Seiten im Flash).
+static void assetSources(std::vector<Bench::Result> &results) {
+    static AssetBundle bundle;
+    if (!bundle.map()) {
+        fprintf(stderr, ".pio/assets.bin fehlt, asset_* ohne Bundle übersprungen\n");
+        return;
+    }
+    static const char *const kPaths[] = {
+        "/config.html", "/favicon-96x96.png", "/images/logo.png", "/index.html", "/script.js",
+        "/style.css", "/template.html", "/test.html", "/websocket.html", "/missing.css"
+    };
+    results.push_back(Bench::run("asset_lookup_spiffs", 10000, [] {
+        size_t found = 0;
+        for (const char *path : kPaths) found += SPIFFS.exists(path);
+        return found ? 0 : 1;
+    }));
+    results.push_back(Bench::run("asset_lookup_bundle", 10000, [] {
+        size_t found = 0;
+        for (const char *path : kPaths) found += (bool)bundle.find(path);
+        return found ? 0 : 1;
+    }));
+
+    static StaticAssetHandler fromSpiffs(SPIFFS);
+    static StaticAssetHandler fromBundle(SPIFFS);
+    fromSpiffs.serve("/");
+    fromBundle.serve("/").bundle(&bundle);
+    auto serve = [](StaticAssetHandler &handler, const char *url, bool gzip) {
+        AsyncWebServerRequest request(HTTP_GET, url);
+        if (gzip) request.hostHeader("Accept-Encoding", "gzip");
+        handler.handleRequest(&request);
+        return drain(request);
+    };
+    results.push_back(Bench::run("asset_css_gzip_spiffs", 10000, [&] { return serve(fromSpiffs, "/style.css", true); }));
+    results.push_back(Bench::run("asset_css_gzip_bundle", 10000, [&] { return serve(fromBundle, "/style.css", true); }));
+    results.push_back(Bench::run("asset_png_spiffs", 10000, [&] { return serve(fromSpiffs, "/favicon-96x96.png", false); }));
+    results.push_back(Bench::run("asset_png_bundle", 10000, [&] { return serve(fromBundle, "/favicon-96x96.png", false); }));
+
+    // erstes Laden nach Neustart/clear(): SPIFFS liest in einen Puffer, das Bundle nicht
+    TemplateEngine engine;
+    engine.begin(html_template);
+    results.push_back(Bench::run("page_load_spiffs", 10000, [&] {
+        engine.clear();
+        return engine.file(SPIFFS, "/config.html") ? 0 : 1;
+    }));
+    results.push_back(Bench::run("page_load_bundle", 10000, [&] {
+        engine.clear();
+        return engine.file(bundle, "/config.html") ? 0 : 1;
+    }));
+}
+
+int main(int argc, char **argv) {
+    Serial.setOutput(nullptr);
+    SPIFFS.hostLoadDir(".pio/data");
+    // wie ein Gerät mit hochgeladenem Bundle (pio run -t uploadassets)
+    NativeHost::loadPartitionFile("assets", ".pio/assets.bin");
+    webServer.begin();
+
+    std::vector<Bench::Result> results;
+    const std::map<String, String> statusValues = {
+        {"EEPROM_TEXT", ConfigManager::text()}, {"COUNTER_VALUE", "42"},
+        {"SET_COUNTER", "0"}, {"CUR_COUNTER", "42"}
+    };
+
+    // Seite mit Platzhaltern: früheres sendDynamicPage (String::replace) gegen TemplateEngine gegen StaticPage
+    results.push_back(Bench::run("page_legacy_replace", 1000, [&] {
+        return legacyDynamicPage(status_content, statusValues);
+    }));
+    TemplateEngine engine;
+    engine.begin(html_template);
+    results.push_back(Bench::run("page_template_engine", 1000, [&] {
+        AsyncWebServerRequest request(HTTP_GET, "/status");
+        request.send(engine.beginResponse(&request, engine.page(status_content), statusValues));
+        return drain(request);
+    }));
+    results.push_back(Bench::run("page_static", 1000, [&] {
+        AsyncWebServerRequest request(HTTP_GET, "/status");
+        StatusPage::Values values;
+        values.set(StatusSlot::EEPROM_TEXT, ConfigManager::text());
+        values.set(StatusSlot::COUNTER_VALUE, "42");
+        values.set(StatusSlot::SET_COUNTER, "0");
+        values.set(StatusSlot::CUR_COUNTER, "42");
+        request.send(StatusPage::beginResponse(&request, std::move(values)));
+        return drain(request);
+    }));
+
+    // Echte Routen über die Handler-Kette des Servers
+    results.push_back(Bench::run("route_status", 1000, [] { return get("/status"); }));
+    results.push_back(Bench::run("route_status_json", 1000, [] { return get("/status.json"); }));
+    results.push_back(Bench::run("route_index", 1000, [] { return get("/index"); }));
+    results.push_back(Bench::run("asset_style_css", 1000, [] {
+        AsyncWebServerRequest request(HTTP_GET, "/style.css");
+        request.hostHeader("Accept-Encoding", "gzip");
+        AsyncWebServer::hostInstance(80)->hostHandle(request);
+        return drain(request);
+    }));
+
+    // WebSocket-Eventhandler: Befehl als JSON und als Binärframe, gemessen wird
+    // nur der AsyncTCP-Teil (Zerlegen bis CommandQueue::push). Die Queue leert
+    // loop() alle kCapacity Befehle außerhalb der Messung
+    AsyncWebSocket *ws = AsyncWebSocket::hostInstance("/ws");
+    AsyncWebSocketClient *client = ws->hostConnect();
+    auto applyCommands = [&] {
+        webServer.loop();
+        ws->hostDrainAll();
+    };
+    static const char kJsonCommand[] = "{\"led\":true,\"blink\":false}";
+    results.push_back(Bench::run("ws_command_json", 10000, [&] {
+        ws->hostReceive(client, WS_TEXT, (const uint8_t*)kJsonCommand, sizeof(kJsonCommand) - 1);
+        return sizeof(kJsonCommand) - 1;
+    }, CommandQueue::kCapacity, applyCommands));
+    WsProtocol::Command cmd;
+    cmd.hasLed = cmd.led = true;
+    cmd.hasBlink = true;
+    uint8_t binaryCommand[2];
+    size_t binaryLen = WsProtocol::encodeCommand(cmd, binaryCommand, sizeof(binaryCommand));
+    results.push_back(Bench::run("ws_command_binary", 10000, [&] {
+        ws->hostReceive(client, WS_BINARY, binaryCommand, binaryLen);
+        return binaryLen;
+    }, CommandQueue::kCapacity, applyCommands));
+    ws->hostDisconnect(client);
+
+    // Zustands-Push an 8 Clients je Protokoll, ein Durchlauf = eine Sekunde Gerätezeit
+    results.push_back(wsPublish("ws_publish_8_clients", ws, false));
+    results.push_back(wsPublish("ws_publish_8_clients_binary", ws, true));
+
+    // 8 Dashboards je eine Sekunde Gerätezeit: früher /counter und /status.json
+    // pro Sekunde (updateCounter(), fetchStatus()), jetzt ein Event über /events
+    const int kDashboards = 8;
+    Bench::Result poll = Bench::run("dashboard_poll_8", 200, [&] {
+        NativeHost::advanceMillis(1000);
+        webServer.loop();
+        size_t bytes = 0;
+        for (int i = 0; i < kDashboards; i++) bytes += get("/counter") + get("/status.json");
+        return bytes;
+    });
+    poll.extra.push_back({"requests_per_dashboard_sec", 2});
+    poll.extra.push_back({"cpu_us_per_dashboard_sec", poll.nsPerOp / kDashboards / 1000});
+    results.push_back(poll);
+
+    AsyncEventSource *sse = AsyncEventSource::hostInstance("/events");
+    std::vector<AsyncEventSourceClient*> dashboards;
+    for (int i = 0; i < kDashboards; i++) dashboards.push_back(sse->hostConnect());
+    Bench::Result stream = Bench::run("dashboard_sse_8", 200, [&] {
+        NativeHost::advanceMillis(1000);
+        webServer.loop();
+        return sse->hostDrainAll();
+    });
+    stream.extra.push_back({"requests_per_dashboard_sec", 0});
+    stream.extra.push_back({"cpu_us_per_dashboard_sec", stream.nsPerOp / kDashboards / 1000});
+    results.push_back(stream);
+    for (AsyncEventSourceClient *client : dashboards) sse->hostDisconnect(client);
+
+    // ConfigManager: Lesen aus dem RAM-Abbild, Schreiben mit gesammelten Commits
+    results.push_back(Bench::run("config_read", 100000, [] {
+        return strlen(ConfigManager::text()) + ConfigManager::wifi(false).ssid[0];
+    }));
+    uint32_t commitsBefore = ConfigManager::cacheStats().commits;
+    uint32_t writes = 0;
+    unsigned long startMs = millis();
+    Bench::Result write = Bench::run("config_write", 1000, [&] {
+        // ein Schreibzugriff alle 100 ms Gerätezeit
+        NativeHost::advanceMillis(100);
+        ConfigManager::writeString(String("Text ") + String(writes++ % 7));
+        ConfigManager::loop();
+        return (size_t)0;
+    });
+    double minutes = (millis() - startMs) / 60000.0;
+    write.extra.push_back({"commits_per_minute", (ConfigManager::cacheStats().commits - commitsBefore) / minutes});
+    results.push_back(write);
+
+    // POST /save_eeprom, während ein zweiter Thread wie loop() Konfiguration
+    // committet, Flash so langsam wie auf dem ESP32. callback_*_us ist die Zeit
+    // im Handler, also wie lange AsyncTCP für alle Verbindungen steht
+    NativeHost::setFlashLatency(300, 40000);
+    std::atomic<bool> stopCommits{false};
+    std::thread committer([&] {
+        for (uint8_t b = 0; !stopCommits; b++) {
+            ConfigManager::writeByte(b);
+            ConfigManager::flush();
+        }
+    });
+    std::vector<uint32_t> callbackUs;
+    uint32_t saves = 0;
+    Bench::Result save = Bench::run("save_eeprom_during_commit", 200, [&] {
+        AsyncWebServerRequest request(HTTP_POST, "/save_eeprom");
+        request.hostParam("data", String("Text ") + String(saves++ % 7), true);
+        unsigned long start = micros();
+        AsyncWebServer::hostInstance(80)->hostHandle(request);
+        callbackUs.push_back(micros() - start);
+        size_t bytes = drain(request);
+        webServer.loop();
+        return bytes;
+    });
+    stopCommits = true;
+    committer.join();
+    NativeHost::setFlashLatency(0, 0);
+    std::sort(callbackUs.begin(), callbackUs.end());
+    save.extra.push_back({"callback_p50_us", (double)callbackUs[callbackUs.size() / 2]});
+    save.extra.push_back({"callback_p99_us", (double)callbackUs[callbackUs.size() * 99 / 100]});
+    save.extra.push_back({"callback_max_us", (double)callbackUs.back()});
+    results.push_back(save);
+
+    // Routensuche: Handler-Kette (server.on) gegen RouteTable
+    routeLookup<16>(results);
+    routeLookup<50>(results);
+    routeLookup<100>(results);
+    routeLookup<200>(results);
+
+    assetSources(results);
+
+    String json = Bench::toJson(results);
+    if (argc > 1) {
+        FILE *out = fopen(argv[1], "w");
+        if (!out) {
+            fprintf(stderr, "Kann %s nicht schreiben\n", argv[1]);
+            return 1;
+        }
+        fputs(json.c_str(), out);
+        fclose(out);
+    }
+    fputs(json.c_str(), stdout);
+    return 0;
+}
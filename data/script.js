@@ -1,16 +1,70 @@
 // WebSocket Client (für websocket.html)
 (function(){
   try {
-    const socket = new WebSocket((location.protocol === 'https:' ? 'wss://' : 'ws://') + location.host + '/ws');
+    // Binärprotokoll anfragen (WsProtocol.h); bestätigt der Server es nicht, bleibt es bei JSON
+    const BIN_PROTOCOL = 'esp.bin.v1';
+    const socket = new WebSocket((location.protocol === 'https:' ? 'wss://' : 'ws://') + location.host + '/ws', BIN_PROTOCOL);
+    socket.binaryType = 'arraybuffer';
+
+    // Felder wie StateChannel::Field: Name und Typ (b = bool, i = int32, t = Text)
+    const FIELDS = [['led', 'b'], ['blink', 'b'], ['uptime', 'i'], ['counter', 'i'], ['wifi_mode', 't'], ['ip', 't']];
+
+    // [op][version u32][mask u8][Felder...] -> Objekt wie bei JSON
+    function decodeState(buf) {
+      const view = new DataView(buf);
+      const op = view.getUint8(0);
+      if (op === 0x12) return { ack: view.getUint32(1, true) };
+      const data = { v: view.getUint32(1, true) };
+      if (op === 0x11) data.full = true;
+      else if (op !== 0x10) return null;
+      const mask = view.getUint8(5);
+      let pos = 6;
+      FIELDS.forEach(([name, type], i) => {
+        if (!(mask & (1 << i))) return;
+        if (type === 'b') { data[name] = view.getUint8(pos) !== 0; pos += 1; }
+        else if (type === 'i') { data[name] = view.getInt32(pos, true); pos += 4; }
+        else {
+          const len = view.getUint8(pos);
+          data[name] = new TextDecoder().decode(new Uint8Array(buf, pos + 1, len));
+          pos += 1 + len;
+        }
+      });
+      return data;
+    }
+
+    function sendCommand(led, blink) {
+      if (socket.protocol === BIN_PROTOCOL) {
+        // [0x01][flags]: bit0/1 led, bit2/3 blink
+        socket.send(new Uint8Array([0x01, 0x01 | (led ? 0x02 : 0) | 0x04 | (blink ? 0x08 : 0)]));
+      } else {
+        socket.send(JSON.stringify({ led: led, blink: blink }));
+      }
+    }
+
+    // Server sendet nur geänderte Felder (Delta), neue Verbindungen einmal alles ("full")
+    const deviceState = {};
+    let uptimeBase = null;   // letzter gemeldeter uptime-Wert und lokale Zeit dazu
+    let uptimeAt = 0;
+
+    function showUptime() {
+      const el = document.getElementById("uptime");
+      if (el && uptimeBase !== null) el.innerText = uptimeBase + Math.floor((Date.now() - uptimeAt) / 1000);
+    }
+    setInterval(showUptime, 1000);
 
     socket.onopen = () => console.log("WebSocket verbunden");
 
     socket.onmessage = (event) => {
       try {
-        const data = JSON.parse(event.data);
+        const data = (event.data instanceof ArrayBuffer) ? decodeState(event.data) : JSON.parse(event.data);
+        if (!data) return;
+        // Quittung: Befehl ist angewendet, der neue Zustand folgt als Delta
+        if (typeof data.ack !== 'undefined') return;
+        Object.assign(deviceState, data);
         if (typeof data.uptime !== 'undefined') {
-          const el = document.getElementById("uptime");
-          if (el) el.innerText = data.uptime;
+          uptimeBase = data.uptime;
+          uptimeAt = Date.now();
+          showUptime();
         }
         if (typeof data.led !== 'undefined') {
           const el = document.getElementById("led");
@@ -22,12 +76,10 @@
     };
 
     window.sendLED = function(state) {
-      const msg = { led: !!state, blink: false };
-      socket.send(JSON.stringify(msg));
+      sendCommand(!!state, false);
     };
     window.sendBlink = function() {
-      const msg = { led: false, blink: true };
-      socket.send(JSON.stringify(msg));
+      sendCommand(false, true);
     };
   } catch(e) {
     console.error("WebSocket init Fehler:", e);
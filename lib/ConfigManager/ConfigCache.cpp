@@ -0,0 +1,32 @@
+#include "ConfigCache.h"
+
+const ConfigField* ConfigCache::field(ConfigKey key) {
+  for (const ConfigField &f : kConfigFields) {
+    if (f.key == key) return &f;
+  }
+  return nullptr;
+}
+
+void ConfigCache::markDirty(uint32_t mask, uint32_t now) {
+  if (_dirty == 0) _firstDirtyMs = now;
+  _dirty |= mask;
+  _lastWriteMs = now;
+}
+
+bool ConfigCache::due(uint32_t now) const {
+  if (_dirty == 0) return false;
+  return now - _lastWriteMs >= kQuietMs || now - _firstDirtyMs >= kMaxDelayMs;
+}
+
+bool ConfigCache::flush(LogStore &store, uint32_t now) {
+  if (_dirty == 0) return true;
+  if (!ConfigSchema::save(store, _data, _dirty)) {
+    _stats.failed++;
+    _firstDirtyMs = _lastWriteMs = now;
+    return false;
+  }
+  _dirty = 0;
+  _stats.commits++;
+  _stats.lastCommitMs = now;
+  return true;
+}
@@ -0,0 +1,70 @@
+#ifndef CONFIGCACHE_H
+#define CONFIGCACHE_H
+
+#include <string.h>
+#include "ConfigSchema.h"
+
+//----------------------------------------------------------------------------
+// ConfigCache
+// Typisiertes Abbild von ConfigData im RAM. Lesen liefert Referenzen ohne
+// Flash-Zugriff. Schreiben ändert nur das Abbild und markiert das Feld als
+// geändert; flush() schreibt alle markierten Felder plus Header in einem
+// Durchgang, sobald kQuietMs lang nichts mehr geändert wurde (spätestens nach
+// kMaxDelayMs). Mehrere Formular-Posts hintereinander = ein Commit.
+//
+// Nicht thread-sicher, ConfigManager hält den Mutex.
+//----------------------------------------------------------------------------
+class ConfigCache {
+public:
+  static constexpr uint32_t kQuietMs = 1000;
+  static constexpr uint32_t kMaxDelayMs = 10000;
+
+  struct Stats {
+    uint32_t writes = 0;       // modify() mit geändertem Wert
+    uint32_t unchanged = 0;    // modify() ohne Änderung
+    uint32_t commits = 0;      // erfolgreiche flush()
+    uint32_t failed = 0;
+    uint32_t lastCommitMs = 0;
+  };
+
+  const ConfigData& data() const { return _data; }
+  // Nur für begin(): Laden/Migrieren ohne Dirty-Markierung
+  ConfigData& raw() { return _data; }
+
+  // fn ändert das Feld key in ConfigData; markiert nur, wenn sich Bytes ändern
+  template <typename Fn>
+  bool modify(ConfigKey key, uint32_t now, Fn fn) {
+    const ConfigField *f = field(key);
+    if (!f) return false;
+    uint8_t before[LogStore::kMaxValue];
+    uint8_t *p = (uint8_t*)&_data + f->offset;
+    memcpy(before, p, f->size);
+    fn(_data);
+    if (memcmp(before, p, f->size) == 0) {
+      _stats.unchanged++;
+      return false;
+    }
+    markDirty(ConfigSchema::fieldMask(key), now);
+    _stats.writes++;
+    return true;
+  }
+
+  bool pending() const { return _dirty != 0; }
+  uint32_t dirty() const { return _dirty; }
+  bool due(uint32_t now) const;
+  // Schreibt die markierten Felder; bei Fehler bleiben sie markiert (neuer Versuch nach kQuietMs)
+  bool flush(LogStore &store, uint32_t now);
+  const Stats& stats() const { return _stats; }
+
+private:
+  static const ConfigField* field(ConfigKey key);
+  void markDirty(uint32_t mask, uint32_t now);
+
+  ConfigData _data = {};
+  uint32_t _dirty = 0;
+  uint32_t _firstDirtyMs = 0;
+  uint32_t _lastWriteMs = 0;
+  Stats _stats;
+};
+
+#endif
@@ -1,9 +1,206 @@
 #include "ConfigManager.h"
+#include "EspPartitionFlash.h"
+#include <mutex>
+
+// Ohne "config"-Partition (z.B. per OTA aktualisiertes Gerät mit alter
+// Partitionstabelle) liegt das Log in der EEPROM-Emulation. Die alte Ablage
+// (EE_ADD_*) liegt in Sektor 0; das Log beginnt in Sektor 1, damit sie bis
+// zum Header der Migration erhalten bleibt (siehe migrateFromEEPROM()).
+class EepromFlash : public FlashDevice {
+public:
+  static constexpr size_t kSectorSize = 1024;
+  static constexpr size_t kSectors = 4;
+  static constexpr size_t kFirstLogSector = 1;
+
+  size_t sectorSize() const override { return kSectorSize; }
+  size_t sectorCount() const override { return kSectors; }
+  bool read(uint32_t addr, void *out, size_t len) override {
+    memcpy(out, EEPROM.getDataPtr() + addr, len);
+    return true;
+  }
+  bool write(uint32_t addr, const void *data, size_t len) override {
+    uint8_t *p = EEPROM.getDataPtr() + addr;
+    for (size_t i = 0; i < len; i++) p[i] &= ((const uint8_t*)data)[i];
+    return EEPROM.commit();
+  }
+  bool erase(size_t sector) override {
+    memset(EEPROM.getDataPtr() + sector * kSectorSize, 0xFF, kSectorSize);
+    return EEPROM.commit();
+  }
+};
+
+static_assert(EEPROM_SIZE <= EepromFlash::kFirstLogSector * EepromFlash::kSectorSize,
+              "alte EEPROM-Ablage überlappt den ersten Log-Sektor");
+
+static EspPartitionFlash partitionFlash;
+static EepromFlash eepromFlash;
+static LogStore *store = nullptr;
+// Schreiben aus dem AsyncTCP-Task, Commit und Kompaktierung aus loop()
+static std::mutex storeMutex;
+// Geladene Konfiguration, nach begin() geprüft; Änderungen bis zum Commit nur hier
+static ConfigCache cache;
+
+static void toRecord(const WifiConf &conf, WifiRecord &rec) {
+  memcpy(rec.ssid, conf.ssid, sizeof(rec.ssid));
+  memcpy(rec.password, conf.password, sizeof(rec.password));
+  ConfigManager::ip_byte_to_array(conf.ip, rec.ip);
+  ConfigManager::ip_byte_to_array(conf.gw, rec.gw);
+  ConfigManager::ip_byte_to_array(conf.sn, rec.sn);
+}
+
+// Check*-Regeln auf einen Datensatz anwenden. Läuft nur beim Schreiben, nach
+// einer Migration oder wenn die CRC nicht stimmt – nicht bei jedem Lesen.
+static void sanitizeWifi(WifiRecord &rec, bool ap) {
+  IPAddress ip = ConfigManager::ip_from_bytes(rec.ip);
+  IPAddress gw = ConfigManager::ip_from_bytes(rec.gw);
+  IPAddress sn = ConfigManager::ip_from_bytes(rec.sn);
+  if (ap) {
+    ip = ConfigManager::CheckIP(ip, IPAddress(192, 168, 10, 1));
+    gw = ConfigManager::CheckIP(gw, IPAddress(192, 168, 10, 1)); // nur für AP
+  } else {
+    ip = ConfigManager::CheckIP(ip);
+  }
+  sn = ConfigManager::CheckSN(sn);
+  ConfigManager::ip_byte_to_array(ip, rec.ip);
+  ConfigManager::ip_byte_to_array(gw, rec.gw);
+  ConfigManager::ip_byte_to_array(sn, rec.sn);
+  rec.ssid[MAX_SSID-1] = '\0';
+  rec.password[MAX_PASSWORD-1] = '\0';
+}
+
+static void sanitize(ConfigData &data) {
+  sanitizeWifi(data.sta, false);
+  sanitizeWifi(data.ap, true);
+  data.text[MAX_TEXT-1] = '\0';
+  data.testObject.name[sizeof(data.testObject.name)-1] = '\0';
+}
+
+// --- Migrationen (ConfigSchema.h) ---
+
+// 1 -> 2: Werte aus der alten EEPROM-Ablage übernehmen. Fällt der Strom vor
+// dem Header aus, läuft sie beim nächsten Start erneut; mit EepromFlash liegen
+// die ersten Records dafür in Sektor 1, Sektor 0 wird erst danach gelöscht.
+static bool migrateFromEEPROM(ConfigData &data) {
+  WifiConf sta, ap;
+  EEPROM.get(EE_ADD_WIFI, sta);
+  EEPROM.get(EE_ADD_WIFI_AP, ap);
+  toRecord(sta, data.sta);
+  toRecord(ap, data.ap);
+  data.byteValue = EEPROM.read(EE_ADD_BYTE);
+  EEPROM.get(EE_ADD_FLOAT, data.floatValue);
+  EEPROM.get(EE_ADD_TEXT, data.text);
+  EEPROM.get(EE_ADD_MY_TEST_OBJECT, data.testObject);
+  return true;
+}
+
+// 2 -> 3: gleiche Felder, nur der Header (Version, CRC) kommt dazu
+static bool addHeader(ConfigData &) {
+  return true;
+}
+
+static const ConfigSchema::Migration kMigrations[] = {
+  { 1, migrateFromEEPROM, "EEPROM-Ablage -> Log" },
+  { 2, addHeader,         "Header mit Version und CRC" },
+};
 
 void ConfigManager::begin() {
-  EEPROM.begin(EEPROM_SIZE);
-  DBG_PRINT("EEPROM length: ");
-  DBG_PRINTLN(EEPROM.length());
+  if (partitionFlash.begin("config")) {
+    EEPROM.begin(EEPROM_SIZE);   // nur für die Migration alter Daten
+    static LogStore partitionStore(partitionFlash);
+    store = &partitionStore;
+  } else {
+    DBG_PRINTLN("WARNUNG: Partition 'config' fehlt, Log liegt im EEPROM-Bereich.");
+    EEPROM.begin(EepromFlash::kSectorSize * EepromFlash::kSectors);
+    static LogStore eepromStore(eepromFlash, EepromFlash::kFirstLogSector);
+    store = &eepromStore;
+  }
+
+  std::lock_guard<std::mutex> lock(storeMutex);
+  ConfigData &config = cache.raw();
+  memset(&config, 0, sizeof(config));
+  if (!store->mount()) {
+    Serial.println("Fehler: Konfigurationsspeicher nicht nutzbar");
+    return;
+  }
+
+  bool valid = false;
+  uint16_t version = ConfigSchema::load(*store, config, valid);
+  if (valid) {
+    DBG_PRINTF("Konfiguration v%u geladen\n", (unsigned)version);
+    return;
+  }
+  if (version < kConfigVersion) {
+    Serial.printf("Konfiguration v%u -> v%u wird migriert\n", (unsigned)version, (unsigned)kConfigVersion);
+    if (!ConfigSchema::migrate(config, version, kMigrations, sizeof(kMigrations) / sizeof(kMigrations[0]))) {
+      Serial.println("Fehler: Migration fehlgeschlagen, Standardwerte");
+      memset(&config, 0, sizeof(config));
+    }
+  } else {
+    Serial.println("WARNUNG: Header/CRC der Konfiguration passt nicht, Felder werden geprüft");
+  }
+  sanitize(config);
+  if (!ConfigSchema::save(*store, config, ConfigSchema::kAllFields)) {
+    Serial.println("Fehler: Konfiguration nicht gespeichert");
+  }
+}
+
+void ConfigManager::loop() {
+  if (!store) return;
+  std::lock_guard<std::mutex> lock(storeMutex);
+  uint32_t now = millis();
+  if (cache.due(now)) {
+    DBG_PRINTF("Konfiguration speichern, Felder 0x%02x\n", (unsigned)cache.dirty());
+    if (!cache.flush(*store, now)) Serial.println("Fehler: Konfiguration nicht gespeichert");
+    return;   // Kompaktierung erst beim nächsten Durchlauf
+  }
+  store->maintain();
+}
+
+bool ConfigManager::flush() {
+  if (!store) return false;
+  std::lock_guard<std::mutex> lock(storeMutex);
+  return cache.flush(*store, millis());
+}
+
+bool ConfigManager::pending() {
+  std::lock_guard<std::mutex> lock(storeMutex);
+  return cache.pending();
+}
+
+const LogStore::Stats& ConfigManager::stats() {
+  static const LogStore::Stats empty;
+  return store ? store->stats() : empty;
+}
+
+const ConfigCache::Stats& ConfigManager::cacheStats() {
+  return cache.stats();
+}
+
+const WifiRecord& ConfigManager::wifi(bool ap) {
+  return ap ? cache.data().ap : cache.data().sta;
+}
+
+byte ConfigManager::byteValue() {
+  return cache.data().byteValue;
+}
+
+float ConfigManager::floatValue() {
+  return cache.data().floatValue;
+}
+
+const char* ConfigManager::text() {
+  return cache.data().text;
+}
+
+const MyTestObject& ConfigManager::myTestObject() {
+  return cache.data().testObject;
+}
+
+// Feld im Cache ändern, gespeichert wird gesammelt in loop()
+template <typename Fn>
+static void update(ConfigKey key, Fn apply) {
+  std::lock_guard<std::mutex> lock(storeMutex);
+  cache.modify(key, millis(), apply);
 }
 
 void ConfigManager::ip_byte_to_array(const IPAddress &ip, byte ip_bytes[4]) {
@@ -44,17 +241,12 @@ IPAddress ConfigManager::CheckSN(const IPAddress &sn) {
 
 
 void ConfigManager::readWifiConf(WifiConf &wifiConf, bool ap) {
-  if (ap) {
-    EEPROM.get(EE_ADD_WIFI_AP, wifiConf);
-    wifiConf.ip = CheckIP(wifiConf.ip, IPAddress(192, 168, 10, 1));
-    wifiConf.gw = CheckIP(wifiConf.gw, IPAddress(192, 168, 10, 1)); // nur für AP
-  } else {
-    EEPROM.get(EE_ADD_WIFI, wifiConf);
-    wifiConf.ip = CheckIP(wifiConf.ip);
-  }   
-  wifiConf.ssid[MAX_SSID-1] = '\0';
-  wifiConf.password[MAX_PASSWORD-1] = '\0';
-  wifiConf.sn = CheckSN(wifiConf.sn);
+  const WifiRecord &rec = wifi(ap);
+  memcpy(wifiConf.ssid, rec.ssid, sizeof(wifiConf.ssid));
+  memcpy(wifiConf.password, rec.password, sizeof(wifiConf.password));
+  wifiConf.ip = ip_from_bytes(rec.ip);
+  wifiConf.gw = ip_from_bytes(rec.gw);
+  wifiConf.sn = ip_from_bytes(rec.sn);
   DBG_PRINTF("'%s' gelesene WLAN-Daten: SSID='%s', PASS='%s', IP='%s', GW='%s', SN='%s'\n", ap ? "Access Point (AP)" : "Client (STA)",
             wifiConf.ssid, wifiConf.password, wifiConf.ip.toString().c_str(), wifiConf.gw.toString().c_str(), wifiConf.sn.toString().c_str());
 }
@@ -62,51 +254,49 @@ void ConfigManager::readWifiConf(WifiConf &wifiConf, bool ap) {
 void ConfigManager::writeWifiConf(const WifiConf &wifiConf, bool ap) {
   DBG_PRINTF("'%s' gespeicherte WLAN-Daten: SSID='%s', PASS='%s', IP='%s', GW='%s', SN='%s'\n", ap ? "Access Point (AP)" : "Client (STA)",
             wifiConf.ssid, wifiConf.password, wifiConf.ip.toString().c_str(), wifiConf.gw.toString().c_str(), wifiConf.sn.toString().c_str());
-            
-  EEPROM.put(ap ? EE_ADD_WIFI_AP : EE_ADD_WIFI, wifiConf);
-  EEPROM.commit();
+
+  update(ap ? KEY_WIFI_AP : KEY_WIFI_STA, [&](ConfigData &c) {
+    WifiRecord &rec = ap ? c.ap : c.sta;
+    toRecord(wifiConf, rec);
+    sanitizeWifi(rec, ap);
+  });
 }
 
 void ConfigManager::readByte(byte &b) {
-  b = EEPROM.read(EE_ADD_BYTE);
+  b = byteValue();
   DBG_PRINT("Byte: "); DBG_PRINTLN(b);
 }
 
 void ConfigManager::writeByte(const byte &b) {
   DBG_PRINT("Byte: "); DBG_PRINTLN(b);
-  EEPROM.write(EE_ADD_BYTE, b);
-  EEPROM.commit();
+  update(KEY_BYTE, [&](ConfigData &c) { c.byteValue = b; });
 }
 
 void ConfigManager::readFloat(float &f) {
-  EEPROM.get(EE_ADD_FLOAT, f);
+  f = floatValue();
   DBG_PRINT("Float: "); DBG_PRINTLN(f, 3);
 }
 
 void ConfigManager::writeFloat(const float &f) {
   DBG_PRINT("Float: "); DBG_PRINTLN(f, 3);
-  EEPROM.put(EE_ADD_FLOAT, f);
-  EEPROM.commit();
+  update(KEY_FLOAT, [&](ConfigData &c) { c.floatValue = f; });
 }
 
 void ConfigManager::readString(String &text) {
-  char textBuffer[MAX_TEXT];
-  EEPROM.get(EE_ADD_TEXT, textBuffer);
-  textBuffer[MAX_TEXT-1] = '\0';
-  text = String(textBuffer);
+  text = ConfigManager::text();
   DBG_PRINT("String: "); DBG_PRINTLN(text);
 }
 
 void ConfigManager::writeString(const String &text) {
   DBG_PRINT("String: "); DBG_PRINTLN(text);
-  char textBuffer[MAX_TEXT] = {0};
-  strncpy(textBuffer, text.c_str(), MAX_TEXT-1);
-  EEPROM.put(EE_ADD_TEXT, textBuffer);
-  EEPROM.commit();
+  update(KEY_TEXT, [&](ConfigData &c) {
+    memset(c.text, 0, sizeof(c.text));
+    strncpy(c.text, text.c_str(), MAX_TEXT-1);
+  });
 }
 
 void ConfigManager::readMyTestObject(MyTestObject &obj) {
-  EEPROM.get(EE_ADD_MY_TEST_OBJECT, obj);
+  obj = myTestObject();
   DBG_PRINT("byte_field: "); DBG_PRINTLN(obj.byte_field);
   DBG_PRINT("long_field: "); DBG_PRINTLN(obj.long_field);
   DBG_PRINT("float_field: "); DBG_PRINTLN(obj.float_field);
@@ -119,6 +309,5 @@ void ConfigManager::writeMyTestObject(const MyTestObject &obj) {
   DBG_PRINT("float_field: "); DBG_PRINTLN(obj.float_field);
   DBG_PRINT("name: "); DBG_PRINTLN(obj.name);
 
-  EEPROM.put(EE_ADD_MY_TEST_OBJECT, obj);
-  EEPROM.commit();
+  update(KEY_MY_TEST_OBJECT, [&](ConfigData &c) { c.testObject = obj; });
 }
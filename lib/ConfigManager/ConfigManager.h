@@ -3,6 +3,9 @@
 
 #include <Arduino.h>
 #include <EEPROM.h>
+#include "LogStore.h"
+#include "ConfigSchema.h"
+#include "ConfigCache.h"
 
 // --- Debug-Steuerung ---
 // Über platformio.ini:
@@ -17,13 +20,7 @@
   #define DBG_PRINTF(...) 
 #endif
 
-// --- Konfiguration ---
-constexpr size_t EEPROM_SIZE = 512;
-constexpr size_t MAX_SSID = 21;
-constexpr size_t MAX_PASSWORD = 21;
-constexpr size_t MAX_IP = 17;
-constexpr size_t MAX_SN = 17;
-constexpr size_t MAX_TEXT = 51;
+// Konstanten, Speicherformat und Keys: ConfigSchema.h
 
 struct WifiConfChecked {
   String ssid;
@@ -33,7 +30,6 @@ struct WifiConfChecked {
   IPAddress gw; // nur für AP
 };
 
-// --- EEPROM-Adressen ---
 struct WifiConf {
   char ssid[MAX_SSID];
   char password[MAX_PASSWORD];
@@ -42,13 +38,10 @@ struct WifiConf {
   IPAddress sn; // Subnet Mask als 4 Bytes
 };
 
-struct MyTestObject {
-  byte  byte_field;
-  long  long_field;
-  float float_field;
-  char  name[12];
-};
-
+// --- EEPROM-Adressen: Schema-Version 1, nur noch für die Migration ---
+// Historisch fehlerhaft: EE_ADD_TEXT liegt MAX_TEXT hinter EE_ADD_FLOAT,
+// MyTestObject nur sizeof(float) hinter EE_ADD_TEXT und damit im Text.
+// Nicht korrigieren – so liegen die Daten auf alten Geräten.
 constexpr int EE_ADD_WIFI           = 0;
 constexpr int EE_ADD_WIFI_AP        = EE_ADD_WIFI + sizeof(WifiConf);
 constexpr int EE_ADD_BYTE           = EE_ADD_WIFI_AP + sizeof(WifiConf);
@@ -60,6 +53,9 @@ class ConfigManager {
 public:
   ConfigManager() = delete; // keine Instanz nötig
   static void begin();
+  static void loop();    // gesammelte Änderungen speichern, Kompaktierung
+  static bool flush();   // sofort speichern, z.B. vor ESP.restart()
+  static bool pending(); // ungespeicherte Änderungen vorhanden
   static void ip_byte_to_array(const IPAddress &ip, byte bytes[4]);
   static IPAddress ip_from_bytes(const byte bytes[4]);
   static IPAddress CheckIP(const IPAddress &ip, const IPAddress defaultIP = IPAddress(0,0,0,0));
@@ -75,6 +71,18 @@ public:
   static void writeString(const String &text);
   static void readMyTestObject(MyTestObject &obj);
   static void writeMyTestObject(const MyTestObject &obj);
+
+  // Direkt aus dem RAM-Abbild, ohne Kopie und ohne Sperre. Gültig bis zum
+  // nächsten write* auf dasselbe Feld, daher nur in dem Task lesen, der
+  // schreibt (WebServerClass: loop(); Handler halten eigene Kopien).
+  static const WifiRecord& wifi(bool ap=false);
+  static byte byteValue();
+  static float floatValue();
+  static const char* text();
+  static const MyTestObject& myTestObject();
+
+  static const LogStore::Stats& stats();
+  static const ConfigCache::Stats& cacheStats();
 };
 
 #endif
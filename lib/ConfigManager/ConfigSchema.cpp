@@ -0,0 +1,69 @@
+#include "ConfigSchema.h"
+#include <string.h>
+
+namespace ConfigSchema {
+
+// CRC Feld für Feld, Füllbytes in ConfigData zählen nicht
+uint32_t crc(const ConfigData &data) {
+  const uint8_t *base = (const uint8_t*)&data;
+  uint32_t crc = 0;
+  for (const ConfigField &f : kConfigFields) crc = LogStore::crc32(crc, base + f.offset, f.size);
+  return crc;
+}
+
+uint32_t fieldMask(ConfigKey key) {
+  for (size_t i = 0; i < kConfigFieldCount; i++) {
+    if (kConfigFields[i].key == key) return 1u << i;
+  }
+  return 0;
+}
+
+uint16_t load(LogStore &store, ConfigData &data, bool &valid) {
+  memset(&data, 0, sizeof(data));
+  valid = false;
+  uint8_t *base = (uint8_t*)&data;
+  for (const ConfigField &f : kConfigFields) store.get(f.key, base + f.offset, f.size);
+
+  // ohne Header: Log leer oder Übernahme aus dem EEPROM unterbrochen; die alte
+  // Ablage ist bis zum Header unverändert, die Übernahme darf neu laufen
+  size_t headerLen = store.length(KEY_HEADER);
+  if (headerLen == 0) return 1;
+  if (headerLen == 1) return 2;   // Übernahme-Marker aus Version 2
+
+  ConfigHeader header;
+  if (headerLen != sizeof(header) || !store.get(KEY_HEADER, &header, sizeof(header))
+      || header.magic != kConfigMagic) {
+    return kConfigVersion;        // Header unbrauchbar: Felder einzeln prüfen
+  }
+  valid = header.version == kConfigVersion && header.size == sizeof(ConfigData)
+       && header.crc == crc(data);
+  return header.version;
+}
+
+bool save(LogStore &store, const ConfigData &data, uint32_t mask) {
+  const uint8_t *base = (const uint8_t*)&data;
+  bool ok = true;
+  for (size_t i = 0; i < kConfigFieldCount; i++) {
+    if (!(mask & (1u << i))) continue;
+    const ConfigField &f = kConfigFields[i];
+    ok = store.put(f.key, base + f.offset, f.size) && ok;
+  }
+  // Header zuletzt: fällt der Strom vorher aus, passt die CRC nicht und
+  // begin() prüft die Felder einzeln
+  ConfigHeader header = { kConfigMagic, kConfigVersion, (uint16_t)sizeof(ConfigData), crc(data) };
+  return store.put(KEY_HEADER, &header, sizeof(header)) && ok;
+}
+
+bool migrate(ConfigData &data, uint16_t version, const Migration *migrations, size_t count) {
+  while (version < kConfigVersion) {
+    const Migration *step = nullptr;
+    for (size_t i = 0; i < count; i++) {
+      if (migrations[i].from == version) step = &migrations[i];
+    }
+    if (!step || !step->apply(data)) return false;
+    version++;
+  }
+  return version == kConfigVersion;
+}
+
+} // namespace ConfigSchema
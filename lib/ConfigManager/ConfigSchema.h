@@ -0,0 +1,157 @@
+#ifndef CONFIGSCHEMA_H
+#define CONFIGSCHEMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "LogStore.h"
+
+//----------------------------------------------------------------------------
+// Schema der Konfiguration
+// ConfigData ist der gesamte Inhalt, kConfigFields ordnet jedem Feld seinen
+// Key im LogStore zu. Zusätzlich liegt unter KEY_HEADER ein ConfigHeader mit
+// Schema-Version und CRC über ConfigData. Stimmen beide, wird die
+// Konfiguration in einem Durchgang ohne weitere Prüfungen übernommen.
+//
+// Versionen:
+//   1  alte EEPROM-Ablage (EE_ADD_*, Text und MyTestObject überlappen)
+//   2  LogStore, KEY_HEADER nur 1 Byte als Übernahme-Marker
+//   3  LogStore mit ConfigHeader (Version, Größe, CRC)
+// Ändert sich ConfigData, kConfigVersion erhöhen und eine Migration eintragen.
+//----------------------------------------------------------------------------
+
+// --- Konfiguration ---
+constexpr size_t EEPROM_SIZE = 512;
+constexpr size_t MAX_SSID = 21;
+constexpr size_t MAX_PASSWORD = 21;
+constexpr size_t MAX_IP = 17;
+constexpr size_t MAX_SN = 17;
+constexpr size_t MAX_TEXT = 51;
+
+struct MyTestObject {
+  uint8_t byte_field;
+  long    long_field;
+  float   float_field;
+  char    name[12];
+};
+
+// Format im Log: IP-Adressen als 4 Bytes (IPAddress selbst enthält einen vtable-Zeiger)
+struct WifiRecord {
+  char    ssid[MAX_SSID];
+  char    password[MAX_PASSWORD];
+  uint8_t ip[4];
+  uint8_t gw[4];
+  uint8_t sn[4];
+};
+
+// --- Keys im Log-Speicher (LogStore) ---
+enum ConfigKey : uint16_t {
+  KEY_HEADER         = 0,
+  KEY_WIFI_STA       = 1,
+  KEY_WIFI_AP        = 2,
+  KEY_BYTE           = 3,
+  KEY_FLOAT          = 4,
+  KEY_TEXT           = 5,
+  KEY_MY_TEST_OBJECT = 6,
+};
+
+struct ConfigData {
+  WifiRecord   sta;
+  WifiRecord   ap;
+  uint8_t      byteValue;
+  float        floatValue;
+  char         text[MAX_TEXT];
+  MyTestObject testObject;
+};
+
+struct ConfigHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t size;      // sizeof(ConfigData)
+  uint32_t crc;       // über ConfigData
+};
+
+struct ConfigField {
+  ConfigKey key;
+  uint16_t  offset;
+  uint16_t  size;
+};
+
+constexpr uint32_t kConfigMagic = 0x43464731;   // "CFG1"
+constexpr uint16_t kConfigVersion = 3;
+
+constexpr ConfigField kConfigFields[] = {
+  { KEY_WIFI_STA,       offsetof(ConfigData, sta),        sizeof(WifiRecord)   },
+  { KEY_WIFI_AP,        offsetof(ConfigData, ap),         sizeof(WifiRecord)   },
+  { KEY_BYTE,           offsetof(ConfigData, byteValue),  sizeof(uint8_t)      },
+  { KEY_FLOAT,          offsetof(ConfigData, floatValue), sizeof(float)        },
+  { KEY_TEXT,           offsetof(ConfigData, text),       MAX_TEXT             },
+  { KEY_MY_TEST_OBJECT, offsetof(ConfigData, testObject), sizeof(MyTestObject) },
+};
+constexpr size_t kConfigFieldCount = sizeof(kConfigFields) / sizeof(kConfigFields[0]);
+
+namespace ConfigSchema {
+
+constexpr bool fieldsDisjoint() {
+  for (size_t i = 0; i < kConfigFieldCount; i++) {
+    for (size_t j = i + 1; j < kConfigFieldCount; j++) {
+      const ConfigField &a = kConfigFields[i];
+      const ConfigField &b = kConfigFields[j];
+      if (a.key == b.key) return false;
+      if (a.offset < b.offset + b.size && b.offset < a.offset + a.size) return false;
+    }
+  }
+  return true;
+}
+
+constexpr bool fieldsInside() {
+  for (size_t i = 0; i < kConfigFieldCount; i++) {
+    const ConfigField &f = kConfigFields[i];
+    if (f.size == 0 || f.offset + f.size > sizeof(ConfigData)) return false;
+    if (f.key == KEY_HEADER || f.key >= LogStore::kMaxKeys || f.size > LogStore::kMaxValue) return false;
+  }
+  return true;
+}
+
+// Bytes, die zu keinem Feld gehören, dürfen nur Füllbytes sein (Lücke < Alignment)
+constexpr bool fieldsCover() {
+  size_t gap = 0;
+  for (size_t pos = 0; pos < sizeof(ConfigData); pos++) {
+    bool covered = false;
+    for (size_t i = 0; i < kConfigFieldCount; i++) {
+      const ConfigField &f = kConfigFields[i];
+      if (pos >= f.offset && pos < (size_t)f.offset + f.size) covered = true;
+    }
+    gap = covered ? 0 : gap + 1;
+    if (gap >= alignof(ConfigData)) return false;
+  }
+  return true;
+}
+
+static_assert(fieldsDisjoint(), "Config-Felder überlappen oder Key doppelt");
+static_assert(fieldsInside(), "Config-Feld außerhalb von ConfigData oder zu groß für den LogStore");
+static_assert(fieldsCover(), "ConfigData enthält ein Feld ohne Eintrag in kConfigFields");
+static_assert(sizeof(ConfigHeader) + sizeof(ConfigData) <= EEPROM_SIZE, "Konfiguration größer als EEPROM_SIZE");
+
+uint32_t crc(const ConfigData &data);
+uint32_t fieldMask(ConfigKey key);
+constexpr uint32_t kAllFields = (1u << kConfigFieldCount) - 1;
+
+// Liest alle Felder nach data (fehlende = 0). Rückgabe: gespeicherte Version
+// (1 = noch nichts im Log); valid = Header passt und CRC stimmt.
+uint16_t load(LogStore &store, ConfigData &data, bool &valid);
+
+// Schreibt die Felder aus mask und danach den Header mit neuer CRC
+bool save(LogStore &store, const ConfigData &data, uint32_t mask);
+
+struct Migration {
+  uint16_t from;                         // hebt from -> from + 1
+  bool (*apply)(ConfigData &data);
+  const char *what;
+};
+
+// Führt alle Migrationen ab version der Reihe nach aus; false wenn eine fehlt/fehlschlägt
+bool migrate(ConfigData &data, uint16_t version, const Migration *migrations, size_t count);
+
+} // namespace ConfigSchema
+
+#endif
@@ -0,0 +1,20 @@
+#include "EspPartitionFlash.h"
+
+#ifdef ESP32
+bool EspPartitionFlash::begin(const char *label) {
+  _part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+  return _part != nullptr;
+}
+
+bool EspPartitionFlash::read(uint32_t addr, void *out, size_t len) {
+  return _part && esp_partition_read(_part, addr, out, len) == ESP_OK;
+}
+
+bool EspPartitionFlash::write(uint32_t addr, const void *data, size_t len) {
+  return _part && esp_partition_write(_part, addr, data, len) == ESP_OK;
+}
+
+bool EspPartitionFlash::erase(size_t sector) {
+  return _part && esp_partition_erase_range(_part, sector * SPI_FLASH_SEC_SIZE, SPI_FLASH_SEC_SIZE) == ESP_OK;
+}
+#endif
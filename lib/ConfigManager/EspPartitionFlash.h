@@ -0,0 +1,25 @@
+#ifndef ESPPARTITIONFLASH_H
+#define ESPPARTITIONFLASH_H
+
+#include "LogStore.h"
+
+#ifdef ESP32
+#include <esp_partition.h>
+
+// FlashDevice auf einer eigenen Datenpartition (partitions.csv, Name "config")
+class EspPartitionFlash : public FlashDevice {
+public:
+  bool begin(const char *label);
+
+  size_t sectorSize() const override { return SPI_FLASH_SEC_SIZE; }
+  size_t sectorCount() const override { return _part ? _part->size / SPI_FLASH_SEC_SIZE : 0; }
+  bool read(uint32_t addr, void *out, size_t len) override;
+  bool write(uint32_t addr, const void *data, size_t len) override;
+  bool erase(size_t sector) override;
+
+private:
+  const esp_partition_t *_part = nullptr;
+};
+#endif
+
+#endif
@@ -0,0 +1,312 @@
+#include "LogStore.h"
+#include <string.h>
+
+uint32_t LogStore::crc32(uint32_t crc, const void *data, size_t len) {
+  const uint8_t *p = (const uint8_t*)data;
+  crc = ~crc;
+  while (len--) {
+    crc ^= *p++;
+    for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+  }
+  return ~crc;
+}
+
+static bool allErased(const uint8_t *p, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (p[i] != 0xFF) return false;
+  }
+  return true;
+}
+
+bool LogStore::mount() {
+  _mounted = false;
+  _sectorSize = _flash.sectorSize();
+  _sectorCount = _flash.sectorCount();
+  if (_sectorCount > kMaxSectors) _sectorCount = kMaxSectors;
+  if (_sectorCount < 3 || _sectorSize < kSectorHeader + kRecordHeader + kMaxValue) return false;
+
+  for (auto &loc : _index) loc = Location();
+  _head = -1;
+  _nextSeq = 1;
+
+  for (size_t i = 0; i < _sectorCount; i++) {
+    Sector &s = _sectors[i];
+    s = Sector();
+    uint32_t hdr[4];
+    if (!_flash.read(sectorBase(i), hdr, sizeof(hdr))) continue;   // bleibt DIRTY
+    if (allErased((const uint8_t*)hdr, sizeof(hdr))) {
+      s.state = SectorState::FREE;
+    } else if (hdr[0] == kMagic && hdr[2] == crc32(0, hdr, 8)) {
+      s.state = SectorState::ACTIVE;
+      s.seq = hdr[1];
+      if (s.seq >= _nextSeq) _nextSeq = s.seq + 1;
+    }
+  }
+
+  // Sektoren in Schreibreihenfolge abspielen, spätere Records überschreiben frühere
+  uint32_t last = 0;
+  bool first = true;
+  for (;;) {
+    int next = -1;
+    for (size_t i = 0; i < _sectorCount; i++) {
+      const Sector &s = _sectors[i];
+      if (s.state != SectorState::ACTIVE || (!first && s.seq <= last)) continue;
+      if (next < 0 || s.seq < _sectors[next].seq) next = (int)i;
+    }
+    if (next < 0) break;
+    scanSector(next);
+    last = _sectors[next].seq;
+    first = false;
+    _head = next;
+  }
+
+  _mounted = true;
+  return true;
+}
+
+// Header: [key u16][len u16][crc32 über key/len][crc32 über Daten]
+bool LogStore::readHeader(uint32_t addr, uint16_t &key, uint16_t &len, uint32_t &dataCrc) {
+  uint8_t hdr[kRecordHeader];
+  if (!_flash.read(addr, hdr, sizeof(hdr))) return false;
+  uint32_t headerCrc;
+  memcpy(&key, hdr, 2);
+  memcpy(&len, hdr + 2, 2);
+  memcpy(&headerCrc, hdr + 4, 4);
+  memcpy(&dataCrc, hdr + 8, 4);
+  return headerCrc == crc32(0, hdr, 4) && len <= kMaxValue;
+}
+
+bool LogStore::readRecord(uint32_t addr, uint32_t limit, uint16_t &key, uint16_t &len, uint8_t *data) {
+  uint32_t dataCrc;
+  if (!readHeader(addr, key, len, dataCrc) || addr + recordSize(len) > limit) return false;
+  if (!_flash.read(addr + kRecordHeader, data, len)) return false;
+  return dataCrc == crc32(0, data, len);
+}
+
+// Ist der Header lesbar, ist die Länge bekannt und ein halber Record wird
+// übersprungen. Ein halber Header kann nur der letzte Schreibvorgang gewesen
+// sein: dahinter muss der Sektor leer sein.
+void LogStore::scanSector(size_t index) {
+  Sector &s = _sectors[index];
+  uint32_t base = sectorBase(index);
+  uint32_t limit = base + (uint32_t)_sectorSize;
+  uint32_t pos = kSectorHeader;
+  uint8_t data[kMaxValue];
+
+  while (pos + kRecordHeader <= _sectorSize) {
+    uint8_t peek[kRecordHeader];
+    if (!_flash.read(base + pos, peek, sizeof(peek))) break;
+    if (allErased(peek, sizeof(peek))) {
+      if (!blank(base + pos, limit)) break;   // nicht beschreibbar
+      s.used = pos;
+      return;
+    }
+    uint16_t key, len;
+    uint32_t dataCrc;
+    if (!readHeader(base + pos, key, len, dataCrc) || base + pos + recordSize(len) > limit) {
+      _stats.torn++;
+      pos += kRecordHeader;
+      continue;
+    }
+    bool ok = _flash.read(base + pos + kRecordHeader, data, len) && dataCrc == crc32(0, data, len);
+    if (!ok) {
+      _stats.torn++;
+    } else if (key < kMaxKeys) {
+      _index[key].addr = base + pos;
+      _index[key].len = len;
+      _index[key].valid = true;
+    }
+    pos += (uint32_t)recordSize(len);
+  }
+  s.used = (uint32_t)_sectorSize;
+  s.closed = true;
+}
+
+bool LogStore::blank(uint32_t from, uint32_t to) {
+  uint8_t buf[64];
+  while (from < to) {
+    size_t n = to - from < sizeof(buf) ? to - from : sizeof(buf);
+    if (!_flash.read(from, buf, n) || !allErased(buf, n)) return false;
+    from += (uint32_t)n;
+  }
+  return true;
+}
+
+bool LogStore::empty() const {
+  for (const auto &loc : _index) {
+    if (loc.valid) return false;
+  }
+  return true;
+}
+
+size_t LogStore::length(uint16_t key) const {
+  return (key < kMaxKeys && _index[key].valid) ? _index[key].len : 0;
+}
+
+bool LogStore::get(uint16_t key, void *out, size_t len) {
+  memset(out, 0, len);
+  if (!_mounted || key >= kMaxKeys || !_index[key].valid) return false;
+  const Location &loc = _index[key];
+  size_t n = loc.len < len ? loc.len : len;
+  return _flash.read(loc.addr + kRecordHeader, out, n);
+}
+
+bool LogStore::put(uint16_t key, const void *data, size_t len) {
+  if (!_mounted || key >= kMaxKeys || len > kMaxValue) return false;
+
+  const Location &old = _index[key];
+  if (old.valid) {
+    // gleicher Wert -> kein Schreibzugriff
+    uint8_t current[kMaxValue];
+    if (old.len == len && _flash.read(old.addr + kRecordHeader, current, len)
+        && memcmp(current, data, len) == 0) {
+      _stats.skipped++;
+      return true;
+    }
+  }
+  size_t live = liveBytes();
+  // alle gültigen Records plus der neue müssen in einen Sektor passen, sonst
+  // klappt die Kompaktierung nicht (der alte Wert wird dabei noch mitkopiert)
+  if (live + recordSize(len) > _sectorSize - kSectorHeader) return false;
+  return append(key, data, len, true);
+}
+
+bool LogStore::append(uint16_t key, const void *data, size_t len, bool allowCompact) {
+  size_t size = recordSize(len);
+  if (_head < 0 || _sectors[_head].closed || _sectors[_head].used + size > _sectorSize) {
+    if (!(allowCompact ? switchSector() : openSector())) return false;
+  }
+
+  uint8_t buf[kRecordHeader + kMaxValue];
+  uint16_t len16 = (uint16_t)len;
+  memcpy(buf, &key, 2);
+  memcpy(buf + 2, &len16, 2);
+  uint32_t headerCrc = crc32(0, buf, 4);
+  uint32_t dataCrc = crc32(0, data, len);
+  memcpy(buf + 4, &headerCrc, 4);
+  memcpy(buf + 8, &dataCrc, 4);
+  memcpy(buf + kRecordHeader, data, len);
+  memset(buf + kRecordHeader + len, 0xFF, size - kRecordHeader - len);
+
+  Sector &s = _sectors[_head];
+  uint32_t addr = sectorBase(_head) + s.used;
+  if (!_flash.write(addr, buf, size)) {
+    // Zustand des Sektors unklar -> nicht weiter beschreiben
+    s.closed = true;
+    return false;
+  }
+  s.used += (uint32_t)size;
+  _index[key].addr = addr;
+  _index[key].len = len16;
+  _index[key].valid = true;
+  _stats.appends++;
+  return true;
+}
+
+// Neuer Sektor, dann die ältesten Sektoren hinein kompaktieren, bis wieder
+// zwei frei sind. Alle gültigen Records passen in einen Sektor (put()).
+bool LogStore::switchSector() {
+  if (!openSector()) return false;
+  for (size_t i = 0; freeSectors() < 2 && i < _sectorCount; i++) {
+    if (!relocateOldest()) break;
+  }
+  return true;
+}
+
+// Freien Sektor nach dem aktuellen wählen (reihum), prüfen/löschen, Header schreiben
+bool LogStore::openSector() {
+  for (size_t n = 1; n <= _sectorCount; n++) {
+    size_t i = (size_t)((_head < 0 ? (int)_firstSector - 1 : _head) + (int)n) % _sectorCount;
+    if (_sectors[i].state == SectorState::ACTIVE) continue;
+    if (!prepareFree(i)) continue;
+
+    uint32_t hdr[4] = { kMagic, _nextSeq, 0, 0xFFFFFFFFu };
+    hdr[2] = crc32(0, hdr, 8);
+    Sector &s = _sectors[i];
+    if (!_flash.write(sectorBase(i), hdr, sizeof(hdr))) {
+      s.state = SectorState::DIRTY;
+      continue;
+    }
+    s.state = SectorState::ACTIVE;
+    s.seq = _nextSeq++;
+    s.used = kSectorHeader;
+    s.closed = false;
+    _head = (int)i;
+    return true;
+  }
+  return false;
+}
+
+// Ein als frei erkannter Sektor kann von einem abgebrochenen Löschvorgang stammen
+bool LogStore::prepareFree(size_t index) {
+  if (_sectors[index].state == SectorState::FREE
+      && blank(sectorBase(index), sectorBase(index) + (uint32_t)_sectorSize)) {
+    return true;
+  }
+  return eraseSector(index);
+}
+
+bool LogStore::eraseSector(size_t index) {
+  Sector &s = _sectors[index];
+  s = Sector();
+  _stats.erases++;
+  if (!_flash.erase(index)) return false;   // bleibt DIRTY
+  s.state = SectorState::FREE;
+  return true;
+}
+
+int LogStore::oldestSector() const {
+  int oldest = -1;
+  for (size_t i = 0; i < _sectorCount; i++) {
+    if (_sectors[i].state != SectorState::ACTIVE || (int)i == _head) continue;
+    if (oldest < 0 || _sectors[i].seq < _sectors[oldest].seq) oldest = (int)i;
+  }
+  return oldest;
+}
+
+// Gültige Records des ältesten Sektors nach vorne kopieren, dann Sektor löschen
+bool LogStore::relocateOldest() {
+  int oldest = oldestSector();
+  if (oldest < 0) return false;
+  uint32_t base = sectorBase(oldest);
+  uint32_t limit = base + (uint32_t)_sectorSize;
+  uint8_t data[kMaxValue];
+
+  for (uint16_t key = 0; key < kMaxKeys; key++) {
+    const Location &loc = _index[key];
+    if (!loc.valid || loc.addr < base || loc.addr >= limit) continue;
+    uint16_t k, len;
+    if (!readRecord(loc.addr, limit, k, len, data)) return false;
+    if (!append(key, data, len, false)) return false;
+    _stats.relocated++;
+  }
+  return eraseSector(oldest);
+}
+
+void LogStore::maintain() {
+  if (!_mounted) return;
+  // pro Aufruf höchstens ein Löschvorgang, damit loop() nicht lange hängt
+  for (size_t i = 0; i < _sectorCount; i++) {
+    if (_sectors[i].state == SectorState::DIRTY) {
+      eraseSector(i);
+      return;
+    }
+  }
+  if (freeSectors() < 2) relocateOldest();
+}
+
+size_t LogStore::freeSectors() const {
+  size_t n = 0;
+  for (size_t i = 0; i < _sectorCount; i++) {
+    if (_sectors[i].state != SectorState::ACTIVE) n++;
+  }
+  return n;
+}
+
+size_t LogStore::liveBytes() const {
+  size_t n = 0;
+  for (const auto &loc : _index) {
+    if (loc.valid) n += recordSize(loc.len);
+  }
+  return n;
+}
@@ -0,0 +1,120 @@
+#ifndef LOGSTORE_H
+#define LOGSTORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//----------------------------------------------------------------------------
+// FlashDevice
+// NOR-Flash in Sektoren: write() kann Bits nur von 1 auf 0 setzen, erase()
+// setzt einen ganzen Sektor auf 0xFF. ESP32: EspPartitionFlash, Tests: SimFlash.
+//----------------------------------------------------------------------------
+class FlashDevice {
+public:
+  virtual ~FlashDevice() = default;
+  virtual size_t sectorSize() const = 0;
+  virtual size_t sectorCount() const = 0;
+  virtual bool read(uint32_t addr, void *out, size_t len) = 0;
+  virtual bool write(uint32_t addr, const void *data, size_t len) = 0;
+  virtual bool erase(size_t sector) = 0;
+};
+
+//----------------------------------------------------------------------------
+// LogStore
+// Key/Value-Speicher als Log über mehrere Sektoren. Jeder put() hängt einen
+// Record [key u16][len u16][Header-CRC][Daten-CRC][Daten, auf 4 Byte aufgefüllt]
+// an den aktuellen Sektor an, es wird nie an Ort und Stelle überschrieben.
+// Beim mount() wird das Log in Sektor-Reihenfolge (seq) abgespielt, der
+// jüngste Record pro Key gilt.
+//
+// Stromausfall: ein halb geschriebener Record hat eine falsche CRC und wird
+// übersprungen, der alte Wert bleibt gültig. Bei einem Sektorwechsel werden
+// die noch gültigen Records der ältesten Sektoren in den neuen Sektor kopiert
+// und die alten erst danach gelöscht – so wandern die Löschzyklen gleichmäßig
+// über alle Sektoren und es bleibt immer ein freier Sektor in Reserve.
+//
+// maintain() holt unterbrochene Kompaktierungen/Löschvorgänge im Hintergrund
+// nach (loop()).
+//----------------------------------------------------------------------------
+class LogStore {
+public:
+  static constexpr uint16_t kMaxKeys = 16;
+  static constexpr size_t kMaxValue = 128;
+  static constexpr size_t kMaxSectors = 16;
+
+  struct Stats {
+    uint32_t appends = 0;
+    uint32_t skipped = 0;      // put() mit unverändertem Wert
+    uint32_t erases = 0;
+    uint32_t relocated = 0;    // bei der Kompaktierung kopierte Records
+    uint32_t torn = 0;         // beim mount() verworfene (halbe) Records
+  };
+
+  // firstSector: erster Sektor eines leeren Logs, danach reihum
+  explicit LogStore(FlashDevice &flash, size_t firstSector = 0)
+  : _flash(flash), _firstSector(firstSector) {}
+
+  bool mount();
+  bool mounted() const { return _mounted; }
+  bool empty() const;
+
+  // Kopiert den Wert nach out (Rest mit 0 gefüllt); false wenn der Key fehlt
+  bool get(uint16_t key, void *out, size_t len);
+  size_t length(uint16_t key) const;
+  bool put(uint16_t key, const void *data, size_t len);
+
+  void maintain();
+  size_t freeSectors() const;
+  const Stats& stats() const { return _stats; }
+
+  static uint32_t crc32(uint32_t crc, const void *data, size_t len);
+
+private:
+  enum class SectorState : uint8_t { FREE, ACTIVE, DIRTY };
+
+  struct Sector {
+    SectorState state = SectorState::DIRTY;
+    bool closed = false;    // kein Platz mehr oder beschädigter Record
+    uint32_t seq = 0;
+    uint32_t used = 0;      // Schreibposition im Sektor
+  };
+
+  struct Location {
+    uint32_t addr = 0;      // Adresse des Record-Headers
+    uint16_t len = 0;
+    bool valid = false;
+  };
+
+  static constexpr uint32_t kMagic = 0x4C474643; // "CFGL"
+  static constexpr size_t kSectorHeader = 16;
+  static constexpr size_t kRecordHeader = 12;
+
+  static size_t recordSize(size_t len) { return kRecordHeader + ((len + 3) & ~size_t(3)); }
+
+  void scanSector(size_t index);
+  bool readHeader(uint32_t addr, uint16_t &key, uint16_t &len, uint32_t &dataCrc);
+  bool readRecord(uint32_t addr, uint32_t limit, uint16_t &key, uint16_t &len, uint8_t *data);
+  bool append(uint16_t key, const void *data, size_t len, bool allowCompact);
+  bool switchSector();
+  bool openSector();
+  bool prepareFree(size_t index);
+  bool blank(uint32_t from, uint32_t to);
+  bool relocateOldest();
+  bool eraseSector(size_t index);
+  int oldestSector() const;
+  size_t liveBytes() const;
+  uint32_t sectorBase(size_t index) const { return (uint32_t)(index * _sectorSize); }
+
+  FlashDevice &_flash;
+  size_t _firstSector;
+  size_t _sectorSize = 0;
+  size_t _sectorCount = 0;
+  Sector _sectors[kMaxSectors];
+  Location _index[kMaxKeys];
+  int _head = -1;
+  uint32_t _nextSeq = 1;
+  bool _mounted = false;
+  Stats _stats;
+};
+
+#endif
@@ -0,0 +1,253 @@
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "WiFi.h"
+#include "esp_partition.h"
+#include <chrono>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------------
+// Core
+//----------------------------------------------------------------------------
+static const auto kStart = std::chrono::steady_clock::now();
+static uint64_t offsetUs = 0;
+static uint8_t pins[64];
+static uint32_t restartCount = 0;
+
+size_t NativeHost::heapUsed = 0;
+
+unsigned long micros() {
+    auto elapsed = std::chrono::steady_clock::now() - kStart;
+    return (unsigned long)(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() + offsetUs);
+}
+
+unsigned long millis() {
+    return micros() / 1000;
+}
+
+void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield() {}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (pin < sizeof(pins)) pins[pin] = value;
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < sizeof(pins) ? pins[pin] : LOW;
+}
+
+void NativeHost::advanceMillis(uint32_t ms) {
+    offsetUs += (uint64_t)ms * 1000;
+}
+
+int NativeHost::pinState(uint8_t pin) {
+    return digitalRead(pin);
+}
+
+uint32_t NativeHost::restarts() {
+    return restartCount;
+}
+
+size_t HardwareSerial::printf(const char *format, ...) {
+    if (!_out) return 0;
+    va_list args;
+    va_start(args, format);
+    int n = vfprintf(_out, format, args);
+    va_end(args);
+    return n < 0 ? 0 : n;
+}
+
+size_t HardwareSerial::print(const char *s) {
+    if (!_out) return 0;
+    fputs(s, _out);
+    return strlen(s);
+}
+
+// Kein Neustart auf dem Host, nur zählen
+void EspClass::restart() {
+    restartCount++;
+}
+
+uint32_t EspClass::getFreeHeap() {
+    return NativeHost::heapUsed < NativeHost::kHeapSize ? NativeHost::kHeapSize - NativeHost::heapUsed : 0;
+}
+
+HardwareSerial Serial;
+EspClass ESP;
+EEPROMClass EEPROM;
+
+//----------------------------------------------------------------------------
+// Partition "config" (partitions.csv: 0x3EC000, 0x4000)
+//----------------------------------------------------------------------------
+static const esp_partition_t configPartition = {
+    ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x40, 0x3EC000, 0x4000, "config", false
+};
+static uint8_t flash[0x4000];
+static bool flashReady = false;
+static uint32_t erases = 0;
+static uint64_t bytesWritten = 0;
+static uint32_t writeLatencyUs = 0;
+static uint32_t eraseLatencyUs = 0;
+
+void NativeHost::resetPartition() {
+    memset(flash, 0xFF, sizeof(flash));
+    flashReady = true;
+    erases = 0;
+    bytesWritten = 0;
+}
+
+uint32_t NativeHost::partitionErases() {
+    return erases;
+}
+
+uint64_t NativeHost::partitionBytesWritten() {
+    return bytesWritten;
+}
+
+void NativeHost::setFlashLatency(uint32_t writeUs, uint32_t eraseUs) {
+    writeLatencyUs = writeUs;
+    eraseLatencyUs = eraseUs;
+}
+
+//----------------------------------------------------------------------------
+// Partition "assets" (partitions.csv: 0x3A0000, 0x4C000), nur über mmap
+//----------------------------------------------------------------------------
+static const esp_partition_t assetsPartition = {
+    ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x41, 0x3A0000, 0x4C000, "assets", false
+};
+static uint8_t *assetsFlash = nullptr;
+
+// Ganze Partition einmal reservieren, gelöscht = 0xFF; Dateien werden darüber eingeblendet
+static uint8_t* assetsRegion() {
+    if (assetsFlash) return assetsFlash;
+    void *region = mmap(nullptr, assetsPartition.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) return nullptr;
+    memset(region, 0xFF, assetsPartition.size);
+    mprotect(region, assetsPartition.size, PROT_READ);
+    assetsFlash = (uint8_t*)region;
+    return assetsFlash;
+}
+
+bool NativeHost::loadPartitionFile(const char *label, const char *path) {
+    if (strcmp(label, assetsPartition.label) != 0) return false;
+    uint8_t *region = assetsRegion();
+    int fd = open(path, O_RDONLY);
+    if (!region || fd < 0) {
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0 && st.st_size > 0 && (size_t)st.st_size <= assetsPartition.size
+              && mmap(region, st.st_size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) != MAP_FAILED;
+    close(fd);
+    return ok;
+}
+
+static bool inRange(const esp_partition_t *part, size_t offset, size_t size) {
+    if (!flashReady) NativeHost::resetPartition();
+    return (part == &configPartition || part == &assetsPartition)
+           && offset <= part->size && size <= part->size - offset;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *label) {
+    if (type != ESP_PARTITION_TYPE_DATA) return nullptr;
+    for (const esp_partition_t *part : {&configPartition, &assetsPartition}) {
+        if (subtype != ESP_PARTITION_SUBTYPE_ANY && subtype != part->subtype) continue;
+        if (label && strcmp(label, part->label) != 0) continue;
+        return part;
+    }
+    return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *part, size_t offset, void *dst, size_t size) {
+    if (!inRange(part, offset, size)) return ESP_ERR_INVALID_SIZE;
+    if (part == &assetsPartition) {
+        if (!assetsRegion()) return ESP_FAIL;
+        memcpy(dst, assetsFlash + offset, size);
+        return ESP_OK;
+    }
+    memcpy(dst, flash + offset, size);
+    return ESP_OK;
+}
+
+// NOR: Schreiben kann Bits nur löschen
+esp_err_t esp_partition_write(const esp_partition_t *part, size_t offset, const void *src, size_t size) {
+    if (!inRange(part, offset, size) || part != &configPartition) return ESP_ERR_INVALID_SIZE;
+    const uint8_t *bytes = (const uint8_t*)src;
+    for (size_t i = 0; i < size; i++) flash[offset + i] &= bytes[i];
+    bytesWritten += size;
+    if (writeLatencyUs) std::this_thread::sleep_for(std::chrono::microseconds(writeLatencyUs));
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *part, size_t offset, size_t size) {
+    if (!inRange(part, offset, size) || part != &configPartition) return ESP_ERR_INVALID_SIZE;
+    if (offset % SPI_FLASH_SEC_SIZE || size % SPI_FLASH_SEC_SIZE) return ESP_ERR_INVALID_ARG;
+    memset(flash + offset, 0xFF, size);
+    erases += size / SPI_FLASH_SEC_SIZE;
+    if (eraseLatencyUs) {
+        std::this_thread::sleep_for(std::chrono::microseconds(eraseLatencyUs * (size / SPI_FLASH_SEC_SIZE)));
+    }
+    return ESP_OK;
+}
+
+// Nur "assets": Zeiger direkt in die Abbildung, wie der Flash-Cache auf dem ESP32
+esp_err_t esp_partition_mmap(const esp_partition_t *part, size_t offset, size_t size,
+                             spi_flash_mmap_memory_t memory, const void **out_ptr,
+                             spi_flash_mmap_handle_t *out_handle) {
+    if (part != &assetsPartition || !inRange(part, offset, size)) return ESP_ERR_INVALID_ARG;
+    if (!assetsRegion()) return ESP_FAIL;
+    *out_ptr = assetsFlash + offset;
+    *out_handle = 1;
+    return ESP_OK;
+}
+
+// Abbildung bleibt bis Prozessende bestehen
+void spi_flash_munmap(spi_flash_mmap_handle_t handle) {}
+
+//----------------------------------------------------------------------------
+// WiFi
+//----------------------------------------------------------------------------
+wl_status_t WiFiClass::begin(const char *ssid, const char *password) {
+    _ssid = ssid;
+    emit(ARDUINO_EVENT_WIFI_STA_START);
+    if (!_reachable) {
+        _status = WL_NO_SSID_AVAIL;
+        emit(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+        return _status;
+    }
+    _status = WL_CONNECTED;
+    emit(ARDUINO_EVENT_WIFI_STA_CONNECTED);
+    emit(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    return _status;
+}
+
+bool WiFiClass::disconnect(bool wifioff, bool eraseap) {
+    bool wasConnected = _status == WL_CONNECTED;
+    _status = WL_DISCONNECTED;
+    if (wifioff) _mode = WIFI_OFF;
+    if (wasConnected) emit(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+    return true;
+}
+
+void WiFiClass::hostDrop() {
+    if (_status != WL_CONNECTED) return;
+    _status = WL_DISCONNECTED;
+    emit(ARDUINO_EVENT_WIFI_STA_LOST_IP);
+    emit(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+}
+
+void WiFiClass::emit(arduino_event_id_t event) {
+    arduino_event_info_t info = {};
+    for (auto &handler : _handlers) handler(event, info);
+}
+
+WiFiClass WiFi;
@@ -0,0 +1,94 @@
+#ifndef NATIVEHOST_ARDUINO_H
+#define NATIVEHOST_ARDUINO_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include "WString.h"
+#include "IPAddress.h"
+
+//----------------------------------------------------------------------------
+// Arduino-Core (Host)
+// Nur was der Sketch braucht. millis() läuft mit der echten Uhr plus einem
+// Versatz, den Tests und Benchmarks mit NativeHost::advanceMillis() vorstellen.
+//----------------------------------------------------------------------------
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define F(s) (s)
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strstr_P strstr
+
+#define LOW    0
+#define HIGH   1
+#define INPUT  0
+#define OUTPUT 1
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+class HardwareSerial {
+public:
+    void begin(unsigned long) {}
+    int available() { return 0; }
+    int read() { return -1; }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+    size_t print(const char *s);
+    size_t print(const String &s) { return print(s.c_str()); }
+    size_t print(char c) { char s[2] = { c, 0 }; return print(s); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t print(unsigned int v) { return printf("%u", v); }
+    size_t print(long v) { return printf("%ld", v); }
+    size_t print(unsigned long v) { return printf("%lu", v); }
+    size_t print(unsigned char v) { return printf("%u", v); }
+    size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+    size_t print(const IPAddress &ip) { return print(ip.toString()); }
+    template <typename T> size_t println(const T &v) { size_t n = print(v); return n + print("\n"); }
+    size_t println(double v, int digits) { size_t n = print(v, digits); return n + print("\n"); }
+    size_t println() { return print("\n"); }
+
+    // Host: Ausgabe umleiten, nullptr = stumm (Benchmarks)
+    void setOutput(FILE *out) { _out = out; }
+
+private:
+    FILE *_out = stdout;
+};
+extern HardwareSerial Serial;
+
+class EspClass {
+public:
+    void restart();
+    uint32_t getFreeHeap();
+    uint32_t getMaxAllocHeap() { return getFreeHeap(); }
+};
+extern EspClass ESP;
+
+// Zufallszahl wie esp_random() (esp_system.h), auf dem Host nur rand()
+inline uint32_t esp_random() { return ((uint32_t)rand() << 16) ^ (uint32_t)rand(); }
+
+namespace NativeHost {
+    // Heap des ESP32 (DRAM) als Referenz für getFreeHeap()
+    constexpr size_t kHeapSize = 320 * 1024;
+    // von Benchmarks mit eigenem operator new gepflegt, sonst 0
+    extern size_t heapUsed;
+
+    void advanceMillis(uint32_t ms);
+    int pinState(uint8_t pin);
+    uint32_t restarts();
+}
+
+#endif
@@ -0,0 +1,108 @@
+#include "AsyncEventSource.h"
+#include <map>
+#include <string>
+
+//----------------------------------------------------------------------------
+// Client
+//----------------------------------------------------------------------------
+void AsyncEventSourceClient::write(const char *message, size_t len) {
+    if (!_connected) return;
+    _received.concat(message, len);
+    _messages++;
+}
+
+void AsyncEventSourceClient::send(const char *message, const char *event, uint32_t id, uint32_t reconnect) {
+    String text = AsyncEventSource::format(message, event, id, reconnect);
+    write(text.c_str(), text.length());
+}
+
+size_t AsyncEventSourceClient::hostDrain() {
+    size_t n = _received.length();
+    _received = String();
+    return n;
+}
+
+//----------------------------------------------------------------------------
+// Quelle
+//----------------------------------------------------------------------------
+static std::map<std::string, AsyncEventSource*>& sources() {
+    static std::map<std::string, AsyncEventSource*> map;
+    return map;
+}
+
+AsyncEventSource::AsyncEventSource(const String &url) : _url(url) {
+    sources()[url.c_str()] = this;
+}
+
+AsyncEventSource::~AsyncEventSource() {
+    auto it = sources().find(_url.c_str());
+    if (it != sources().end() && it->second == this) sources().erase(it);
+}
+
+AsyncEventSource* AsyncEventSource::hostInstance(const char *url) {
+    auto it = sources().find(url);
+    return it == sources().end() ? nullptr : it->second;
+}
+
+// wie generateEventMessage() der Bibliothek: Zeilen mit \r\n, Leerzeile am Ende
+String AsyncEventSource::format(const char *message, const char *event, uint32_t id, uint32_t reconnect) {
+    String text;
+    if (reconnect) text += "retry: " + String(reconnect) + "\r\n";
+    if (id) text += "id: " + String(id) + "\r\n";
+    if (event) text += "event: " + String(event) + "\r\n";
+    if (message) {
+        const char *line = message;
+        while (true) {
+            const char *end = strchr(line, '\n');
+            text += "data: ";
+            if (!end) {
+                text += line;
+                text += "\r\n";
+                break;
+            }
+            text.concat(line, end - line);
+            text += "\r\n";
+            line = end + 1;
+        }
+    }
+    return text + "\r\n";
+}
+
+void AsyncEventSource::send(const char *message, const char *event, uint32_t id, uint32_t reconnect) {
+    String text = format(message, event, id, reconnect);
+    _formatted++;
+    for (auto &c : _clients) c->write(text.c_str(), text.length());
+}
+
+void AsyncEventSource::close() {
+    for (auto &c : _clients) c->close();
+}
+
+size_t AsyncEventSource::count() const {
+    size_t n = 0;
+    for (const auto &c : _clients) n += c->connected();
+    return n;
+}
+
+AsyncEventSourceClient* AsyncEventSource::hostConnect(uint32_t lastEventId) {
+    // wie die Bibliothek: erst in die Liste, dann onConnect
+    _clients.emplace_back(new AsyncEventSourceClient(this, lastEventId));
+    AsyncEventSourceClient *client = _clients.back().get();
+    if (_connect) _connect(client);
+    return client;
+}
+
+void AsyncEventSource::hostDisconnect(AsyncEventSourceClient *client) {
+    for (size_t i = 0; i < _clients.size(); i++) {
+        if (_clients[i].get() == client) {
+            _clients.erase(_clients.begin() + i);
+            return;
+        }
+    }
+}
+
+size_t AsyncEventSource::hostDrainAll() {
+    size_t n = 0;
+    for (auto &c : _clients) n += c->hostDrain();
+    return n;
+}
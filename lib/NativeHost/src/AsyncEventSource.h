@@ -0,0 +1,75 @@
+#ifndef NATIVEHOST_ASYNCEVENTSOURCE_H
+#define NATIVEHOST_ASYNCEVENTSOURCE_H
+
+#include "ESPAsyncWebServer.h"
+
+//----------------------------------------------------------------------------
+// AsyncEventSource (Host)
+// Server-Sent Events wie in der Bibliothek: send() formatiert eine Nachricht
+// (retry/id/event/data) einmal und hängt sie an jeden Client. Clients werden
+// mit hostConnect() erzeugt – mit dem Last-Event-ID-Header, den ein Browser
+// beim Wiederverbinden schickt – und sammeln das Gesendete, bis es mit
+// hostDrain() abgeholt wird.
+//----------------------------------------------------------------------------
+class AsyncEventSource;
+
+class AsyncEventSourceClient {
+public:
+    AsyncEventSourceClient(AsyncEventSource *server, uint32_t lastId) : _server(server), _lastId(lastId) {}
+
+    void close() { _connected = false; }
+    void write(const char *message, size_t len);
+    void send(const char *message, const char *event = nullptr, uint32_t id = 0, uint32_t reconnect = 0);
+    bool connected() const { return _connected; }
+    uint32_t lastId() const { return _lastId; }
+    size_t packetsWaiting() const { return 0; }
+
+    // Host: bisher Empfangenes (Wire-Format) und Anzahl Nachrichten
+    const String& hostReceived() const { return _received; }
+    uint32_t hostMessages() const { return _messages; }
+    // Gesendetes abholen: Bytes seit dem letzten Aufruf
+    size_t hostDrain();
+
+private:
+    AsyncEventSource *_server;
+    uint32_t _lastId;
+    bool _connected = true;
+    String _received;
+    uint32_t _messages = 0;
+};
+
+typedef std::function<void(AsyncEventSourceClient *client)> ArEventHandlerFunction;
+
+class AsyncEventSource : public AsyncWebHandler {
+public:
+    explicit AsyncEventSource(const String &url);
+    ~AsyncEventSource();
+
+    const char* url() const { return _url.c_str(); }
+    void close();
+    void onConnect(ArEventHandlerFunction cb) { _connect = std::move(cb); }
+    void send(const char *message, const char *event = nullptr, uint32_t id = 0, uint32_t reconnect = 0);
+    size_t count() const;
+    size_t avgPacketsWaiting() const { return 0; }
+
+    // Stream läuft auf dem Host nicht über HTTP
+    bool canHandle(AsyncWebServerRequest *request) override { return false; }
+
+    // Host
+    AsyncEventSourceClient* hostConnect(uint32_t lastEventId = 0);
+    void hostDisconnect(AsyncEventSourceClient *client);
+    size_t hostDrainAll();
+    // Anzahl der in send() formatierten Nachrichten (einmal pro Aufruf, nicht pro Client)
+    uint32_t hostFormatted() const { return _formatted; }
+    static AsyncEventSource* hostInstance(const char *url);
+
+    static String format(const char *message, const char *event, uint32_t id, uint32_t reconnect);
+
+private:
+    String _url;
+    ArEventHandlerFunction _connect;
+    std::vector<std::unique_ptr<AsyncEventSourceClient>> _clients;
+    uint32_t _formatted = 0;
+};
+
+#endif
@@ -0,0 +1,4 @@
+#ifndef NATIVEHOST_ASYNCTCP_H
+#define NATIVEHOST_ASYNCTCP_H
+// Host: kein TCP, ESPAsyncWebServer.h bringt die Stand-ins selbst mit
+#endif
@@ -0,0 +1,40 @@
+#ifndef NATIVEHOST_EEPROM_H
+#define NATIVEHOST_EEPROM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+// EEPROM-Emulation (Host): RAM-Puffer, commit() wird nur gezählt
+class EEPROMClass {
+public:
+    bool begin(size_t size) {
+        if (_data.size() < size) _data.resize(size, 0xFF);
+        return true;
+    }
+    uint8_t read(int addr) const { return _data[addr]; }
+    void write(int addr, uint8_t value) { _data[addr] = value; }
+    template <typename T> T& get(int addr, T &value) const {
+        memcpy((void*)&value, &_data[addr], sizeof(T));
+        return value;
+    }
+    template <typename T> const T& put(int addr, const T &value) {
+        memcpy(&_data[addr], (const void*)&value, sizeof(T));
+        return value;
+    }
+    bool commit() { _commits++; return true; }
+    uint8_t* getDataPtr() { return _data.data(); }
+    size_t length() const { return _data.size(); }
+
+    // Host
+    uint32_t hostCommits() const { return _commits; }
+    void hostReset() { _data.clear(); _commits = 0; }
+
+private:
+    std::vector<uint8_t> _data;
+    uint32_t _commits = 0;
+};
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,404 @@
+#include "ESPAsyncWebServer.h"
+#include <algorithm>
+#include <map>
+#include <new>
+
+//----------------------------------------------------------------------------
+// Responses
+//----------------------------------------------------------------------------
+namespace {
+
+class BasicResponse : public AsyncWebServerResponse {
+public:
+    BasicResponse(int code, const String &contentType, const String &content)
+    : AsyncWebServerResponse(code, contentType), _content(content) {}
+    size_t fill(uint8_t *buffer, size_t maxLen) override {
+        size_t n = std::min(maxLen, (size_t)_content.length() - _pos);
+        memcpy(buffer, _content.c_str() + _pos, n);
+        _pos += n;
+        return n;
+    }
+private:
+    String _content;
+    size_t _pos = 0;
+};
+
+class ChunkedResponse : public AsyncWebServerResponse {
+public:
+    ChunkedResponse(const String &contentType, AwsResponseFiller filler)
+    : AsyncWebServerResponse(200, contentType), _filler(std::move(filler)) {}
+    size_t fill(uint8_t *buffer, size_t maxLen) override {
+        if (_done) return 0;
+        // wie AsyncChunkedResponse: Platz für "<len>\r\n" ... "\r\n" abziehen
+        size_t n = _filler(buffer, maxLen > 8 ? maxLen - 8 : maxLen, _index);
+        if (n == 0) _done = true;
+        _index += n;
+        return n;
+    }
+private:
+    AwsResponseFiller _filler;
+    size_t _index = 0;
+    bool _done = false;
+};
+
+class ProgmemResponse : public AsyncWebServerResponse {
+public:
+    ProgmemResponse(int code, const String &contentType, const uint8_t *content, size_t len)
+    : AsyncWebServerResponse(code, contentType), _content(content), _len(len) {}
+    size_t fill(uint8_t *buffer, size_t maxLen) override {
+        size_t n = std::min(maxLen, _len - _pos);
+        memcpy_P(buffer, _content + _pos, n);
+        _pos += n;
+        return n;
+    }
+private:
+    const uint8_t *_content;
+    size_t _len;
+    size_t _pos = 0;
+};
+
+class FileResponse : public AsyncWebServerResponse {
+public:
+    FileResponse(File file, const String &contentType)
+    : AsyncWebServerResponse(200, contentType), _file(file) {}
+    size_t fill(uint8_t *buffer, size_t maxLen) override { return _file.read(buffer, maxLen); }
+private:
+    File _file;
+};
+
+const String kEmpty;
+
+} // namespace
+
+const String* AsyncWebServerResponse::header(const char *name) const {
+    for (const auto &h : _headers) {
+        if (h.name() == name) return &h.value();
+    }
+    return nullptr;
+}
+
+const char* AsyncWebServerResponse::reason(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 302: return "Found";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 404: return "Not Found";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default:  return "";
+    }
+}
+
+// ohne String, damit Benchmarks keine Allokation dafür mitzählen
+size_t AsyncWebServerResponse::headerBytes() const {
+    size_t n = strlen("HTTP/1.1 200 \r\n") + strlen(reason(_code)) + strlen("\r\n");
+    if (_contentType.length()) n += strlen("Content-Type: \r\n") + _contentType.length();
+    for (const auto &h : _headers) n += h.name().length() + h.value().length() + 4;
+    return n;
+}
+
+String AsyncWebServerResponse::head() const {
+    String head = "HTTP/1.1 " + String(_code) + " " + reason(_code) + "\r\n";
+    if (_contentType.length()) head += "Content-Type: " + _contentType + "\r\n";
+    for (const auto &h : _headers) head += h.name() + ": " + h.value() + "\r\n";
+    return head + "\r\n";
+}
+
+//----------------------------------------------------------------------------
+// Request
+//----------------------------------------------------------------------------
+AsyncWebServerRequest::~AsyncWebServerRequest() {
+    // wie die Bibliothek: Callback vor dem Löschen der Antwort
+    if (_onDisconnect) _onDisconnect();
+    delete _response;
+}
+
+AsyncWebParameter* AsyncWebServerRequest::getParam(const String &name, bool post, bool file) const {
+    for (const auto &p : _params) {
+        if (p->name() == name && p->isPost() == post) return p.get();
+    }
+    return nullptr;
+}
+
+bool AsyncWebServerRequest::hasHeader(const String &name) const {
+    for (const auto &h : _headers) {
+        if (h.name() == name) return true;
+    }
+    return false;
+}
+
+const String& AsyncWebServerRequest::header(const char *name) const {
+    for (const auto &h : _headers) {
+        if (h.name() == name) return h.value();
+    }
+    return kEmpty;
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse *response) {
+    delete _response;
+    _response = response;
+}
+
+void AsyncWebServerRequest::send(int code, const String &contentType, const String &content) {
+    send(beginResponse(code, contentType, content));
+}
+
+void AsyncWebServerRequest::send(fs::FS &fs, const String &path, const String &contentType, bool download) {
+    AsyncWebServerResponse *response = beginResponse(fs, path, contentType, download);
+    send(response ? response : beginResponse(404));
+}
+
+void AsyncWebServerRequest::send_P(int code, const String &contentType, const uint8_t *content, size_t len) {
+    send(beginResponse_P(code, contentType, content, len));
+}
+
+void AsyncWebServerRequest::redirect(const String &url) {
+    AsyncWebServerResponse *response = beginResponse(302);
+    response->addHeader("Location", url);
+    send(response);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const String &contentType, const String &content) {
+    return new BasicResponse(code, contentType, content);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(fs::FS &fs, const String &path, const String &contentType, bool download) {
+    File file = fs.open(path, "r");
+    if (!file) return nullptr;
+    return new FileResponse(file, contentType);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginChunkedResponse(const String &contentType, AwsResponseFiller callback) {
+    return new ChunkedResponse(contentType, std::move(callback));
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse_P(int code, const String &contentType, const uint8_t *content, size_t len) {
+    return new ProgmemResponse(code, contentType, content, len);
+}
+
+AsyncWebServerRequest& AsyncWebServerRequest::hostParam(const String &name, const String &value, bool post) {
+    _params.emplace_back(new AsyncWebParameter(name, value, post));
+    return *this;
+}
+
+AsyncWebServerRequest& AsyncWebServerRequest::hostHeader(const String &name, const String &value) {
+    _headers.emplace_back(name, value);
+    return *this;
+}
+
+String AsyncWebServerRequest::hostBody(size_t chunk) {
+    String body;
+    if (!_response) return body;
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[chunk]);
+    while (size_t n = _response->fill(buffer.get(), chunk)) body.concat((const char*)buffer.get(), n);
+    return body;
+}
+
+size_t AsyncWebServerRequest::hostDrain(size_t chunk) {
+    if (!_response) return 0;
+    // Sendepuffer von AsyncTCP: einmal pro Verbindung, nicht pro Block
+    static uint8_t buffer[8192];
+    chunk = std::min(chunk, sizeof(buffer));
+    size_t total = 0;
+    while (size_t n = _response->fill(buffer, chunk)) total += n;
+    return total;
+}
+
+//----------------------------------------------------------------------------
+// Server
+//----------------------------------------------------------------------------
+static std::map<uint16_t, AsyncWebServer*>& servers() {
+    static std::map<uint16_t, AsyncWebServer*> map;
+    return map;
+}
+
+AsyncWebServer::AsyncWebServer(uint16_t port) : _port(port) {
+    servers()[port] = this;
+}
+
+AsyncWebServer::~AsyncWebServer() {
+    auto it = servers().find(_port);
+    if (it != servers().end() && it->second == this) servers().erase(it);
+}
+
+AsyncWebServer* AsyncWebServer::hostInstance(uint16_t port) {
+    auto it = servers().find(port);
+    return it == servers().end() ? nullptr : it->second;
+}
+
+AsyncCallbackWebHandler& AsyncWebServer::on(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction fn) {
+    _owned.emplace_back(new AsyncCallbackWebHandler(uri, method, std::move(fn)));
+    addHandler(_owned.back().get());
+    return *_owned.back();
+}
+
+void AsyncWebServer::hostHandle(AsyncWebServerRequest &request) {
+    for (AsyncWebHandler *handler : _handlers) {
+        if (handler->canHandle(&request)) {
+            handler->handleRequest(&request);
+            return;
+        }
+    }
+    if (_notFound) _notFound(&request);
+    else request.send(404);
+}
+
+//----------------------------------------------------------------------------
+// WebSocket
+//----------------------------------------------------------------------------
+AsyncWebSocketMessageBuffer::AsyncWebSocketMessageBuffer(size_t size)
+: _data(new (std::nothrow) uint8_t[size + 1]), _len(size) {
+    if (_data) _data[size] = 0;
+}
+
+AsyncWebSocketMessageBuffer::AsyncWebSocketMessageBuffer(const uint8_t *data, size_t size)
+: AsyncWebSocketMessageBuffer(size) {
+    if (_data) memcpy(_data, data, size);
+}
+
+AsyncWebSocketMessageBuffer::~AsyncWebSocketMessageBuffer() {
+    delete[] _data;
+}
+
+AsyncWebSocketClient::~AsyncWebSocketClient() {
+    clearQueue();
+}
+
+void AsyncWebSocketClient::enqueue(AsyncWebSocketMessageBuffer *buffer, bool binary) {
+    if (!buffer || _status != WS_CONNECTED || queueIsFull()) return;
+    buffer->acquire();
+    _queue.push_back({buffer, false, binary});
+}
+
+void AsyncWebSocketClient::enqueueCopy(const uint8_t *data, size_t len, bool binary) {
+    if (_status != WS_CONNECTED || queueIsFull()) return;
+    auto *buffer = new AsyncWebSocketMessageBuffer(data, len);
+    buffer->acquire();
+    _queue.push_back({buffer, true, binary});
+}
+
+size_t AsyncWebSocketClient::hostDrain(size_t max) {
+    if (_stalled) return 0;
+    size_t n = std::min(max, _queue.size());
+    for (size_t i = 0; i < n; i++) {
+        Queued &q = _queue[i];
+        _framesSent++;
+        size_t len = q.buffer->length();
+        _bytesSent += len;
+        _wireBytes += len + (len < 126 ? 2 : len < 65536 ? 4 : 10);
+        q.buffer->release();
+        if (q.owned) delete q.buffer;
+    }
+    _queue.erase(_queue.begin(), _queue.begin() + n);
+    return n;
+}
+
+size_t AsyncWebSocketClient::hostQueuedBytes() const {
+    size_t n = 0;
+    for (const Queued &q : _queue) {
+        if (q.owned) n += q.buffer->length();
+    }
+    return n;
+}
+
+void AsyncWebSocketClient::clearQueue() {
+    for (Queued &q : _queue) {
+        q.buffer->release();
+        if (q.owned) delete q.buffer;
+    }
+    _queue.clear();
+}
+
+static std::map<std::string, AsyncWebSocket*>& sockets() {
+    static std::map<std::string, AsyncWebSocket*> map;
+    return map;
+}
+
+AsyncWebSocket::AsyncWebSocket(const String &url) : _url(url) {
+    sockets()[url.c_str()] = this;
+}
+
+AsyncWebSocket::~AsyncWebSocket() {
+    auto it = sockets().find(_url.c_str());
+    if (it != sockets().end() && it->second == this) sockets().erase(it);
+}
+
+AsyncWebSocket* AsyncWebSocket::hostInstance(const char *url) {
+    auto it = sockets().find(url);
+    return it == sockets().end() ? nullptr : it->second;
+}
+
+size_t AsyncWebSocket::count() const {
+    size_t n = 0;
+    for (const auto &c : _clients) {
+        if (c->status() == WS_CONNECTED) n++;
+    }
+    return n;
+}
+
+// wie die Bibliothek: nur verbundene Clients
+AsyncWebSocketClient* AsyncWebSocket::client(uint32_t id) {
+    for (const auto &c : _clients) {
+        if (c->id() == id && c->status() == WS_CONNECTED) return c.get();
+    }
+    return nullptr;
+}
+
+void AsyncWebSocket::remove(size_t index) {
+    AsyncWebSocketClient *client = _clients[index].get();
+    if (_handler) _handler(this, client, WS_EVT_DISCONNECT, nullptr, nullptr, 0);
+    _clients.erase(_clients.begin() + index);
+    _view.erase(_view.begin() + index);
+}
+
+// Wie die Bibliothek: getrennte Clients entfernen, bei zu vielen den ältesten schließen
+void AsyncWebSocket::cleanupClients(uint16_t maxClients) {
+    for (size_t i = 0; i < _clients.size();) {
+        if (_clients[i]->status() != WS_CONNECTED) remove(i);
+        else i++;
+    }
+    if (count() > maxClients && !_clients.empty()) _clients.front()->close();
+}
+
+void AsyncWebSocket::textAll(const char *message) {
+    for (auto &c : _clients) c->text(message);
+}
+
+AsyncWebSocketClient* AsyncWebSocket::hostConnect(AsyncWebServerRequest *request) {
+    _clients.emplace_back(new AsyncWebSocketClient(this, _nextId++));
+    _view.push_back(_clients.back().get());
+    AsyncWebSocketClient *client = _clients.back().get();
+    if (_handler) _handler(this, client, WS_EVT_CONNECT, request, nullptr, 0);
+    return client;
+}
+
+void AsyncWebSocket::hostReceive(AsyncWebSocketClient *client, const AwsFrameInfo &info, const uint8_t *data, size_t len) {
+    if (_handler) _handler(this, client, WS_EVT_DATA, (void*)&info, (uint8_t*)data, len);
+}
+
+void AsyncWebSocket::hostReceive(AsyncWebSocketClient *client, uint8_t opcode, const uint8_t *data, size_t len) {
+    AwsFrameInfo info = {};
+    info.message_opcode = opcode;
+    info.opcode = opcode;
+    info.final = 1;
+    info.len = len;
+    hostReceive(client, info, data, len);
+}
+
+void AsyncWebSocket::hostDisconnect(AsyncWebSocketClient *client) {
+    for (size_t i = 0; i < _clients.size(); i++) {
+        if (_clients[i].get() == client) {
+            remove(i);
+            return;
+        }
+    }
+}
+
+size_t AsyncWebSocket::hostDrainAll(size_t maxPerClient) {
+    size_t n = 0;
+    for (auto &c : _clients) n += c->hostDrain(maxPerClient);
+    return n;
+}
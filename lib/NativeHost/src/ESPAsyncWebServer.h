@@ -0,0 +1,325 @@
+#ifndef NATIVEHOST_ESPASYNCWEBSERVER_H
+#define NATIVEHOST_ESPASYNCWEBSERVER_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Arduino.h"
+#include "FS.h"
+
+//----------------------------------------------------------------------------
+// ESPAsyncWebServer (Host)
+// Gleiche Typen und Aufrufe wie die Bibliothek, ohne TCP. Requests werden mit
+// AsyncWebServer::hostHandle() durch dieselbe Handler-Kette geschickt wie auf
+// dem Gerät; die Antwort bleibt am Request hängen und wird mit hostBody() in
+// Blöcken der Größe eines TCP-Segments abgeholt. WebSocket-Clients und
+// -Frames werden mit AsyncWebSocket::hostConnect()/hostReceive() erzeugt.
+// Über echte Sockets: NativeHost::HttpListener (HttpListener.h).
+//----------------------------------------------------------------------------
+
+typedef enum {
+    HTTP_GET     = 0b00000001,
+    HTTP_POST    = 0b00000010,
+    HTTP_DELETE  = 0b00000100,
+    HTTP_PUT     = 0b00001000,
+    HTTP_PATCH   = 0b00010000,
+    HTTP_HEAD    = 0b00100000,
+    HTTP_OPTIONS = 0b01000000,
+    HTTP_ANY     = 0b01111111,
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+class AsyncWebServerRequest;
+class AsyncWebServerResponse;
+class AsyncWebSocket;
+class AsyncWebSocketClient;
+
+typedef std::function<void(AsyncWebServerRequest *request)> ArRequestHandlerFunction;
+typedef std::function<void(void)> ArDisconnectHandler;
+typedef std::function<size_t(uint8_t *buffer, size_t maxLen, size_t index)> AwsResponseFiller;
+
+class AsyncWebParameter {
+public:
+    AsyncWebParameter(const String &name, const String &value, bool post)
+    : _name(name), _value(value), _post(post) {}
+    const String& name() const { return _name; }
+    const String& value() const { return _value; }
+    bool isPost() const { return _post; }
+    bool isFile() const { return false; }
+private:
+    String _name;
+    String _value;
+    bool _post;
+};
+
+class AsyncWebHeader {
+public:
+    AsyncWebHeader(const String &name, const String &value) : _name(name), _value(value) {}
+    const String& name() const { return _name; }
+    const String& value() const { return _value; }
+private:
+    String _name;
+    String _value;
+};
+
+class AsyncWebServerResponse {
+public:
+    explicit AsyncWebServerResponse(int code, const String &contentType = String())
+    : _code(code), _contentType(contentType) {}
+    virtual ~AsyncWebServerResponse() = default;
+
+    void addHeader(const String &name, const String &value) { _headers.emplace_back(name, value); }
+    void setCode(int code) { _code = code; }
+
+    // Host
+    int code() const { return _code; }
+    const String& contentType() const { return _contentType; }
+    const String* header(const char *name) const;
+    // Statuszeile + Header, wie sie auf der Leitung stünden
+    size_t headerBytes() const;
+    String head() const;
+    static const char* reason(int code);
+    // Nächsten Block des Bodys; 0 = Ende
+    virtual size_t fill(uint8_t *buffer, size_t maxLen) = 0;
+
+protected:
+    int _code;
+    String _contentType;
+    std::vector<AsyncWebHeader> _headers;
+};
+
+class AsyncWebServerRequest {
+public:
+    // Host: Request ohne Verbindung
+    AsyncWebServerRequest(WebRequestMethod method, const String &url) : _method(method), _url(url) {}
+    ~AsyncWebServerRequest();
+
+    WebRequestMethodComposite method() const { return _method; }
+    const String& url() const { return _url; }
+
+    bool hasParam(const String &name, bool post = false, bool file = false) const { return getParam(name, post, file) != nullptr; }
+    AsyncWebParameter* getParam(const String &name, bool post = false, bool file = false) const;
+    bool hasHeader(const String &name) const;
+    const String& header(const char *name) const;
+    void addInterestingHeader(const String &name) {}
+    // Host: beim Zerstören des Requests, die Antwort ist dann abgeholt
+    void onDisconnect(ArDisconnectHandler fn) { _onDisconnect = std::move(fn); }
+
+    void send(AsyncWebServerResponse *response);
+    void send(int code, const String &contentType = String(), const String &content = String());
+    void send(fs::FS &fs, const String &path, const String &contentType = String(), bool download = false);
+    void send_P(int code, const String &contentType, const uint8_t *content, size_t len);
+    void redirect(const String &url);
+
+    AsyncWebServerResponse* beginResponse(int code, const String &contentType = String(), const String &content = String());
+    AsyncWebServerResponse* beginResponse(fs::FS &fs, const String &path, const String &contentType = String(), bool download = false);
+    AsyncWebServerResponse* beginChunkedResponse(const String &contentType, AwsResponseFiller callback);
+    // content wird nicht kopiert (PROGMEM bzw. eingeblendeter Flash), Länge bekannt
+    AsyncWebServerResponse* beginResponse_P(int code, const String &contentType, const uint8_t *content, size_t len);
+
+    // Host
+    AsyncWebServerRequest& hostParam(const String &name, const String &value, bool post = false);
+    AsyncWebServerRequest& hostHeader(const String &name, const String &value);
+    AsyncWebServerResponse* hostResponse() const { return _response; }
+    // Holt den Body in Blöcken von chunk Bytes ab (AsyncTCP: ein Segment)
+    String hostBody(size_t chunk = 1436);
+    // Summe der Body-Bytes ohne sie aufzuheben, für Benchmarks
+    size_t hostDrain(size_t chunk = 1436);
+
+private:
+    WebRequestMethod _method;
+    String _url;
+    std::vector<std::unique_ptr<AsyncWebParameter>> _params;
+    std::vector<AsyncWebHeader> _headers;
+    AsyncWebServerResponse *_response = nullptr;
+    ArDisconnectHandler _onDisconnect;
+};
+
+class AsyncWebHandler {
+public:
+    virtual ~AsyncWebHandler() = default;
+    virtual bool canHandle(AsyncWebServerRequest *request) { return false; }
+    virtual void handleRequest(AsyncWebServerRequest *request) {}
+    virtual bool isRequestHandlerTrivial() { return true; }
+};
+
+class AsyncCallbackWebHandler : public AsyncWebHandler {
+public:
+    AsyncCallbackWebHandler(const String &uri, WebRequestMethodComposite method, ArRequestHandlerFunction fn)
+    : _uri(uri), _method(method), _fn(std::move(fn)) {}
+    // Wie die Bibliothek: exakter Pfad oder Unterpfad "uri/..."
+    bool canHandle(AsyncWebServerRequest *request) override {
+        if (!_fn || !(_method & request->method())) return false;
+        return _uri == request->url() || request->url().startsWith(_uri + "/");
+    }
+    void handleRequest(AsyncWebServerRequest *request) override { _fn(request); }
+private:
+    String _uri;
+    WebRequestMethodComposite _method;
+    ArRequestHandlerFunction _fn;
+};
+
+class AsyncWebServer {
+public:
+    explicit AsyncWebServer(uint16_t port);
+    ~AsyncWebServer();
+
+    void begin() { _running = true; }
+    void end() { _running = false; }
+    AsyncCallbackWebHandler& on(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction fn);
+    AsyncCallbackWebHandler& on(const char *uri, ArRequestHandlerFunction fn) { return on(uri, HTTP_ANY, std::move(fn)); }
+    AsyncWebHandler& addHandler(AsyncWebHandler *handler) { _handlers.push_back(handler); return *handler; }
+    void onNotFound(ArRequestHandlerFunction fn) { _notFound = std::move(fn); }
+
+    // Host: Request wie der Server verteilen (erster Handler mit canHandle())
+    void hostHandle(AsyncWebServerRequest &request);
+    size_t hostHandlerCount() const { return _handlers.size(); }
+    // zuletzt erzeugter Server mit diesem Port (WebServerClass hält ihn privat)
+    static AsyncWebServer* hostInstance(uint16_t port);
+
+private:
+    uint16_t _port;
+    bool _running = false;
+    std::vector<AsyncWebHandler*> _handlers;
+    std::vector<std::unique_ptr<AsyncCallbackWebHandler>> _owned;
+    ArRequestHandlerFunction _notFound;
+};
+
+//----------------------------------------------------------------------------
+// WebSocket
+//----------------------------------------------------------------------------
+#define WS_MAX_QUEUED_MESSAGES 32
+#define DEFAULT_MAX_WS_CLIENTS 8
+
+typedef enum { WS_CONTINUATION = 0, WS_TEXT = 1, WS_BINARY = 2, WS_DISCONNECT = 8, WS_PING = 9, WS_PONG = 10 } AwsFrameType;
+typedef enum { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA } AwsEventType;
+typedef enum { WS_DISCONNECTED, WS_CONNECTED, WS_DISCONNECTING } AwsClientStatus;
+
+typedef struct {
+    uint8_t  message_opcode;
+    uint32_t num;
+    uint8_t  final;
+    uint8_t  masked;
+    uint8_t  opcode;
+    uint64_t len;
+    uint8_t  mask[4];
+    uint64_t index;
+} AwsFrameInfo;
+
+typedef std::function<void(AsyncWebSocket *server, AsyncWebSocketClient *client,
+                           AwsEventType type, void *arg, uint8_t *data, size_t len)> AwsEventHandler;
+
+class AsyncWebSocketMessageBuffer {
+public:
+    explicit AsyncWebSocketMessageBuffer(size_t size);
+    AsyncWebSocketMessageBuffer(const uint8_t *data, size_t size);
+    ~AsyncWebSocketMessageBuffer();
+
+    uint8_t* get() { return _data; }
+    size_t length() const { return _len; }
+    void lock() { _lock = true; }
+    void unlock() { _lock = false; }
+    bool canDelete() const { return _count == 0 && !_lock; }
+
+    // von den Client-Queues gezählt
+    void acquire() { _count++; }
+    void release() { if (_count) _count--; }
+
+private:
+    uint8_t *_data;
+    size_t _len;
+    bool _lock = false;
+    uint32_t _count = 0;
+};
+
+class AsyncWebSocketClient {
+public:
+    AsyncWebSocketClient(AsyncWebSocket *server, uint32_t id) : _server(server), _id(id) {}
+    ~AsyncWebSocketClient();
+
+    uint32_t id() const { return _id; }
+    AwsClientStatus status() const { return _status; }
+    size_t queueLen() const { return _queue.size(); }
+    bool queueIsFull() const { return _queue.size() >= WS_MAX_QUEUED_MESSAGES; }
+    void close(uint16_t code = 0, const char *message = nullptr) { if (_status == WS_CONNECTED) _status = WS_DISCONNECTING; }
+
+    void text(AsyncWebSocketMessageBuffer *buffer) { enqueue(buffer, false); }
+    void binary(AsyncWebSocketMessageBuffer *buffer) { enqueue(buffer, true); }
+    void text(const char *message) { enqueueCopy((const uint8_t*)message, strlen(message), false); }
+    void text(const String &message) { text(message.c_str()); }
+    void binary(const uint8_t *data, size_t len) { enqueueCopy(data, len, true); }
+
+    void *_tempObject = nullptr;
+
+    // Host: Client liest nicht mehr (Queue wächst)
+    void hostStall(bool stalled) { _stalled = stalled; }
+    // Sendet bis zu max Frames aus der Queue (gestaute Clients nichts)
+    size_t hostDrain(size_t max = (size_t)-1);
+    uint32_t hostFramesSent() const { return _framesSent; }
+    uint64_t hostBytesSent() const { return _bytesSent; }
+    // wie hostBytesSent(), plus Frame-Header (RFC 6455, Server -> Client unmaskiert)
+    uint64_t hostWireBytes() const { return _wireBytes; }
+    // Bytes in der Queue, die nur diesem Client gehören (Kopien)
+    size_t hostQueuedBytes() const;
+
+private:
+    friend class AsyncWebSocket;
+    struct Queued {
+        AsyncWebSocketMessageBuffer *buffer;
+        bool owned;         // Kopie aus text(const char*), sonst geteilter Puffer
+        bool binary;
+    };
+    void enqueue(AsyncWebSocketMessageBuffer *buffer, bool binary);
+    void enqueueCopy(const uint8_t *data, size_t len, bool binary);
+    void clearQueue();
+
+    AsyncWebSocket *_server;
+    uint32_t _id;
+    AwsClientStatus _status = WS_CONNECTED;
+    bool _stalled = false;
+    std::vector<Queued> _queue;
+    uint32_t _framesSent = 0;
+    uint64_t _bytesSent = 0;
+    uint64_t _wireBytes = 0;
+};
+
+class AsyncWebSocket : public AsyncWebHandler {
+public:
+    explicit AsyncWebSocket(const String &url);
+    ~AsyncWebSocket();
+
+    const char* url() const { return _url.c_str(); }
+    void onEvent(AwsEventHandler handler) { _handler = std::move(handler); }
+    const std::vector<AsyncWebSocketClient*>& getClients() const { return _view; }
+    size_t count() const;
+    AsyncWebSocketClient* client(uint32_t id);
+    void cleanupClients(uint16_t maxClients = DEFAULT_MAX_WS_CLIENTS);
+    void textAll(const char *message);
+    void textAll(const String &message) { textAll(message.c_str()); }
+
+    // Upgrade läuft auf dem Host nicht über HTTP
+    bool canHandle(AsyncWebServerRequest *request) override { return false; }
+
+    // Host
+    AsyncWebSocketClient* hostConnect(AsyncWebServerRequest *request = nullptr);
+    void hostReceive(AsyncWebSocketClient *client, const AwsFrameInfo &info, const uint8_t *data, size_t len);
+    // Ganze Nachricht als ein Frame in einem Event
+    void hostReceive(AsyncWebSocketClient *client, uint8_t opcode, const uint8_t *data, size_t len);
+    void hostDisconnect(AsyncWebSocketClient *client);
+    size_t hostDrainAll(size_t maxPerClient = (size_t)-1);
+    static AsyncWebSocket* hostInstance(const char *url);
+
+private:
+    void remove(size_t index);
+
+    String _url;
+    AwsEventHandler _handler;
+    std::vector<std::unique_ptr<AsyncWebSocketClient>> _clients;
+    std::vector<AsyncWebSocketClient*> _view;
+    uint32_t _nextId = 1;
+};
+
+// wie die Bibliothek: Server-Sent Events über denselben Header
+#include "AsyncEventSource.h"
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef NATIVEHOST_ELEGANTOTA_H
+#define NATIVEHOST_ELEGANTOTA_H
+
+#include "ESPAsyncWebServer.h"
+
+// Host: OTA gibt es nicht, begin() registriert nichts
+class ElegantOTAClass {
+public:
+    void begin(AsyncWebServer *server, const char *username = "", const char *password = "") {}
+    void loop() {}
+};
+inline ElegantOTAClass ElegantOTA;
+
+#endif
@@ -0,0 +1,65 @@
+#include "FS.h"
+#include "SPIFFS.h"
+#include <algorithm>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <sstream>
+
+SPIFFSFS SPIFFS;
+
+namespace fs {
+
+size_t File::read(uint8_t *buf, size_t len) {
+    if (!_data || _pos >= _data->size()) return 0;
+    size_t n = std::min(len, _data->size() - _pos);
+    memcpy(buf, _data->data() + _pos, n);
+    _pos += n;
+    if (_stats) _stats->bytesRead += n;
+    return n;
+}
+
+File FS::open(const char *path, const char *mode, bool create) {
+    if (mode && mode[0] == 'w') {
+        // Schreiben wird nicht gebraucht: leere Datei anlegen
+        hostPut(path, std::string());
+    }
+    auto it = _files.find(path);
+    if (it == _files.end()) return File();
+    _stats.opens++;
+    return File(path, it->second, &_stats);
+}
+
+void FS::hostPut(const char *path, std::string content) {
+    _files[path] = std::make_shared<const std::string>(std::move(content));
+}
+
+static size_t loadDir(FS &fs, const std::string &root, const std::string &rel) {
+    DIR *dir = opendir((root + rel).c_str());
+    if (!dir) return 0;
+    size_t count = 0;
+    while (dirent *e = readdir(dir)) {
+        std::string name = e->d_name;
+        if (name == "." || name == "..") continue;
+        std::string sub = rel + "/" + name;
+        struct stat st;
+        if (stat((root + sub).c_str(), &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            count += loadDir(fs, root, sub);
+        } else {
+            std::ifstream in(root + sub, std::ios::binary);
+            std::ostringstream data;
+            data << in.rdbuf();
+            fs.hostPut(sub.c_str(), data.str());
+            count++;
+        }
+    }
+    closedir(dir);
+    return count;
+}
+
+size_t FS::hostLoadDir(const char *dir) {
+    return loadDir(*this, dir, "");
+}
+
+} // namespace fs
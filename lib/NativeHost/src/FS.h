@@ -0,0 +1,89 @@
+#ifndef NATIVEHOST_FS_H
+#define NATIVEHOST_FS_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include "WString.h"
+
+#define FILE_READ  "r"
+#define FILE_WRITE "w"
+
+//----------------------------------------------------------------------------
+// Dateisystem (Host)
+// Dateien liegen im RAM. Tests legen sie mit hostPut() an oder spiegeln ein
+// Verzeichnis (z.B. .pio/data mit den .gz-Varianten) mit hostLoadDir().
+//----------------------------------------------------------------------------
+namespace fs {
+
+struct HostStats {
+    uint32_t opens = 0;
+    uint64_t bytesRead = 0;
+};
+
+class File {
+public:
+    File() = default;
+    File(String path, std::shared_ptr<const std::string> data, HostStats *stats)
+    : _path(std::move(path)), _data(std::move(data)), _stats(stats) {}
+
+    explicit operator bool() const { return _data != nullptr; }
+    size_t size() const { return _data ? _data->size() : 0; }
+    size_t position() const { return _pos; }
+    int available() const { return (int)(size() - _pos); }
+    bool seek(size_t pos) {
+        if (!_data || pos > _data->size()) return false;
+        _pos = pos;
+        return true;
+    }
+    size_t read(uint8_t *buf, size_t len);
+    int read() {
+        uint8_t c;
+        return read(&c, 1) ? c : -1;
+    }
+    String readString() {
+        if (!_data) return String();
+        String s(_data->c_str() + _pos, _data->size() - _pos);
+        if (_stats) _stats->bytesRead += s.length();
+        _pos = size();
+        return s;
+    }
+    const char* name() const { return _path.c_str(); }
+    const char* path() const { return _path.c_str(); }
+    bool isDirectory() const { return false; }
+    File openNextFile() { return File(); }
+    void close() { _data.reset(); _pos = 0; }
+
+private:
+    String _path;
+    std::shared_ptr<const std::string> _data;
+    HostStats *_stats = nullptr;
+    size_t _pos = 0;
+};
+
+class FS {
+public:
+    File open(const char *path, const char *mode = FILE_READ, bool create = false);
+    File open(const String &path, const char *mode = FILE_READ, bool create = false) {
+        return open(path.c_str(), mode, create);
+    }
+    bool exists(const char *path) const { return _files.count(path) != 0; }
+    bool exists(const String &path) const { return exists(path.c_str()); }
+
+    // Host-Erweiterungen
+    void hostPut(const char *path, std::string content);
+    size_t hostLoadDir(const char *dir);   // Anzahl übernommener Dateien
+    void hostClear() { _files.clear(); }
+    HostStats& hostStats() { return _stats; }
+
+private:
+    std::map<std::string, std::shared_ptr<const std::string>> _files;
+    HostStats _stats;
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+
+#endif
@@ -0,0 +1,259 @@
+#include "HttpListener.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace NativeHost {
+
+static void setNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// application/x-www-form-urlencoded
+static String urlDecode(const char *s, size_t len) {
+    std::string out;
+    out.reserve(len);
+    for (size_t i = 0; i < len; i++) {
+        if (s[i] == '+') {
+            out += ' ';
+        } else if (s[i] == '%' && i + 2 < len && hexValue(s[i + 1]) >= 0 && hexValue(s[i + 2]) >= 0) {
+            out += (char)(hexValue(s[i + 1]) * 16 + hexValue(s[i + 2]));
+            i += 2;
+        } else {
+            out += s[i];
+        }
+    }
+    return String(out.c_str());
+}
+
+static void parseParams(AsyncWebServerRequest &request, const char *s, size_t len, bool post) {
+    size_t pos = 0;
+    while (pos < len) {
+        const char *amp = (const char*)memchr(s + pos, '&', len - pos);
+        size_t end = amp ? (size_t)(amp - s) : len;
+        const char *eq = (const char*)memchr(s + pos, '=', end - pos);
+        if (end > pos) {
+            size_t nameEnd = eq ? (size_t)(eq - s) : end;
+            size_t valueStart = eq ? nameEnd + 1 : end;
+            request.hostParam(urlDecode(s + pos, nameEnd - pos), urlDecode(s + valueStart, end - valueStart), post);
+        }
+        pos = end + 1;
+    }
+}
+
+static bool parseMethod(const std::string &name, WebRequestMethod &method) {
+    static const struct { const char *name; WebRequestMethod method; } kMethods[] = {
+        {"GET", HTTP_GET}, {"POST", HTTP_POST}, {"DELETE", HTTP_DELETE}, {"PUT", HTTP_PUT},
+        {"PATCH", HTTP_PATCH}, {"HEAD", HTTP_HEAD}, {"OPTIONS", HTTP_OPTIONS},
+    };
+    for (const auto &m : kMethods) {
+        if (name == m.name) {
+            method = m.method;
+            return true;
+        }
+    }
+    return false;
+}
+
+static size_t contentLength(const std::string &head) {
+    // Groß-/Kleinschreibung von Headernamen ist egal
+    size_t pos = 0;
+    while ((pos = head.find("\r\n", pos)) != std::string::npos) {
+        pos += 2;
+        if (strncasecmp(head.c_str() + pos, "Content-Length:", 15) == 0) {
+            return strtoul(head.c_str() + pos + 15, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+HttpListener::HttpListener(AsyncWebServer &server, size_t maxConnections)
+: _server(server), _maxConnections(maxConnections) {}
+
+HttpListener::~HttpListener() {
+    end();
+}
+
+bool HttpListener::begin(uint16_t port) {
+    _fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (_fd < 0) return false;
+    int one = 1;
+    setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    socklen_t addrLen = sizeof(addr);
+    if (bind(_fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(_fd, 128) < 0
+        || getsockname(_fd, (sockaddr*)&addr, &addrLen) < 0) {
+        end();
+        return false;
+    }
+    setNonBlocking(_fd);
+    _port = ntohs(addr.sin_port);
+    return true;
+}
+
+void HttpListener::end() {
+    while (!_connections.empty()) close(_connections.size() - 1);
+    if (_fd >= 0) ::close(_fd);
+    _fd = -1;
+    _port = 0;
+}
+
+void HttpListener::poll(int timeoutMs) {
+    if (_fd < 0) return;
+    std::vector<pollfd> fds;
+    fds.reserve(_connections.size() + 1);
+    fds.push_back({_fd, POLLIN, 0});
+    for (const auto &c : _connections) {
+        fds.push_back({c->fd, (short)(c->request ? POLLOUT : POLLIN), 0});
+    }
+    if (::poll(fds.data(), fds.size(), timeoutMs) <= 0) return;
+
+    // rückwärts, damit close() die noch ausstehenden Indizes nicht verschiebt
+    for (size_t i = _connections.size(); i-- > 0;) {
+        short events = fds[i + 1].revents;
+        if (!events) continue;
+        Connection &c = *_connections[i];
+        bool keep = (events & (POLLERR | POLLNVAL)) == 0;
+        if (keep && (events & (POLLIN | POLLHUP)) && !c.request) keep = receive(c);
+        if (keep && (events & POLLOUT) && c.request) keep = transmit(c);
+        if (!keep) close(i);
+    }
+    if (fds[0].revents & POLLIN) accept();
+}
+
+void HttpListener::accept() {
+    for (;;) {
+        int fd = ::accept(_fd, nullptr, nullptr);
+        if (fd < 0) return;
+        if (_connections.size() >= _maxConnections) {
+            // kein freier PCB mehr: Gerät antwortet mit RST
+            linger hard = {1, 0};
+            setsockopt(fd, SOL_SOCKET, SO_LINGER, &hard, sizeof(hard));
+            ::close(fd);
+            _stats.refused++;
+            continue;
+        }
+        setNonBlocking(fd);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        _connections.emplace_back(new Connection{fd});
+        _stats.accepted++;
+        _stats.open = _connections.size();
+        if (_stats.open > _stats.peakOpen) _stats.peakOpen = _stats.open;
+    }
+}
+
+// false = Verbindung schließen
+bool HttpListener::receive(Connection &c) {
+    char buffer[kSegment];
+    for (;;) {
+        ssize_t n = recv(c.fd, buffer, sizeof(buffer), 0);
+        if (n == 0) return false;
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            break;
+        }
+        c.in.append(buffer, n);
+    }
+
+    size_t headEnd = c.in.find("\r\n\r\n");
+    if (headEnd == std::string::npos) {
+        if (c.in.size() <= kMaxHead) return true;
+        _stats.badRequests++;
+        return false;
+    }
+    size_t bodyLen = contentLength(c.in.substr(0, headEnd + 2));
+    if (c.in.size() < headEnd + 4 + bodyLen) return true;
+    return dispatch(c, headEnd, bodyLen);
+}
+
+bool HttpListener::dispatch(Connection &c, size_t headEnd, size_t bodyLen) {
+    const char *head = c.in.c_str();
+    const char *lineEnd = strstr(head, "\r\n");
+    const char *sp1 = (const char*)memchr(head, ' ', lineEnd - head);
+    const char *sp2 = sp1 ? (const char*)memchr(sp1 + 1, ' ', lineEnd - sp1 - 1) : nullptr;
+    WebRequestMethod method;
+    if (!sp2 || !parseMethod(std::string(head, sp1 - head), method)) {
+        _stats.badRequests++;
+        return false;
+    }
+
+    const char *query = (const char*)memchr(sp1 + 1, '?', sp2 - sp1 - 1);
+    const char *pathEnd = query ? query : sp2;
+    c.request.reset(new AsyncWebServerRequest(method, urlDecode(sp1 + 1, pathEnd - sp1 - 1)));
+    if (query) parseParams(*c.request, query + 1, sp2 - query - 1, false);
+
+    bool form = false;
+    const char *line = lineEnd + 2;
+    const char *end = head + headEnd + 2;
+    while (line < end) {
+        const char *next = strstr(line, "\r\n");
+        const char *colon = (const char*)memchr(line, ':', next - line);
+        if (colon) {
+            const char *value = colon + 1;
+            while (value < next && *value == ' ') value++;
+            String name(std::string(line, colon - line).c_str());
+            String text(std::string(value, next - value).c_str());
+            if (name.equalsIgnoreCase("Content-Type")) form = text.startsWith("application/x-www-form-urlencoded");
+            c.request->hostHeader(name, text);
+        }
+        line = next + 2;
+    }
+    if (form) parseParams(*c.request, head + headEnd + 4, bodyLen, true);
+    c.in.clear();
+
+    _server.hostHandle(*c.request);
+    // auf dem Gerät bliebe der Request bis zum Timeout offen
+    if (!c.request->hostResponse()) c.request->send(500);
+    _stats.requests++;
+    return true;
+}
+
+bool HttpListener::transmit(Connection &c) {
+    uint8_t buffer[kSegment];
+    for (;;) {
+        if (c.outPos == c.out.size()) {
+            c.out.clear();
+            c.outPos = 0;
+            AsyncWebServerResponse *response = c.request->hostResponse();
+            if (!c.headSent) {
+                String head = response->head();
+                // Header sind fertig bis auf die Leerzeile am Ende
+                c.out.assign(head.c_str(), head.length() - 2);
+                c.out += "Connection: close\r\n\r\n";
+                c.headSent = true;
+            } else {
+                size_t n = response->fill(buffer, sizeof(buffer));
+                if (n == 0) return false;   // fertig, Verbindung schließen
+                c.out.assign((const char*)buffer, n);
+            }
+        }
+        ssize_t n = send(c.fd, c.out.data() + c.outPos, c.out.size() - c.outPos, MSG_NOSIGNAL);
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+        c.outPos += n;
+    }
+}
+
+void HttpListener::close(size_t index) {
+    ::close(_connections[index]->fd);
+    _connections.erase(_connections.begin() + index);
+    _stats.open = _connections.size();
+}
+
+} // namespace NativeHost
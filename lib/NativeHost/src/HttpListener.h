@@ -0,0 +1,78 @@
+#ifndef NATIVEHOST_HTTPLISTENER_H
+#define NATIVEHOST_HTTPLISTENER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "ESPAsyncWebServer.h"
+
+//----------------------------------------------------------------------------
+// HttpListener (Host)
+// Echter TCP-Server auf 127.0.0.1 vor einem AsyncWebServer: nimmt
+// Verbindungen mit POSIX-Sockets an, zerlegt HTTP/1.1-Requests (Query- und
+// Formularparameter, Header) und schickt sie mit hostHandle() durch die
+// Handler-Kette. Die Antwort wird wie von AsyncTCP in Segmenten zu kSegment
+// Bytes mit fill() abgeholt; danach wird die Verbindung geschlossen
+// ("Connection: close" wie bei ESPAsyncWebServer).
+//
+// Alles läuft in dem Thread, der poll() aufruft, so wie auf dem Gerät alle
+// Handler im AsyncTCP-Task laufen. Mehr als maxConnections gleichzeitige
+// Verbindungen werden sofort wieder geschlossen (lwIP: MAX_ACTIVE_TCP).
+//----------------------------------------------------------------------------
+namespace NativeHost {
+
+class HttpListener {
+public:
+    static constexpr size_t kMaxConnections = 16;   // CONFIG_LWIP_MAX_ACTIVE_TCP
+    static constexpr size_t kSegment = 1436;        // TCP_MSS
+    static constexpr size_t kMaxHead = 4096;        // größere Header: 400
+
+    struct Stats {
+        uint32_t accepted = 0;
+        uint32_t refused = 0;       // über maxConnections
+        uint32_t requests = 0;
+        uint32_t badRequests = 0;
+        size_t   open = 0;
+        size_t   peakOpen = 0;
+    };
+
+    explicit HttpListener(AsyncWebServer &server, size_t maxConnections = kMaxConnections);
+    ~HttpListener();
+
+    // port 0 = freier Port, siehe port()
+    bool begin(uint16_t port = 0);
+    void end();
+    uint16_t port() const { return _port; }
+
+    // Sockets einmal bedienen, wartet höchstens timeoutMs auf Aktivität
+    void poll(int timeoutMs = 0);
+
+    const Stats& stats() const { return _stats; }
+
+private:
+    struct Connection {
+        int fd;
+        std::string in;
+        std::unique_ptr<AsyncWebServerRequest> request;
+        std::string out;
+        size_t outPos = 0;
+        bool headSent = false;
+    };
+
+    void accept();
+    bool receive(Connection &c);
+    bool transmit(Connection &c);
+    bool dispatch(Connection &c, size_t headEnd, size_t bodyLen);
+    void close(size_t index);
+
+    AsyncWebServer &_server;
+    size_t _maxConnections;
+    int _fd = -1;
+    uint16_t _port = 0;
+    std::vector<std::unique_ptr<Connection>> _connections;
+    Stats _stats;
+};
+
+} // namespace NativeHost
+
+#endif
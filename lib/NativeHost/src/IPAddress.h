@@ -0,0 +1,41 @@
+#ifndef NATIVEHOST_IPADDRESS_H
+#define NATIVEHOST_IPADDRESS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "WString.h"
+
+class IPAddress {
+public:
+    IPAddress() = default;
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _b{a, b, c, d} {}
+    explicit IPAddress(uint32_t v) { memcpy(_b, &v, 4); }
+
+    uint8_t operator[](int i) const { return _b[i]; }
+    uint8_t& operator[](int i) { return _b[i]; }
+    operator uint32_t() const { uint32_t v; memcpy(&v, _b, 4); return v; }
+    bool operator==(const IPAddress &o) const { return memcmp(_b, o._b, 4) == 0; }
+    bool operator!=(const IPAddress &o) const { return !(*this == o); }
+
+    String toString() const {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _b[0], _b[1], _b[2], _b[3]);
+        return String(buf);
+    }
+    bool fromString(const char *s) {
+        unsigned v[4];
+        char tail;
+        if (sscanf(s, "%u.%u.%u.%u%c", &v[0], &v[1], &v[2], &v[3], &tail) != 4) return false;
+        for (int i = 0; i < 4; i++) {
+            if (v[i] > 255) return false;
+            _b[i] = (uint8_t)v[i];
+        }
+        return true;
+    }
+    bool fromString(const String &s) { return fromString(s.c_str()); }
+
+private:
+    uint8_t _b[4] = {0, 0, 0, 0};
+};
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef NATIVEHOST_SPIFFS_H
+#define NATIVEHOST_SPIFFS_H
+
+#include "FS.h"
+
+class SPIFFSFS : public fs::FS {
+public:
+    bool begin(bool formatOnFail = false, const char *basePath = "/spiffs", uint8_t maxOpenFiles = 10) { return true; }
+    void end() {}
+};
+extern SPIFFSFS SPIFFS;
+
+#endif
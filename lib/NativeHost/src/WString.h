@@ -0,0 +1,115 @@
+#ifndef NATIVEHOST_WSTRING_H
+#define NATIVEHOST_WSTRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <string>
+
+//----------------------------------------------------------------------------
+// String (Host)
+// Arduino-String auf std::string. Gleiche Schnittstelle wie im ESP32-Core,
+// soweit der Sketch sie nutzt; Allokationen laufen über operator new und
+// werden damit von den Benchmarks mitgezählt.
+//----------------------------------------------------------------------------
+class String {
+public:
+    String() = default;
+    String(const char *s) : _s(s ? s : "") {}
+    String(const char *s, size_t len) : _s(s, len) {}
+    String(const std::string &s) : _s(s) {}
+    explicit String(char c) : _s(1, c) {}
+    String(int v)                : _s(std::to_string(v)) {}
+    String(unsigned int v)       : _s(std::to_string(v)) {}
+    String(long v)               : _s(std::to_string(v)) {}
+    String(unsigned long v)      : _s(std::to_string(v)) {}
+    String(long long v)          : _s(std::to_string(v)) {}
+    String(unsigned long long v) : _s(std::to_string(v)) {}
+    String(float v, unsigned int decimals = 2)  { format(v, decimals); }
+    String(double v, unsigned int decimals = 2) { format(v, decimals); }
+
+    const char* c_str() const { return _s.c_str(); }
+    unsigned int length() const { return (unsigned int)_s.size(); }
+    bool isEmpty() const { return _s.empty(); }
+    bool reserve(unsigned int size) { _s.reserve(size); return true; }
+
+    char charAt(unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+    char operator[](unsigned int i) const { return charAt(i); }
+    char& operator[](unsigned int i) { return _s[i]; }
+
+    bool concat(const String &s) { _s += s._s; return true; }
+    bool concat(const char *s) { if (s) _s += s; return s != nullptr; }
+    bool concat(const char *s, unsigned int len) { if (s) _s.append(s, len); return s != nullptr; }
+    bool concat(char c) { _s += c; return true; }
+    template <typename T> bool concat(T v) { return concat(String(v)); }
+
+    String& operator+=(const String &s) { concat(s); return *this; }
+    String& operator+=(const char *s) { concat(s); return *this; }
+    String& operator+=(char c) { concat(c); return *this; }
+    template <typename T> String& operator+=(T v) { concat(String(v)); return *this; }
+
+    bool equals(const String &s) const { return _s == s._s; }
+    bool equals(const char *s) const { return _s == (s ? s : ""); }
+    bool operator==(const String &s) const { return equals(s); }
+    bool operator==(const char *s) const { return equals(s); }
+    bool operator!=(const String &s) const { return !equals(s); }
+    bool operator!=(const char *s) const { return !equals(s); }
+    bool operator<(const String &s) const { return _s < s._s; }
+    bool equalsIgnoreCase(const String &s) const {
+        return _s.size() == s._s.size() && strncasecmp(_s.c_str(), s._s.c_str(), _s.size()) == 0;
+    }
+
+    bool startsWith(const String &prefix) const { return _s.compare(0, prefix._s.size(), prefix._s) == 0; }
+    bool endsWith(const String &suffix) const {
+        return _s.size() >= suffix._s.size() && _s.compare(_s.size() - suffix._s.size(), suffix._s.size(), suffix._s) == 0;
+    }
+    int indexOf(char c, unsigned int from = 0) const { return pos(_s.find(c, from)); }
+    int indexOf(const String &s, unsigned int from = 0) const { return pos(_s.find(s._s, from)); }
+    int lastIndexOf(char c) const { return pos(_s.rfind(c)); }
+    String substring(unsigned int from) const { return from < _s.size() ? String(_s.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from >= _s.size() || to <= from) return String();
+        return String(_s.substr(from, to - from));
+    }
+
+    // wie im Core: ersetzt alle Vorkommen an Ort und Stelle
+    void replace(const String &find, const String &with) {
+        if (find._s.empty()) return;
+        size_t at = 0;
+        while ((at = _s.find(find._s, at)) != std::string::npos) {
+            _s.replace(at, find._s.size(), with._s);
+            at += with._s.size();
+        }
+    }
+    void remove(unsigned int index, unsigned int count = (unsigned int)-1) {
+        if (index < _s.size()) _s.erase(index, count);
+    }
+    void trim() {
+        size_t b = _s.find_first_not_of(" \t\r\n");
+        size_t e = _s.find_last_not_of(" \t\r\n");
+        _s = b == std::string::npos ? std::string() : _s.substr(b, e - b + 1);
+    }
+    void toLowerCase() { for (char &c : _s) if (c >= 'A' && c <= 'Z') c += 'a' - 'A'; }
+    long toInt() const { return strtol(_s.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(_s.c_str(), nullptr); }
+
+    friend String operator+(const String &a, const String &b) { String r(a); r += b; return r; }
+    friend String operator+(const String &a, const char *b) { String r(a); r += b; return r; }
+    friend String operator+(const char *a, const String &b) { String r(a); r += b; return r; }
+    friend String operator+(const String &a, char b) { String r(a); r += b; return r; }
+
+private:
+    static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+    void format(double v, unsigned int decimals) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+        _s = buf;
+    }
+
+    std::string _s;
+};
+
+#endif
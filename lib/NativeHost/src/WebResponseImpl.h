@@ -0,0 +1,27 @@
+#ifndef NATIVEHOST_WEBRESPONSEIMPL_H
+#define NATIVEHOST_WEBRESPONSEIMPL_H
+
+#include "ESPAsyncWebServer.h"
+
+//----------------------------------------------------------------------------
+// WebResponseImpl (Host)
+// Basis für eigene Antworttypen wie in der Bibliothek: _code, _contentType
+// und _contentLength setzen, _fillBuffer() liefert den Body. Der Header wird
+// auf dem Host nicht ausgewertet, Content-Length also nicht gesendet.
+//----------------------------------------------------------------------------
+class AsyncAbstractResponse : public AsyncWebServerResponse {
+public:
+    AsyncAbstractResponse() : AsyncWebServerResponse(200) {}
+
+    virtual bool _sourceValid() const { return false; }
+    virtual size_t _fillBuffer(uint8_t *buf, size_t maxLen) { return 0; }
+
+    size_t fill(uint8_t *buffer, size_t maxLen) override {
+        return _sourceValid() ? _fillBuffer(buffer, maxLen) : 0;
+    }
+
+protected:
+    size_t _contentLength = 0;
+};
+
+#endif
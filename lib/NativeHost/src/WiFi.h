@@ -0,0 +1,79 @@
+#ifndef NATIVEHOST_WIFI_H
+#define NATIVEHOST_WIFI_H
+
+#include <functional>
+#include <vector>
+#include "Arduino.h"
+
+//----------------------------------------------------------------------------
+// WiFi (Host)
+// Kein Funk: begin() verbindet sofort (GOT_IP kommt synchron über onEvent),
+// solange hostSetReachable(false) nichts anderes sagt. hostDrop() simuliert
+// einen Verbindungsverlust.
+//----------------------------------------------------------------------------
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } wifi_mode_t;
+
+typedef enum {
+    WL_IDLE_STATUS    = 0,
+    WL_NO_SSID_AVAIL  = 1,
+    WL_CONNECTED      = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED   = 6,
+} wl_status_t;
+
+typedef enum {
+    ARDUINO_EVENT_WIFI_STA_START,
+    ARDUINO_EVENT_WIFI_STA_CONNECTED,
+    ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP,
+    ARDUINO_EVENT_WIFI_STA_LOST_IP,
+    ARDUINO_EVENT_WIFI_AP_START,
+    ARDUINO_EVENT_WIFI_AP_STOP,
+} arduino_event_id_t;
+
+typedef struct {} arduino_event_info_t;
+typedef std::function<void(arduino_event_id_t event, arduino_event_info_t info)> WiFiEventFuncCb;
+
+class WiFiClass {
+public:
+    bool mode(wifi_mode_t m) { _mode = m; return true; }
+    wifi_mode_t getMode() const { return _mode; }
+    void persistent(bool) {}
+    bool setAutoReconnect(bool) { return true; }
+    int onEvent(WiFiEventFuncCb cb) { _handlers.push_back(std::move(cb)); return (int)_handlers.size(); }
+
+    wl_status_t begin(const char *ssid, const char *password = nullptr);
+    bool disconnect(bool wifioff = false, bool eraseap = false);
+    wl_status_t status() const { return _status; }
+    String SSID() const { return _ssid; }
+    IPAddress localIP() const { return _status == WL_CONNECTED ? _ip : IPAddress(); }
+    IPAddress subnetMask() const { return _status == WL_CONNECTED ? IPAddress(255, 255, 255, 0) : IPAddress(); }
+
+    bool softAP(const char *ssid, const char *password = nullptr) { _apSsid = ssid; return true; }
+    bool softAPConfig(IPAddress ip, IPAddress gateway, IPAddress subnet) { _apIP = ip; return true; }
+    bool softAPdisconnect(bool wifioff = false) { _apSsid = ""; return true; }
+    IPAddress softAPIP() const { return _apIP; }
+    uint8_t softAPgetStationNum() const { return _apStations; }
+
+    // Host
+    void hostSetReachable(bool reachable) { _reachable = reachable; }
+    void hostSetApStations(uint8_t n) { _apStations = n; }
+    void hostDrop();
+
+private:
+    void emit(arduino_event_id_t event);
+
+    wifi_mode_t _mode = WIFI_OFF;
+    wl_status_t _status = WL_IDLE_STATUS;
+    String _ssid;
+    String _apSsid;
+    IPAddress _ip = IPAddress(192, 168, 1, 50);
+    IPAddress _apIP;
+    uint8_t _apStations = 0;
+    bool _reachable = true;
+    std::vector<WiFiEventFuncCb> _handlers;
+};
+extern WiFiClass WiFi;
+
+#endif
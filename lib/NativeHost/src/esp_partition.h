@@ -0,0 +1,70 @@
+#ifndef NATIVEHOST_ESP_PARTITION_H
+#define NATIVEHOST_ESP_PARTITION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//----------------------------------------------------------------------------
+// Partitions-API (Host)
+// Eine Datenpartition "config" (Größe wie in partitions.csv) im RAM, mit
+// NOR-Semantik: Schreiben setzt nur Bits auf 0, Löschen sektorweise auf 0xFF.
+// Die Partition "assets" ist nur lesbar und wird wie auf dem ESP32 über
+// esp_partition_mmap eingeblendet; Inhalt per mmap aus einer Datei
+// (loadPartitionFile), sonst gelöscht (0xFF).
+//----------------------------------------------------------------------------
+
+typedef int esp_err_t;
+#define ESP_OK              0
+#define ESP_FAIL            -1
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_SIZE 0x104
+
+#define SPI_FLASH_SEC_SIZE 4096
+
+typedef enum {
+    ESP_PARTITION_TYPE_APP  = 0x00,
+    ESP_PARTITION_TYPE_DATA = 0x01,
+} esp_partition_type_t;
+
+typedef enum {
+    ESP_PARTITION_SUBTYPE_DATA_NVS = 0x02,
+    ESP_PARTITION_SUBTYPE_ANY      = 0xff,
+} esp_partition_subtype_t;
+
+typedef enum {
+    SPI_FLASH_MMAP_DATA,
+    SPI_FLASH_MMAP_INST,
+} spi_flash_mmap_memory_t;
+
+typedef uint32_t spi_flash_mmap_handle_t;
+
+typedef struct {
+    esp_partition_type_t    type;
+    esp_partition_subtype_t subtype;
+    uint32_t                address;
+    uint32_t                size;
+    char                    label[17];
+    bool                    encrypted;
+} esp_partition_t;
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *label);
+esp_err_t esp_partition_read(const esp_partition_t *part, size_t offset, void *dst, size_t size);
+esp_err_t esp_partition_write(const esp_partition_t *part, size_t offset, const void *src, size_t size);
+esp_err_t esp_partition_erase_range(const esp_partition_t *part, size_t offset, size_t size);
+esp_err_t esp_partition_mmap(const esp_partition_t *part, size_t offset, size_t size,
+                             spi_flash_mmap_memory_t memory, const void **out_ptr,
+                             spi_flash_mmap_handle_t *out_handle);
+void spi_flash_munmap(spi_flash_mmap_handle_t handle);
+
+namespace NativeHost {
+    void resetPartition();                  // alles 0xFF, Zähler auf 0
+    uint32_t partitionErases();
+    uint64_t partitionBytesWritten();
+    // Dauer wie auf dem ESP32 nachbilden (Schreiben je Aufruf, Löschen je Sektor); 0 = sofort
+    void setFlashLatency(uint32_t writeUs, uint32_t eraseUs);
+    // Datei als Inhalt der Partition label einblenden (nur "assets"), z.B. .pio/assets.bin;
+    // false = Datei fehlt oder ist größer als die Partition
+    bool loadPartitionFile(const char *label, const char *path);
+}
+
+#endif
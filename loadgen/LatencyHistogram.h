@@ -0,0 +1,72 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <stdint.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------
+// LatencyHistogram
+// Log-lineares Histogramm in Mikrosekunden: jede Zweierpotenz ist in
+// kSubBuckets gleich breite Fächer geteilt, der Fehler eines Perzentils
+// liegt also unter 1/kSubBuckets (~6 %). Feste Größe, record() allokiert
+// nicht und verfälscht damit die Heap-Messung des Lastgenerators nicht.
+//----------------------------------------------------------------------------
+class LatencyHistogram {
+public:
+    static constexpr int kSubBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBits;
+    static constexpr int kOctaves = 28;                 // bis ~35 min
+    static constexpr int kBuckets = kOctaves * kSubBuckets;
+
+    void reset() { memset(this, 0, sizeof(*this)); }
+
+    void record(uint64_t us) {
+        _counts[index(us)]++;
+        _total++;
+        _sum += us;
+        if (us > _max) _max = us;
+    }
+
+    uint64_t count() const { return _total; }
+    uint64_t max() const { return _max; }
+    double mean() const { return _total ? (double)_sum / _total : 0; }
+
+    // Obergrenze des Fachs, in dem das p-Quantil (0..1) liegt
+    uint64_t percentile(double p) const {
+        if (_total == 0) return 0;
+        uint64_t rank = (uint64_t)(p * _total + 0.5);
+        if (rank == 0) rank = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; i++) {
+            seen += _counts[i];
+            if (seen >= rank) {
+                uint64_t upper = lowerBound(i + 1) - 1;
+                return upper < _max ? upper : _max;
+            }
+        }
+        return _max;
+    }
+
+    uint64_t bucketCount(int i) const { return _counts[i]; }
+
+    static int index(uint64_t us) {
+        if (us < (uint64_t)kSubBuckets) return (int)us;
+        int octave = 63 - __builtin_clzll(us) - kSubBits + 1;
+        int i = octave * kSubBuckets + (int)((us >> (octave - 1)) & (kSubBuckets - 1));
+        return i < kBuckets ? i : kBuckets - 1;
+    }
+
+    static uint64_t lowerBound(int i) {
+        if (i < kSubBuckets) return (uint64_t)i;
+        int octave = i / kSubBuckets;
+        return (uint64_t)(kSubBuckets + i % kSubBuckets) << (octave - 1);
+    }
+
+private:
+    uint64_t _counts[kBuckets];
+    uint64_t _total;
+    uint64_t _sum;
+    uint64_t _max;
+};
+
+#endif
@@ -0,0 +1,325 @@
+//----------------------------------------------------------------------------
+// Lastgenerator (env:native_load)
+//   pio run -e native_load
+//   .pio/build/native_load/program [--concurrency 1,8,16,32] [--requests 2000]
+//                                  [--mix /index=2,/status.json=4,...] [--max-conn 16]
+//                                  [--assets bundle|spiffs] [--out load.json]
+// WebServerClass mit den echten Routen aus setupRoutes() hinter
+// NativeHost::HttpListener auf 127.0.0.1. Pro Stufe halten N Clients je eine
+// Verbindung offen, jede Verbindung ist ein Request (wie beim Gerät mit
+// "Connection: close"). Server und Clients laufen im selben Thread, damit
+// der zählende Allocator aus bench/Bench.cpp nur eine Seite sehen muss: die
+// Clients allokieren nach dem Start nichts mehr.
+//
+// Ausgabe je Stufe: Durchsatz, p50/p95/p99/max der Latenz (Verbindungsaufbau
+// bis letztes Byte), Heap-Spitze, abgewiesene Verbindungen und Fehler.
+//
+// --assets: Seiten und Assets aus dem Asset-Bundle (.pio/assets.bin als
+// Partition "assets", Standard) oder nur aus SPIFFS wie ohne Bundle.
+//----------------------------------------------------------------------------
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <HttpListener.h>
+#include <esp_partition.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../bench/Bench.h"
+#include "LatencyHistogram.h"
+#include "WebServerClass.h"
+
+static WebServerClass webServer;
+
+struct Target {
+    String path;
+    unsigned weight;
+    char request[256];
+    size_t requestLen;
+    LatencyHistogram latency;
+    uint64_t errors;
+};
+
+struct Slot {
+    int fd = -1;
+    Target *target = nullptr;
+    std::chrono::steady_clock::time_point start;
+    size_t sent = 0;
+    size_t received = 0;
+    char status[16];            // Anfang der Statuszeile
+};
+
+struct Level {
+    size_t concurrency;
+    uint64_t completed = 0;
+    uint64_t errors = 0;
+    double seconds = 0;
+    size_t peakHeap = 0;
+    NativeHost::HttpListener::Stats server;
+    LatencyHistogram latency;
+};
+
+static const size_t kMaxConcurrency = 256;
+static std::vector<Target> targets;
+static std::vector<Target*> schedule;     // nach Gewicht verteilt
+static size_t nextRequest = 0;
+
+static void parseMix(const char *mix) {
+    targets.clear();
+    String spec(mix);
+    int from = 0;
+    while (from < (int)spec.length()) {
+        int comma = spec.indexOf(',', from);
+        String item = spec.substring(from, comma < 0 ? spec.length() : comma);
+        int eq = item.indexOf('=');
+        Target t = {};
+        t.path = eq < 0 ? item : item.substring(0, eq);
+        t.weight = eq < 0 ? 1 : (unsigned)atoi(item.substring(eq + 1).c_str());
+        if (t.weight) targets.push_back(t);
+        from = comma < 0 ? spec.length() : comma + 1;
+    }
+}
+
+static void buildSchedule(uint16_t port) {
+    schedule.clear();
+    // reihum statt blockweise, damit jede Stufe dieselbe Mischung sieht
+    unsigned maxWeight = 0;
+    for (Target &t : targets) {
+        t.requestLen = snprintf(t.request, sizeof(t.request),
+                                "GET %s HTTP/1.1\r\nHost: 127.0.0.1:%u\r\nAccept-Encoding: gzip, deflate\r\n\r\n",
+                                t.path.c_str(), port);
+        if (t.weight > maxWeight) maxWeight = t.weight;
+    }
+    for (unsigned round = 0; round < maxWeight; round++) {
+        for (Target &t : targets) {
+            if (round < t.weight) schedule.push_back(&t);
+        }
+    }
+}
+
+static bool open(Slot &slot, uint16_t port) {
+    slot.fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (slot.fd < 0) return false;
+    fcntl(slot.fd, F_SETFL, fcntl(slot.fd, F_GETFL, 0) | O_NONBLOCK);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    slot.target = schedule[nextRequest++ % schedule.size()];
+    slot.start = std::chrono::steady_clock::now();
+    slot.sent = slot.received = 0;
+    slot.status[0] = 0;
+    if (connect(slot.fd, (sockaddr*)&addr, sizeof(addr)) < 0 && errno != EINPROGRESS) {
+        close(slot.fd);
+        slot.fd = -1;
+        return false;
+    }
+    return true;
+}
+
+// Antwort vollständig (Server hat geschlossen) oder Verbindung verloren
+static void finish(Slot &slot, Level &level) {
+    close(slot.fd);
+    slot.fd = -1;
+    int code = 0;
+    sscanf(slot.status, "HTTP/1.%*d %d", &code);
+    if (code < 200 || code >= 400) {
+        slot.target->errors++;
+        level.errors++;
+        return;
+    }
+    uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - slot.start).count();
+    slot.target->latency.record(us);
+    level.latency.record(us);
+    level.completed++;
+}
+
+static void step(Slot &slot, short events, Level &level) {
+    if (slot.sent < slot.target->requestLen && (events & POLLOUT)) {
+        ssize_t n = send(slot.fd, slot.target->request + slot.sent,
+                         slot.target->requestLen - slot.sent, MSG_NOSIGNAL);
+        if (n < 0 && errno != EAGAIN) return finish(slot, level);
+        if (n > 0) slot.sent += n;
+    }
+    if (events & (POLLIN | POLLHUP | POLLERR)) {
+        char buffer[4096];
+        for (;;) {
+            ssize_t n = recv(slot.fd, buffer, sizeof(buffer), 0);
+            if (n < 0 && errno == EAGAIN) return;
+            if (n <= 0) return finish(slot, level);
+            if (slot.received < sizeof(slot.status) - 1) {
+                size_t copy = std::min((size_t)n, sizeof(slot.status) - 1 - slot.received);
+                memcpy(slot.status + slot.received, buffer, copy);
+                slot.status[slot.received + copy] = 0;
+            }
+            slot.received += n;
+        }
+    }
+}
+
+static Level runLevel(size_t concurrency, uint64_t requests, size_t maxConnections) {
+    Level level;
+    level.concurrency = concurrency;
+    level.latency.reset();
+    for (Target &t : targets) {
+        t.latency.reset();
+        t.errors = 0;
+    }
+
+    NativeHost::HttpListener listener(*AsyncWebServer::hostInstance(80), maxConnections);
+    if (!listener.begin()) {
+        fprintf(stderr, "Kein Port auf 127.0.0.1 frei\n");
+        exit(1);
+    }
+    buildSchedule(listener.port());
+    nextRequest = 0;
+
+    Slot slots[kMaxConcurrency];
+    pollfd fds[kMaxConcurrency];
+    size_t base = Bench::allocStats().current;
+    Bench::resetPeak();
+    auto start = std::chrono::steady_clock::now();
+
+    uint64_t started = 0;
+    for (;;) {
+        size_t active = 0;
+        for (size_t i = 0; i < concurrency; i++) {
+            if (slots[i].fd < 0 && started < requests) {
+                started++;
+                if (!open(slots[i], listener.port())) level.errors++;
+            }
+            fds[i] = {slots[i].fd, (short)(slots[i].sent < (slots[i].target ? slots[i].target->requestLen : 0)
+                                           ? POLLOUT : POLLIN), 0};
+            if (slots[i].fd >= 0) active++;
+        }
+        if (active == 0 && started >= requests) break;
+
+        listener.poll(0);
+        webServer.loop();
+        // ohne Wartezeit: ein Sleep im Client würde die Latenz bestimmen
+        if (::poll(fds, concurrency, 0) > 0) {
+            for (size_t i = 0; i < concurrency; i++) {
+                if (slots[i].fd >= 0 && fds[i].revents) step(slots[i], fds[i].revents, level);
+            }
+        }
+    }
+
+    level.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    level.peakHeap = Bench::allocStats().peak - base;
+    level.server = listener.stats();
+    return level;
+}
+
+static void appendLatency(String &json, const LatencyHistogram &h) {
+    char line[160];
+    snprintf(line, sizeof(line),
+             "\"p50_us\": %llu, \"p95_us\": %llu, \"p99_us\": %llu, \"max_us\": %llu, \"mean_us\": %.1f",
+             (unsigned long long)h.percentile(0.50), (unsigned long long)h.percentile(0.95),
+             (unsigned long long)h.percentile(0.99), (unsigned long long)h.max(), h.mean());
+    json += line;
+}
+
+static String toJson(const std::vector<Level> &levels) {
+    String json = "{\n  \"levels\": [\n";
+    char line[256];
+    for (size_t i = 0; i < levels.size(); i++) {
+        const Level &l = levels[i];
+        snprintf(line, sizeof(line),
+                 "    {\"concurrency\": %zu, \"completed\": %llu, \"errors\": %llu, \"refused\": %u, "
+                 "\"peak_open\": %zu, \"requests_per_sec\": %.1f, \"peak_heap\": %zu, \"min_free_heap\": %zu, ",
+                 l.concurrency, (unsigned long long)l.completed, (unsigned long long)l.errors,
+                 l.server.refused, l.server.peakOpen, l.completed / l.seconds, l.peakHeap,
+                 l.peakHeap < NativeHost::kHeapSize ? NativeHost::kHeapSize - l.peakHeap : 0);
+        json += line;
+        appendLatency(json, l.latency);
+        json += i + 1 < levels.size() ? "},\n" : "}\n";
+    }
+    // Aufschlüsselung nach Pfad nur für die letzte (höchste) Stufe
+    json += "  ],\n  \"paths\": [\n";
+    for (size_t i = 0; i < targets.size(); i++) {
+        const Target &t = targets[i];
+        snprintf(line, sizeof(line), "    {\"path\": \"%s\", \"weight\": %u, \"completed\": %llu, \"errors\": %llu, ",
+                 t.path.c_str(), t.weight, (unsigned long long)t.latency.count(), (unsigned long long)t.errors);
+        json += line;
+        appendLatency(json, t.latency);
+        json += i + 1 < targets.size() ? "},\n" : "}\n";
+    }
+    json += "  ]\n}\n";
+    return json;
+}
+
+int main(int argc, char **argv) {
+    std::vector<size_t> concurrency = {1, 8, 16, 32};
+    uint64_t requests = 2000;
+    size_t maxConnections = NativeHost::HttpListener::kMaxConnections;
+    const char *mix = "/index=2,/status.json=4,/config=1,/style.css=2,/script.js=1";
+    const char *out = nullptr;
+    const char *assets = "bundle";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        String opt = argv[i];
+        if (opt == "--concurrency") {
+            concurrency.clear();
+            for (char *p = strtok(argv[i + 1], ","); p; p = strtok(nullptr, ",")) {
+                size_t n = strtoul(p, nullptr, 10);
+                if (n > 0) concurrency.push_back(std::min(n, kMaxConcurrency));
+            }
+        } else if (opt == "--requests") {
+            requests = strtoull(argv[i + 1], nullptr, 10);
+        } else if (opt == "--mix") {
+            mix = argv[i + 1];
+        } else if (opt == "--max-conn") {
+            maxConnections = strtoul(argv[i + 1], nullptr, 10);
+        } else if (opt == "--assets") {
+            assets = argv[i + 1];
+        } else if (opt == "--out") {
+            out = argv[i + 1];
+        } else {
+            fprintf(stderr, "Unbekannte Option %s\n", argv[i]);
+            return 2;
+        }
+    }
+    parseMix(mix);
+    if (targets.empty() || concurrency.empty()) {
+        fprintf(stderr, "Leere Mischung oder keine Stufe\n");
+        return 2;
+    }
+
+    Serial.setOutput(nullptr);
+    SPIFFS.hostLoadDir(".pio/data");
+    if (strcmp(assets, "spiffs") != 0 && !NativeHost::loadPartitionFile("assets", ".pio/assets.bin")) {
+        fprintf(stderr, ".pio/assets.bin fehlt, Assets aus SPIFFS\n");
+    }
+    webServer.begin();
+
+    // Aufwärmen: PageCache/TemplateEngine füllen, jeder Pfad einmal
+    runLevel(1, targets.size(), maxConnections);
+
+    std::vector<Level> levels;
+    for (size_t n : concurrency) {
+        levels.push_back(runLevel(n, requests, maxConnections));
+        const Level &l = levels.back();
+        fprintf(stderr, "c=%-4zu %8.0f req/s  p50 %6llu us  p99 %6llu us  heap %6zu  refused %u  errors %llu\n",
+                n, l.completed / l.seconds, (unsigned long long)l.latency.percentile(0.50),
+                (unsigned long long)l.latency.percentile(0.99), l.peakHeap, l.server.refused,
+                (unsigned long long)l.errors);
+    }
+
+    String json = toJson(levels);
+    if (out) {
+        FILE *f = fopen(out, "w");
+        if (!f) {
+            fprintf(stderr, "Kann %s nicht schreiben\n", out);
+            return 1;
+        }
+        fputs(json.c_str(), f);
+        fclose(f);
+    }
+    fputs(json.c_str(), stdout);
+    return 0;
+}
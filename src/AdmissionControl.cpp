@@ -0,0 +1,46 @@
+#include "AdmissionControl.h"
+#include "RouteMetrics.h"
+
+void AdmissionControl::setLimits(const Limits &limits) {
+    _maxInFlight.store(limits.maxInFlight, std::memory_order_relaxed);
+    _minFreeHeap.store(limits.minFreeHeap, std::memory_order_relaxed);
+    _retryAfterSec.store(limits.retryAfterSec, std::memory_order_relaxed);
+}
+
+AdmissionControl::Limits AdmissionControl::limits() const {
+    Limits l;
+    l.maxInFlight = _maxInFlight.load(std::memory_order_relaxed);
+    l.minFreeHeap = _minFreeHeap.load(std::memory_order_relaxed);
+    l.retryAfterSec = _retryAfterSec.load(std::memory_order_relaxed);
+    return l;
+}
+
+bool AdmissionControl::admit(AsyncWebServerRequest *request, bool counted) {
+    uint32_t running = RouteMetrics::inFlight() + (counted ? 0 : 1);
+    if (running > _maxInFlight.load(std::memory_order_relaxed)) {
+        reject(request, _rejectedBusy);
+        return false;
+    }
+    if (ESP.getFreeHeap() < _minFreeHeap.load(std::memory_order_relaxed)) {
+        reject(request, _rejectedHeap);
+        return false;
+    }
+    _admitted.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void AdmissionControl::reject(AsyncWebServerRequest *request, std::atomic<uint32_t> &counter) {
+    counter.fetch_add(1, std::memory_order_relaxed);
+    RouteMetrics::current().status(503);
+    AsyncWebServerResponse *response = request->beginResponse(503, "text/plain", "Server ausgelastet");
+    response->addHeader("Retry-After", String(_retryAfterSec.load(std::memory_order_relaxed)));
+    request->send(response);
+}
+
+AdmissionControl::Stats AdmissionControl::stats() const {
+    Stats s;
+    s.admitted = _admitted.load(std::memory_order_relaxed);
+    s.rejectedBusy = _rejectedBusy.load(std::memory_order_relaxed);
+    s.rejectedHeap = _rejectedHeap.load(std::memory_order_relaxed);
+    return s;
+}
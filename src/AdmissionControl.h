@@ -0,0 +1,58 @@
+#ifndef ADMISSIONCONTROL_H
+#define ADMISSIONCONTROL_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <atomic>
+
+//----------------------------------------------------------------------------
+// AdmissionControl
+// Schützt den Heap bei vielen gleichzeitigen Requests (mehrere Dashboard-
+// Tabs): teure Routen – Template-Seiten, Dateien aus dem SPIFFS – werden mit
+// 503 und Retry-After abgewiesen, wenn mit ihnen mehr als maxInFlight liefen
+// (RouteMetrics::inFlight()) oder der freie Heap unter minFreeHeap liegt.
+// Billige Routen wie /counter und /status.json laufen immer weiter; sie
+// allokieren kaum und halten die Oberfläche am Leben.
+//
+// Grenzen zur Laufzeit änderbar (setLimits(), POST /admission); gelesen wird
+// im AsyncTCP-Task, daher alles atomar.
+//----------------------------------------------------------------------------
+class AdmissionControl {
+public:
+    enum Cost : uint8_t { CHEAP, EXPENSIVE };
+
+    struct Limits {
+        uint32_t maxInFlight = 8;           // höchstens so viele laufende Requests, dieser eingeschlossen
+        uint32_t minFreeHeap = 32 * 1024;   // Wasserstand in Bytes
+        uint32_t retryAfterSec = 2;
+    };
+
+    struct Stats {
+        uint32_t admitted;
+        uint32_t rejectedBusy;      // maxInFlight erreicht
+        uint32_t rejectedHeap;      // unter dem Wasserstand
+    };
+
+    AdmissionControl() { setLimits(Limits()); }
+
+    void setLimits(const Limits &limits);
+    Limits limits() const;
+
+    // Für teure Routen: true = bearbeiten, false = 503 ist schon gesendet.
+    // counted: Request ist schon in RouteMetrics::inFlight() enthalten
+    bool admit(AsyncWebServerRequest *request, bool counted = true);
+
+    Stats stats() const;
+
+private:
+    void reject(AsyncWebServerRequest *request, std::atomic<uint32_t> &counter);
+
+    std::atomic<uint32_t> _maxInFlight{0};
+    std::atomic<uint32_t> _minFreeHeap{0};
+    std::atomic<uint32_t> _retryAfterSec{0};
+    std::atomic<uint32_t> _admitted{0};
+    std::atomic<uint32_t> _rejectedBusy{0};
+    std::atomic<uint32_t> _rejectedHeap{0};
+};
+
+#endif
@@ -0,0 +1,99 @@
+#include "AssetBundle.h"
+
+static_assert(sizeof(AssetBundle::Header) == 20, "Format wie tools/build_assets.py");
+static_assert(sizeof(AssetBundle::Entry) == 32, "Format wie tools/build_assets.py");
+
+// Reihenfolge wie strcmp (bzw. Bytes in Python), Pfade enthalten kein '\0'
+static int compare(const char *a, size_t aLen, const char *b, size_t bLen) {
+    int cmp = memcmp(a, b, aLen < bLen ? aLen : bLen);
+    if (cmp != 0) return cmp;
+    return aLen < bLen ? -1 : (aLen > bLen ? 1 : 0);
+}
+
+bool AssetBundle::map(const char *label) {
+    end();
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (!part) return false;
+    const void *ptr = nullptr;
+    if (esp_partition_mmap(part, 0, part->size, SPI_FLASH_MMAP_DATA, &ptr, &_handle) != ESP_OK) return false;
+    _mapped = true;
+    if (!begin((const uint8_t*)ptr, part->size)) {
+        end();
+        return false;
+    }
+    return true;
+}
+
+bool AssetBundle::begin(const uint8_t *base, size_t len) {
+    _header = nullptr;
+    if (len < sizeof(Header) || (uintptr_t)base % 4 != 0) return false;
+    const Header *header = (const Header*)base;
+    if (header->magic != kMagic || header->size > len || header->size < sizeof(Header)) return false;
+    if (header->count > (header->size - sizeof(Header)) / sizeof(Entry)) return false;
+
+    // Index einmal prüfen, danach vertraut find() den Offsets
+    _base = base;
+    _header = header;
+    _entries = (const Entry*)(base + sizeof(Header));
+    for (uint32_t i = 0; i < header->count; i++) {
+        bool sorted = i == 0 || compare(str(_entries[i - 1].path), _entries[i - 1].pathLen,
+                                        str(_entries[i].path), _entries[i].pathLen) < 0;
+        if (!check(_entries[i]) || !sorted) {
+            _header = nullptr;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AssetBundle::check(const Entry &e) const {
+    uint32_t size = _header->size;
+    auto terminated = [&](uint32_t offset) {
+        return offset < size && memchr(_base + offset, 0, size - offset) != nullptr;
+    };
+    if (e.pathLen >= size || e.path > size - e.pathLen - 1 || _base[e.path + e.pathLen] != 0) return false;
+    if (!terminated(e.contentType) || !terminated(e.etag)) return false;
+    if (e.size >= size || e.data > size - e.size - 1 || _base[e.data + e.size] != 0) return false;
+    return e.gzSize == 0 || (e.gzSize <= size && e.gzData <= size - e.gzSize);
+}
+
+void AssetBundle::end() {
+    if (_mapped) spi_flash_munmap(_handle);
+    _mapped = false;
+    _base = nullptr;
+    _header = nullptr;
+    _entries = nullptr;
+}
+
+bool AssetBundle::matches(const char *version) const {
+    if (!_header) return false;
+    size_t len = strlen(version);
+    return len <= sizeof(_header->version) && memcmp(_header->version, version, len) == 0
+           && (len == sizeof(_header->version) || _header->version[len] == 0);
+}
+
+AssetBundle::Asset AssetBundle::find(const char *path, size_t len) const {
+    Asset asset;
+    if (!_header) return asset;
+    size_t lo = 0, hi = _header->count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        const Entry &e = _entries[mid];
+        int cmp = compare(path, len, str(e.path), e.pathLen);
+        if (cmp < 0) {
+            hi = mid;
+        } else if (cmp > 0) {
+            lo = mid + 1;
+        } else {
+            asset.path = str(e.path);
+            asset.contentType = str(e.contentType);
+            asset.etag = str(e.etag);
+            asset.data = _base + e.data;
+            asset.size = e.size;
+            asset.gzData = e.gzSize ? _base + e.gzData : nullptr;
+            asset.gzSize = e.gzSize;
+            return asset;
+        }
+    }
+    return asset;
+}
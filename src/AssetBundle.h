@@ -0,0 +1,86 @@
+#ifndef ASSETBUNDLE_H
+#define ASSETBUNDLE_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+
+//----------------------------------------------------------------------------
+// AssetBundle
+// data/ als ein schreibgeschütztes Abbild in der Partition "assets", gepackt
+// von tools/build_assets.py (.pio/assets.bin, pio run -t uploadassets):
+//
+//   Header | Entry[count] nach Pfad sortiert | Strings | Daten (4-Byte-ausgerichtet)
+//
+// Die Partition wird über den Flash-Cache eingeblendet (esp_partition_mmap).
+// Suche binär über den Index, Längen, Content-Type, ETag und gzip-Variante
+// stehen im Eintrag; Antworten und Seiten lesen direkt aus dem Flash, nichts
+// wird in den RAM kopiert. Auf dem Host ist die Partition eine per mmap
+// eingeblendete Datei (NativeHost::loadPartitionFile).
+//----------------------------------------------------------------------------
+class AssetBundle {
+public:
+    static constexpr uint32_t kMagic = 0x31425341;     // "ASB1"
+
+    struct Header {
+        uint32_t magic;
+        uint32_t count;
+        uint32_t size;          // gesamtes Bundle in Bytes
+        char     version[8];    // ASSET_VERSION beim Packen, ohne '\0'
+    };
+    // Offsets relativ zum Bundle-Anfang; Strings und Rohdaten enden mit '\0'
+    struct Entry {
+        uint32_t path;
+        uint32_t pathLen;
+        uint32_t contentType;
+        uint32_t etag;          // Inhalts-Hash, ohne Anführungszeichen
+        uint32_t data;
+        uint32_t size;
+        uint32_t gzData;
+        uint32_t gzSize;        // 0 = keine gzip-Variante
+    };
+
+    // Zeiger in das eingeblendete Bundle, gültig bis end()
+    struct Asset {
+        const char    *path = nullptr;
+        const char    *contentType = nullptr;
+        const char    *etag = nullptr;
+        const uint8_t *data = nullptr;      // size Bytes, danach '\0'
+        uint32_t       size = 0;
+        const uint8_t *gzData = nullptr;
+        uint32_t       gzSize = 0;
+        explicit operator bool() const { return data != nullptr; }
+    };
+
+    AssetBundle() = default;
+    AssetBundle(const AssetBundle&) = delete;
+    AssetBundle& operator=(const AssetBundle&) = delete;
+    ~AssetBundle() { end(); }
+
+    // Partition einblenden und prüfen; false = fehlt, gelöscht oder ungültig
+    bool map(const char *label = "assets");
+    // Bundle im Speicher (Tests); base muss 4-Byte-ausgerichtet sein
+    bool begin(const uint8_t *base, size_t len);
+    void end();
+
+    bool valid() const { return _header != nullptr; }
+    size_t count() const { return _header ? _header->count : 0; }
+    size_t size() const { return _header ? _header->size : 0; }
+    // Stand beim Packen gleich version (ASSET_VERSION der Firmware)
+    bool matches(const char *version) const;
+
+    Asset find(const char *path, size_t len) const;
+    Asset find(const char *path) const { return find(path, strlen(path)); }
+    Asset find(const String &path) const { return find(path.c_str(), path.length()); }
+
+private:
+    bool check(const Entry &e) const;
+    const char* str(uint32_t offset) const { return (const char*)_base + offset; }
+
+    const uint8_t *_base = nullptr;
+    const Header  *_header = nullptr;
+    const Entry   *_entries = nullptr;
+    spi_flash_mmap_handle_t _handle = 0;
+    bool _mapped = false;
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef ASSETMANIFEST_H
+#define ASSETMANIFEST_H
+
+#include <stdint.h>
+
+// Eintrag pro Datei aus data/, erzeugt von tools/build_assets.py
+struct AssetInfo {
+    const char *path;
+    const char *contentType;
+    const char *etag;       // Inhalts-Hash, ohne Anführungszeichen
+    uint32_t    size;
+    uint32_t    gzSize;     // 0 = keine .gz-Variante
+};
+
+#if __has_include("assets_generated.h")
+    #include "assets_generated.h"
+#endif
+
+// Ohne Build-Script (z.B. Arduino IDE): keine ETags, Dateien werden ungecacht geliefert
+#ifndef ASSET_VERSION
+    #define ASSET_VERSION "0"
+#endif
+#ifndef ASSET_TABLE_ENTRIES
+    #define ASSET_TABLE_ENTRIES
+#endif
+
+#endif
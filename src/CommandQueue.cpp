@@ -0,0 +1,67 @@
+#include "CommandQueue.h"
+
+uint32_t CommandQueue::push(Command &cmd) {
+    cmd.seq = _nextSeq;
+    if (!_ring.push(cmd)) {
+        _full.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    if (++_nextSeq == 0) _nextSeq = 1;     // 0 heißt "nicht angenommen"
+    _pushed.fetch_add(1, std::memory_order_relaxed);
+    return cmd.seq;
+}
+
+bool CommandQueue::take(Batch &batch) {
+    batch = Batch();
+    Command cmd;
+    bool any = false;
+    // höchstens eine Pufferfüllung, auch wenn der Erzeuger nachlegt
+    for (size_t i = 0; i < kCapacity && _ring.pop(cmd); i++) {
+        merge(batch, cmd);
+        any = true;
+    }
+    return any;
+}
+
+void CommandQueue::merge(Batch &batch, const Command &cmd) {
+    batch.lastSeq = cmd.seq;
+    bool replaced = false;
+    switch (cmd.kind) {
+    case WS_SET:
+        replaced = batch.hasSet;
+        batch.hasSet = true;
+        if (cmd.set.hasLed)   { batch.set.hasLed = true;   batch.set.led = cmd.set.led; }
+        if (cmd.set.hasBlink) { batch.set.hasBlink = true; batch.set.blink = cmd.set.blink; }
+        break;
+    case SAVE_TEXT:
+        replaced = batch.hasText;
+        batch.hasText = true;
+        memcpy(batch.text, cmd.text, sizeof(batch.text));
+        break;
+    case SAVE_WIFI:
+        replaced = batch.hasWifi[cmd.ap];
+        batch.hasWifi[cmd.ap] = true;
+        batch.wifi[cmd.ap] = cmd.wifi;
+        batch.reboot |= cmd.reboot;
+        break;
+    }
+    if (replaced) _merged.fetch_add(1, std::memory_order_relaxed);
+
+    if (cmd.clientId == 0) return;
+    for (size_t i = 0; i < batch.ackCount; i++) {
+        if (batch.acks[i].clientId == cmd.clientId) {
+            batch.acks[i].seq = cmd.seq;
+            return;
+        }
+    }
+    batch.acks[batch.ackCount++] = {cmd.clientId, cmd.seq};
+}
+
+CommandQueue::Stats CommandQueue::stats() const {
+    Stats s;
+    s.pushed = _pushed.load(std::memory_order_relaxed);
+    s.merged = _merged.load(std::memory_order_relaxed);
+    s.full = _full.load(std::memory_order_relaxed);
+    s.applied = _applied.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,87 @@
+#ifndef COMMANDQUEUE_H
+#define COMMANDQUEUE_H
+
+#include <Arduino.h>
+#include <ConfigManager.h>
+#include <atomic>
+#include "SpscRing.h"
+#include "WsProtocol.h"
+
+//----------------------------------------------------------------------------
+// CommandQueue
+// Befehle aus den Handlern (AsyncTCP-Task, einziger Erzeuger) an loop()
+// (einziger Verbraucher). Handler legen nur einen Befehl in den SpscRing;
+// was blockieren kann – ConfigManager-Sperre während eines Flash-Commits,
+// GPIO – passiert erst in loop().
+//
+// take() holt alles Anstehende auf einmal und fasst gleichartige Befehle
+// zusammen: mehrere LED-/Blink-Befehle ergeben einen Endzustand, beim Text
+// und je WLAN-Satz (STA/AP) gilt der letzte. Jeder Befehl bekommt bei push()
+// eine fortlaufende Nummer; nach done() meldet completed(), dass er (oder ein
+// späterer, der ihn ersetzt hat) angewendet ist.
+//----------------------------------------------------------------------------
+class CommandQueue {
+public:
+    static constexpr size_t kCapacity = 8;
+
+    enum Kind : uint8_t { WS_SET, SAVE_TEXT, SAVE_WIFI };
+
+    struct Command {
+        Kind     kind = WS_SET;
+        uint32_t seq = 0;               // vergibt push()
+        uint32_t clientId = 0;          // WS_SET: Absender für die Quittung, 0 = keiner
+        WsProtocol::Command set;        // WS_SET
+        char     text[MAX_TEXT] = {};   // SAVE_TEXT
+        WifiConf wifi{};                // SAVE_WIFI
+        bool     ap = false;            // SAVE_WIFI: Access-Point-Satz
+        bool     reboot = false;        // SAVE_WIFI: danach neu starten
+    };
+
+    // Zusammengefasstes Ergebnis eines take()
+    struct Batch {
+        uint32_t lastSeq = 0;           // höchste enthaltene Nummer, an done() geben
+        bool     hasSet = false;
+        WsProtocol::Command set;
+        bool     hasText = false;
+        char     text[MAX_TEXT] = {};
+        bool     hasWifi[2] = {};       // [0] STA, [1] AP
+        WifiConf wifi[2]{};
+        bool     reboot = false;
+        struct Ack { uint32_t clientId; uint32_t seq; };
+        Ack      acks[kCapacity];       // je WebSocket-Client die höchste Nummer
+        size_t   ackCount = 0;
+    };
+
+    struct Stats {
+        uint32_t pushed;
+        uint32_t merged;        // in einem späteren Befehl aufgegangen
+        uint32_t full;          // abgewiesen, Puffer voll
+        uint32_t applied;       // Nummer des zuletzt angewendeten Befehls
+    };
+
+    // Erzeuger: Nummer des Befehls, 0 = Puffer voll
+    uint32_t push(Command &cmd);
+
+    // Verbraucher: false = nichts angestanden
+    bool take(Batch &batch);
+    void done(uint32_t seq) { _applied.store(seq, std::memory_order_release); }
+
+    // von überall: ist Befehl seq angewendet?
+    bool completed(uint32_t seq) const {
+        return seq != 0 && (int32_t)(_applied.load(std::memory_order_acquire) - seq) >= 0;
+    }
+    size_t pending() const { return _ring.size(); }
+    Stats stats() const;
+
+private:
+    void merge(Batch &batch, const Command &cmd);
+
+    SpscRing<Command, kCapacity> _ring;
+    uint32_t _nextSeq = 1;                  // nur Erzeuger
+    std::atomic<uint32_t> _applied{0};
+    std::atomic<uint32_t> _pushed{0};
+    std::atomic<uint32_t> _merged{0};
+    std::atomic<uint32_t> _full{0};
+};
+
+#endif
@@ -0,0 +1,47 @@
+#include "DeviceState.h"
+
+DeviceState::Snapshot DeviceState::read() const {
+    for (;;) {
+        uint32_t before = _seq.load(std::memory_order_acquire);
+        if (!(before & 1)) {
+            Snapshot s = load();
+            if (_seq.load(std::memory_order_relaxed) == before) return s;
+        }
+        _retries.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+uint32_t DeviceState::lock() {
+    uint32_t seq = _seq.load(std::memory_order_relaxed);
+    for (;;) {
+        // acquire: sieht, was der vorige Schreiber hinterlassen hat
+        if (!(seq & 1) && _seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+                                                      std::memory_order_relaxed)) {
+            break;
+        }
+        seq = _seq.load(std::memory_order_relaxed);
+    }
+    return seq + 1;
+}
+
+void DeviceState::unlock(uint32_t seq) {
+    _seq.store(seq + 1, std::memory_order_release);
+}
+
+// acquire: die zweite Sequenz-Abfrage in read() bleibt hinter den Feldern
+DeviceState::Snapshot DeviceState::load() const {
+    Snapshot s;
+    s.counter = _counter.load(std::memory_order_acquire);
+    uint8_t flags = _flags.load(std::memory_order_acquire);
+    s.led = flags & 1;
+    s.blink = flags & 2;
+    s.restartAt = _restartAt.load(std::memory_order_acquire);
+    return s;
+}
+
+// release: kein Feld wird vor der ungeraden Sequenz sichtbar
+void DeviceState::store(const Snapshot &s) {
+    _counter.store(s.counter, std::memory_order_release);
+    _flags.store((s.led ? 1 : 0) | (s.blink ? 2 : 0), std::memory_order_release);
+    _restartAt.store(s.restartAt, std::memory_order_release);
+}
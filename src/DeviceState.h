@@ -0,0 +1,77 @@
+#ifndef DEVICESTATE_H
+#define DEVICESTATE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+//----------------------------------------------------------------------------
+// DeviceState
+// Gerätezustand, den die Handler im AsyncTCP-Task und loop() gemeinsam
+// lesen und ändern (Zähler, LED, Blinken, geplanter Neustart). Seqlock:
+// Leser kopieren die Felder ohne Sperre und Allokation und wiederholen,
+// falls sich die Sequenz währenddessen geändert hat – sie sehen also immer
+// einen Stand, der so auch geschrieben wurde. Schreiber holen sich die
+// ungerade Sequenz per compare_exchange; ein zweiter Schreiber dreht
+// solange ein paar Runden, Schreibabschnitte sind nur einige Stores lang.
+//
+// Auf dem Gerät läuft der Schreibabschnitt in portENTER_CRITICAL: async_tcp
+// (Priorität 3, ohne Kernbindung) darf loop() dort nicht verdrängen, sonst
+// dreht ein Leser oder Schreiber auf demselben Kern für immer. Das Drehen
+// ist damit auf die Dauer von fn() auf dem anderen Kern begrenzt.
+//
+// Alle Felder sind Atomics (acquire/release statt Fences), damit auch ein
+// Leser, der gleich verwirft, kein Data Race hat und ThreadSanitizer die
+// Ordnung nachvollziehen kann (test_devicestate, env:native_tsan).
+//----------------------------------------------------------------------------
+class DeviceState {
+public:
+    struct Snapshot {
+        int32_t  counter = 0;
+        bool     led = false;
+        bool     blink = false;
+        uint32_t restartAt = 0;     // millis(), 0 = kein Neustart geplant
+    };
+
+    Snapshot read() const;
+
+    // fn(Snapshot&) ändert den aktuellen Stand; liefert den neuen. fn läuft
+    // auf dem Gerät ohne Interrupts: nur Felder setzen, kein Serial, kein new
+    template <typename Fn>
+    Snapshot update(Fn &&fn) {
+        enterWriter();
+        uint32_t seq = lock();
+        Snapshot s = load();
+        fn(s);
+        store(s);
+        unlock(seq);
+        exitWriter();
+        return s;
+    }
+
+    // Leser, die wegen eines gleichzeitigen Schreibers wiederholen mussten
+    uint32_t retries() const { return _retries.load(std::memory_order_relaxed); }
+
+private:
+    uint32_t lock();
+    void unlock(uint32_t seq);
+    Snapshot load() const;
+    void store(const Snapshot &s);
+
+#ifdef ARDUINO_ARCH_ESP32
+    void enterWriter() { portENTER_CRITICAL(&_writer); }
+    void exitWriter()  { portEXIT_CRITICAL(&_writer); }
+    portMUX_TYPE _writer = portMUX_INITIALIZER_UNLOCKED;
+#else
+    // Host: Threads werden nicht dauerhaft verdrängt
+    void enterWriter() {}
+    void exitWriter()  {}
+#endif
+
+    std::atomic<uint32_t> _seq{0};          // ungerade = Schreiber aktiv
+    std::atomic<int32_t>  _counter{0};
+    std::atomic<uint8_t>  _flags{0};        // bit0 led, bit1 blink
+    std::atomic<uint32_t> _restartAt{0};
+    mutable std::atomic<uint32_t> _retries{0};
+};
+
+#endif
@@ -0,0 +1,59 @@
+#include "EspWifiDriver.h"
+
+void EspWifiDriver::configureAp(const String &ssid, const String &password,
+                                IPAddress ip, IPAddress gateway, IPAddress subnet) {
+    _apSsid = ssid;
+    _apPassword = password;
+    _apIP = ip;
+    _apGW = gateway;
+    _apSN = subnet;
+}
+
+void EspWifiDriver::attach(WifiManager &manager) {
+    WiFi.persistent(false);
+    WiFi.setAutoReconnect(false);
+    // Läuft im Event-Task: nur Flag setzen, Auswertung in WifiManager::loop()
+    WiFi.onEvent([&manager](arduino_event_id_t event, arduino_event_info_t info) {
+        switch (event) {
+            case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+                manager.notify(WifiManager::EV_GOT_IP);
+                break;
+            case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+                manager.notify(WifiManager::EV_DISCONNECTED);
+                break;
+            default:
+                break;
+        }
+    });
+}
+
+void EspWifiDriver::connectSta(const String &ssid, const String &password) {
+    WiFi.mode((WiFi.getMode() & WIFI_AP) ? WIFI_AP_STA : WIFI_STA);
+    WiFi.begin(ssid.c_str(), password.c_str());
+}
+
+void EspWifiDriver::disconnectSta() {
+    WiFi.disconnect(false, false);
+}
+
+bool EspWifiDriver::staConnected() {
+    return WiFi.status() == WL_CONNECTED;
+}
+
+void EspWifiDriver::startAp() {
+    WiFi.mode((WiFi.getMode() & WIFI_STA) ? WIFI_AP_STA : WIFI_AP);
+    WiFi.softAPConfig(_apIP, _apGW, _apSN);
+    WiFi.softAP(_apSsid.c_str(), _apPassword.c_str());
+    Serial.printf("📶 AP gestartet: SSID=%s, PASS=%s\n", _apSsid.c_str(), _apPassword.c_str());
+    Serial.print("🌐 AP-IP: "); Serial.println(WiFi.softAPIP());
+}
+
+void EspWifiDriver::stopAp() {
+    WiFi.softAPdisconnect(false);
+    WiFi.mode(WIFI_STA);
+}
+
+uint8_t EspWifiDriver::apStations() {
+    return WiFi.softAPgetStationNum();
+}
@@ -0,0 +1,34 @@
+#ifndef ESPWIFIDRIVER_H
+#define ESPWIFIDRIVER_H
+
+#include <WiFi.h>
+#include "WifiManager.h"
+
+//----------------------------------------------------------------------------
+// EspWifiDriver
+// WifiDriver für den ESP32 (Arduino WiFi). Meldet GOT_IP / Disconnect über
+// WiFi.onEvent an den WifiManager. Automatisches Reconnect des Cores ist aus,
+// Wiederholungen steuert der WifiManager.
+//----------------------------------------------------------------------------
+class EspWifiDriver : public WifiDriver {
+public:
+    void configureAp(const String &ssid, const String &password,
+                     IPAddress ip, IPAddress gateway, IPAddress subnet);
+    void attach(WifiManager &manager);
+
+    void connectSta(const String &ssid, const String &password) override;
+    void disconnectSta() override;
+    bool staConnected() override;
+    void startAp() override;
+    void stopAp() override;
+    uint8_t apStations() override;
+
+private:
+    String _apSsid;
+    String _apPassword;
+    IPAddress _apIP;
+    IPAddress _apGW;
+    IPAddress _apSN;
+};
+
+#endif
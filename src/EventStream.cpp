@@ -0,0 +1,101 @@
+#include "EventStream.h"
+
+// Reihenfolge wie EventStream::Field
+static const char *const kKeys[EventStream::FIELD_COUNT] = { "counter", "uptime", "led", "free_heap" };
+
+// ids laufen modulo 2^32 und lassen die 0 aus: mit id 0 sendet AsyncEventSource
+// keine id-Zeile, der Browser behielte seine alte Last-Event-ID
+static uint32_t nextId(uint32_t id) {
+    return id + 1 == 0 ? 1 : id + 1;
+}
+
+void EventStream::begin(uint16_t epoch) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _lastId = (uint32_t)epoch << kEpochShift;
+    }
+    _source.onConnect([this](AsyncEventSourceClient *client) { onConnect(client); });
+}
+
+void EventStream::set(Field field, int32_t value) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry &e = _fields[field];
+    if (e.version != 0 && e.value == value) return;
+    e.value = value;
+    e.version = ++_version;
+}
+
+// Felder mit Version > since (full: alle) als JSON-Objekt; 0 = nichts zu senden
+size_t EventStream::format(char *out, size_t cap, uint32_t since, bool full) const {
+    size_t len = snprintf(out, cap, full ? "{\"full\":true" : "{");
+    size_t fields = 0;
+    for (uint8_t i = 0; i < FIELD_COUNT && len < cap; i++) {
+        const Entry &e = _fields[i];
+        if (e.version == 0 || (!full && e.version <= since)) continue;
+        const char *sep = (full || fields) ? "," : "";
+        if (i == LED) len += snprintf(out + len, cap - len, "%s\"%s\":%s", sep, kKeys[i], e.value ? "true" : "false");
+        else          len += snprintf(out + len, cap - len, "%s\"%s\":%ld", sep, kKeys[i], (long)e.value);
+        fields++;
+    }
+    if (len < cap) len += snprintf(out + len, cap - len, "}");
+    return (fields && len < cap) ? fields : 0;
+}
+
+size_t EventStream::publish() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_version == _sentVersion) return 0;
+    uint32_t id = nextId(_lastId);
+    Event &ev = _history[id % kHistory];
+    size_t fields = format(ev.data, sizeof(ev.data), _sentVersion, false);
+    _sentVersion = _version;
+    if (!fields) return 0;
+    ev.id = _lastId = id;
+    _stats.events++;
+    // unter dem Mutex: ein gleichzeitig verbindender Client bekommt das
+    // Event entweder hier oder beim Nachreichen, nie zu spät
+    if (_source.count()) _source.send(ev.data, "state", ev.id);
+    return fields;
+}
+
+bool EventStream::publishStatus(const char *json) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_source.count()) return false;
+    _source.send(json, "status");
+    _stats.statusEvents++;
+    return true;
+}
+
+void EventStream::onConnect(AsyncEventSourceClient *client) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    // modulo 2^32: ids laufen über die Epoche hinaus weiter; eine id aus einem
+    // anderen Lauf liegt weit daneben (andere Epoche) und wird nicht fortgesetzt
+    uint32_t since = client->lastId();
+    uint32_t behind = _lastId - since;
+    if (since > _lastId) behind--;          // über den Überlauf, die 0 fehlt
+    uint32_t first = nextId(since);
+    bool resumable = since != 0 && behind <= kHistory
+                     && (behind == 0 || _history[first % kHistory].id == first);
+    if (resumable) {
+        uint32_t id = since;
+        for (uint32_t k = 1; k <= behind; k++) {
+            id = nextId(id);
+            client->send(_history[id % kHistory].data, "state", id, k == 1 ? kRetryMs : 0);
+            _stats.replayed++;
+        }
+        return;
+    }
+    char data[kMaxEvent];
+    if (!format(data, sizeof(data), 0, true)) return;   // noch nichts gesetzt
+    client->send(data, "state", _lastId, kRetryMs);
+    _stats.snapshots++;
+}
+
+EventStream::Stats EventStream::stats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+uint32_t EventStream::lastId() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _lastId;
+}
@@ -0,0 +1,86 @@
+#ifndef EVENTSTREAM_H
+#define EVENTSTREAM_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <mutex>
+
+//----------------------------------------------------------------------------
+// EventStream
+// Live-Daten für Seiten, die nur lesen, als Server-Sent Events (/events)
+// statt Polling. Wie StateChannel merkt sich jedes Feld die Version seiner
+// letzten Änderung; publish() formatiert die geänderten Felder einmal als
+// Event "state" mit fortlaufender id und übergibt es der AsyncEventSource
+// für alle Abonnenten.
+//
+// Die letzten kHistory Events bleiben stehen: ein Browser, der mit
+// Last-Event-ID wiederverbindet, bekommt die verpassten nachgereicht, sonst
+// (neu oder zu lange weg) einen vollständigen Stand mit "full":true. Events
+// sind Zustands-Deltas; doppelt ankommende schaden nicht.
+//
+// Die oberen 16 Bit der id sind eine Epoche je Start (begin(esp_random())).
+// Nach einem Neustart passt eine Last-Event-ID aus dem alten Lauf nicht mehr
+// zur Historie, der Browser bekommt dann den vollständigen Stand statt der
+// Deltas eines anderen Laufs mit zufällig gleicher Nummer. Bei hoher Epoche
+// laufen die ids über 2^32 hinaus weiter und lassen dabei die 0 aus.
+//
+// publishStatus() sendet zusätzlich jeden neuen Stand von /status.json
+// (StatusSnapshot) als Event "status" ohne id: Last-Event-ID bleibt bei den
+// Deltas, verpasste Stände werden nicht nachgereicht, der nächste ersetzt sie.
+//
+// set()/publish() aus loop(), onConnect läuft im AsyncTCP-Task; der
+// gemeinsame Zustand ist per Mutex geschützt.
+//----------------------------------------------------------------------------
+class EventStream {
+public:
+    enum Field : uint8_t { COUNTER, UPTIME, LED, FREE_HEAP, FIELD_COUNT };
+
+    static constexpr size_t kHistory = 16;
+    static constexpr size_t kMaxEvent = 96;         // alle Felder als JSON
+    static constexpr uint32_t kRetryMs = 2000;      // Wiederverbinden im Browser
+    static constexpr uint32_t kEpochShift = 16;
+
+    explicit EventStream(AsyncEventSource &source) : _source(source) {}
+
+    // onConnect der Quelle übernehmen; epoch je Start verschieden, 0 = ids ab 1
+    void begin(uint16_t epoch = 0);
+
+    void set(Field field, int32_t value);
+    // Sendet geänderte Felder als ein Event; liefert Anzahl Felder
+    size_t publish();
+    // Fertiges Status-JSON als Event "status" an alle Abonnenten; false = keiner da
+    bool publishStatus(const char *json);
+
+    struct Stats {
+        uint32_t events = 0;
+        uint32_t replayed = 0;      // beim Wiederverbinden nachgereicht
+        uint32_t snapshots = 0;     // vollständige Stände an neue Clients
+        uint32_t statusEvents = 0;  // publishStatus() mit Abonnenten
+    };
+    Stats stats() const;
+    uint32_t lastId() const;
+
+private:
+    struct Entry {
+        int32_t  value = 0;
+        uint32_t version = 0;
+    };
+    struct Event {
+        uint32_t id = 0;
+        char     data[kMaxEvent];
+    };
+
+    void onConnect(AsyncEventSourceClient *client);
+    size_t format(char *out, size_t cap, uint32_t since, bool full) const;
+
+    AsyncEventSource &_source;
+    mutable std::mutex _mutex;
+    Entry _fields[FIELD_COUNT];
+    uint32_t _version = 0;
+    uint32_t _sentVersion = 0;
+    Event _history[kHistory];
+    uint32_t _lastId = 0;
+    Stats _stats;
+};
+
+#endif
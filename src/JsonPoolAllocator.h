@@ -0,0 +1,49 @@
+#ifndef JSONPOOLALLOCATOR_H
+#define JSONPOOLALLOCATOR_H
+
+#include <ArduinoJson.h>
+#include <stddef.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------
+// JsonPoolAllocator
+// ArduinoJson-Allocator auf einem festen Puffer (Bump-Allocator). Ein
+// JsonDocument mit diesem Allocator parst ohne Heap; reicht der Puffer nicht,
+// meldet deserializeJson NoMemory. Nach jedem Dokument reset() aufrufen.
+//----------------------------------------------------------------------------
+template <size_t N>
+class JsonPoolAllocator : public ArduinoJson::Allocator {
+public:
+    void* allocate(size_t size) override {
+        size_t need = align(sizeof(size_t) + size);
+        if (_used + need > N) return nullptr;
+        uint8_t *block = _pool + _used;
+        memcpy(block, &size, sizeof(size_t));
+        _used += need;
+        return block + sizeof(size_t);
+    }
+
+    // einzelne Blöcke werden nicht freigegeben, erst mit reset()
+    void deallocate(void*) override {}
+
+    void* reallocate(void *ptr, size_t newSize) override {
+        if (!ptr) return allocate(newSize);
+        size_t oldSize;
+        memcpy(&oldSize, (uint8_t*)ptr - sizeof(size_t), sizeof(size_t));
+        if (newSize <= oldSize) return ptr;
+        void *fresh = allocate(newSize);
+        if (fresh) memcpy(fresh, ptr, oldSize);
+        return fresh;
+    }
+
+    void reset() { _used = 0; }
+    size_t used() const { return _used; }
+
+private:
+    static size_t align(size_t n) { return (n + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1); }
+
+    alignas(max_align_t) uint8_t _pool[N];
+    size_t _used = 0;
+};
+
+#endif
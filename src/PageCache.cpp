@@ -0,0 +1,64 @@
+#include "PageCache.h"
+
+PageCache::EntryPtr PageCache::find(const char *route, uint32_t key) {
+    auto it = _entries.find(route);
+    if (it == _entries.end() || it->second.key != key) {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    _hits.fetch_add(1, std::memory_order_relaxed);
+    it->second.lastUse = ++_clock;
+    return it->second.entry;
+}
+
+PageCache::EntryPtr PageCache::store(const char *route, uint32_t key, std::shared_ptr<Entry> entry) {
+    auto it = _entries.find(route);
+    if (it != _entries.end()) {
+        _bytes -= it->second.entry->bytes();
+        _entries.erase(it);
+    }
+    // Zu große Seiten nicht cachen, nur ausliefern
+    if (entry->bytes() > _maxBytes) return entry;
+
+    _entries[route] = Slot{key, ++_clock, entry};
+    _bytes += entry->bytes();
+    evict();
+    return entry;
+}
+
+// Älteste Einträge verwerfen, bis Anzahl und Bytes wieder im Rahmen sind.
+// Laufende Responses halten ihren Eintrag über den shared_ptr selbst.
+void PageCache::evict() {
+    while (!_entries.empty() && (_entries.size() > _maxEntries || _bytes > _maxBytes)) {
+        auto oldest = _entries.begin();
+        for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+            if (it->second.lastUse < oldest->second.lastUse) oldest = it;
+        }
+        _bytes -= oldest->second.entry->bytes();
+        _entries.erase(oldest);
+        _evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void PageCache::invalidate(const char *route) {
+    auto it = _entries.find(route);
+    if (it == _entries.end()) return;
+    _bytes -= it->second.entry->bytes();
+    _entries.erase(it);
+    _invalidations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PageCache::clear() {
+    _invalidations.fetch_add(_entries.size(), std::memory_order_relaxed);
+    _entries.clear();
+    _bytes = 0;
+}
+
+PageCache::Stats PageCache::stats() const {
+    Stats s;
+    s.hits = _hits.load(std::memory_order_relaxed);
+    s.misses = _misses.load(std::memory_order_relaxed);
+    s.evictions = _evictions.load(std::memory_order_relaxed);
+    s.invalidations = _invalidations.load(std::memory_order_relaxed);
+    return s;
+}
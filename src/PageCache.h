@@ -0,0 +1,175 @@
+#ifndef PAGECACHE_H
+#define PAGECACHE_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+#include "TemplateEngine.h"
+
+//----------------------------------------------------------------------------
+// PageCache
+// Hält pro Route die fertig gerenderte Seite. Schlüssel ist ein Hash über die
+// stabilen Slot-Werte; ändert sich einer (z.B. AP_SSID), passt der Schlüssel
+// nicht mehr und die Seite wird neu gerendert. Volatile Slots (UPTIME,
+// CUR_COUNTER, ...) bleiben im Cache als Lücke stehen und werden bei jedem
+// Request frisch eingesetzt.
+//
+// Values: beliebiger Typ mit  const String* get(int slot) const
+// (TemplateEngine::SlotMap, SlotValues<Slot>).
+//----------------------------------------------------------------------------
+class PageCache {
+public:
+    // Zähler aus den Handlern, lesbar aus loop() (/status.json)
+    struct Stats {
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+        uint32_t evictions = 0;
+        uint32_t invalidations = 0;
+    };
+
+    class Entry {
+    public:
+        const std::vector<TemplateEngine::Segment>& segments() const { return _segments; }
+        size_t bytes() const { return _text.length() + _segments.size() * sizeof(TemplateEngine::Segment); }
+    private:
+        friend class PageCache;
+        String _text;                                   // gerenderter Text inkl. "%NAME%" der Lücken
+        std::vector<TemplateEngine::Segment> _segments; // zeigen in _text
+    };
+    using EntryPtr = std::shared_ptr<const Entry>;
+
+    PageCache(size_t maxEntries = 6, size_t maxBytes = 16 * 1024)
+    : _maxEntries(maxEntries), _maxBytes(maxBytes) {}
+
+    static uint32_t slotMask(std::initializer_list<int> slots) {
+        uint32_t mask = 0;
+        for (int s : slots) if (s >= 0 && s < 32) mask |= 1u << s;
+        return mask;
+    }
+
+    // Liefert die gecachte Seite oder rendert sie neu (segments mit stabilen Werten)
+    template <typename Values>
+    EntryPtr fetch(const char *route, const TemplateEngine::Segment *segments, size_t count,
+                   size_t slotCount, const Values &values, uint32_t volatileMask) {
+        uint32_t key = hashValues(values, slotCount, volatileMask);
+        EntryPtr entry = find(route, key);
+        if (entry) return entry;
+        return store(route, key, render(segments, count, values, volatileMask));
+    }
+
+    // Streamt die Seite, Lücken werden aus values gefüllt
+    template <typename Values>
+    static AsyncWebServerResponse* beginResponse(AsyncWebServerRequest *request, EntryPtr entry,
+                                                 Values values, const char *contentType = "text/html") {
+        struct State {
+            EntryPtr entry;
+            Values   values;
+            size_t   seg = 0;
+            size_t   pos = 0;
+            RouteMetrics::Meter meter = RouteMetrics::current();
+        };
+        auto state = std::make_shared<State>(State{std::move(entry), std::move(values)});
+        return request->beginChunkedResponse(contentType,
+            [state](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                const auto &segments = state->entry->segments();
+                return state->meter.fill([&] {
+                    return TemplateEngine::fillSegments(segments.data(), segments.size(),
+                                                        [&state](int slot) { return state->values.get(slot); },
+                                                        state->seg, state->pos, buffer, maxLen);
+                });
+            });
+    }
+
+    void invalidate(const char *route);
+    void clear();
+    Stats stats() const;
+    size_t bytes() const { return _bytes; }
+
+private:
+    struct Slot {
+        uint32_t key;
+        uint32_t lastUse;
+        EntryPtr entry;
+    };
+
+    EntryPtr find(const char *route, uint32_t key);
+    EntryPtr store(const char *route, uint32_t key, std::shared_ptr<Entry> entry);
+    void evict();
+
+    static uint32_t fnv1a(uint32_t h, const char *data, size_t len) {
+        for (size_t i = 0; i < len; i++) {
+            h ^= (uint8_t)data[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    template <typename Values>
+    static uint32_t hashValues(const Values &values, size_t slotCount, uint32_t volatileMask) {
+        uint32_t h = 2166136261u;
+        for (size_t s = 0; s < slotCount; s++) {
+            if (s < 32 && (volatileMask & (1u << s))) continue;
+            const String *v = values.get((int)s);
+            char tag[2] = { (char)s, (char)(v ? 1 : 0) };
+            h = fnv1a(h, tag, sizeof(tag));
+            if (v) h = fnv1a(h, v->c_str(), v->length());
+        }
+        return h;
+    }
+
+    // Stabile Slots werden eingesetzt, benachbarte Literale zu einem Segment zusammengefasst
+    template <typename Values>
+    static std::shared_ptr<Entry> render(const TemplateEngine::Segment *segments, size_t count,
+                                         const Values &values, uint32_t volatileMask) {
+        struct Range { size_t offset; size_t len; int16_t slot; };
+        std::vector<Range> ranges;
+        auto entry = std::make_shared<Entry>();
+        String &text = entry->_text;
+
+        for (size_t i = 0; i < count; i++) {
+            const TemplateEngine::Segment &s = segments[i];
+            bool hole = s.slot >= 0 && s.slot < 32 && (volatileMask & (1u << s.slot));
+            const String *v = (s.slot >= 0 && !hole) ? values.get(s.slot) : nullptr;
+            size_t offset = text.length();
+            if (v) text += *v;
+            else   text.concat(s.data, s.len);
+            size_t len = text.length() - offset;
+            if (hole) {
+                ranges.push_back({offset, len, s.slot});
+            } else if (!ranges.empty() && ranges.back().slot < 0) {
+                ranges.back().len += len;
+            } else {
+                ranges.push_back({offset, len, -1});
+            }
+        }
+
+        // erst jetzt zeigen die Segmente in den endgültigen Puffer
+        const char *base = text.c_str();
+        for (const Range &r : ranges) {
+            size_t offset = r.offset;
+            size_t left = r.len;
+            do {
+                uint16_t part = left > 0xFFFF ? 0xFFFF : (uint16_t)left;
+                entry->_segments.push_back({base + offset, part, r.slot});
+                offset += part;
+                left -= part;
+            } while (left > 0);
+        }
+        return entry;
+    }
+
+    size_t _maxEntries;
+    size_t _maxBytes;
+    size_t _bytes = 0;
+    uint32_t _clock = 0;
+    std::map<String, Slot> _entries;
+    std::atomic<uint32_t> _hits{0};
+    std::atomic<uint32_t> _misses{0};
+    std::atomic<uint32_t> _evictions{0};
+    std::atomic<uint32_t> _invalidations{0};
+};
+
+#endif
@@ -0,0 +1,220 @@
+#include "RouteMetrics.h"
+
+const uint32_t RouteMetrics::kBucketUs[kBuckets] = {
+    100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000
+};
+
+RouteMetrics::Route *RouteMetrics::_current = nullptr;
+uint32_t RouteMetrics::_currentId = 0;
+std::atomic<uint32_t> RouteMetrics::_inFlight{0};
+
+static void recordMin(std::atomic<uint32_t> &target, uint32_t value) {
+    uint32_t seen = target.load(std::memory_order_relaxed);
+    while (value < seen && !target.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+void RouteMetrics::recordMax(std::atomic<uint32_t> &target, uint32_t value) {
+    uint32_t seen = target.load(std::memory_order_relaxed);
+    while (value > seen && !target.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+void RouteMetrics::recordLatency(Route &route, uint32_t us) {
+    size_t b = 0;
+    while (b < kBuckets && us > kBucketUs[b]) b++;
+    route.buckets[b].fetch_add(1, std::memory_order_relaxed);
+    route.latencySumUs.fetch_add(us, std::memory_order_relaxed);
+}
+
+RouteMetrics::Route* RouteMetrics::add(const char *uri, WebRequestMethodComposite method) {
+    if (_count >= kMaxRoutes) return nullptr;
+    Route *route = &_routes[_count++];
+    route->uri = uri;
+    route->method = method;
+    return route;
+}
+
+ArRequestHandlerFunction RouteMetrics::wrap(const char *uri, WebRequestMethodComposite method,
+                                            ArRequestHandlerFunction fn) {
+    Route *route = add(uri, method);
+    if (!route) return fn;
+    return [this, route, fn](AsyncWebServerRequest *request) {
+        Scope scope(this, route, request);
+        fn(request);
+    };
+}
+
+RouteMetrics::Scope::Scope(RouteMetrics *metrics, Route *route, AsyncWebServerRequest *request)
+: _metrics(metrics), _route(route), _outer(_current), _outerId(_currentId) {
+    if (!_route) return;
+    _start = micros();
+    _freeBefore = ESP.getFreeHeap();
+    _route->requests.fetch_add(1, std::memory_order_relaxed);
+    _inFlight.fetch_add(1, std::memory_order_relaxed);
+    // zwei Werte im Capture: passt in std::function ohne Allokation
+    uint32_t start = _start;
+    request->onDisconnect([route, start] {
+        _inFlight.fetch_sub(1, std::memory_order_relaxed);
+        recordLatency(*route, micros() - start);
+        TRACE_COMPLETE(REQUEST, start, start, route->uri, 0);
+        TRACE_INSTANT(SEND_DONE, start, route->uri);
+    });
+    _current = _route;
+    _currentId = _start;
+}
+
+RouteMetrics::Scope::~Scope() {
+    if (!_route) return;
+    _current = _outer;
+    _currentId = _outerId;
+    TRACE_COMPLETE(HANDLER, _start, _start, _route->uri, 0);
+    TRACE_INSTANT(SEND_QUEUED, _start, _route->uri);
+
+    uint32_t freeAfter = ESP.getFreeHeap();
+    uint32_t held = _freeBefore > freeAfter ? _freeBefore - freeAfter : 0;
+    _route->heapSum.fetch_add(held, std::memory_order_relaxed);
+    recordMax(_route->heapMax, held);
+    recordMin(_metrics->_minFreeHeap, freeAfter);
+}
+
+void RouteMetrics::sampleHeap() {
+    recordMin(_minFreeHeap, ESP.getFreeHeap());
+}
+
+//----------------------------------------------------------------------------
+// Prometheus-Textformat
+//----------------------------------------------------------------------------
+namespace {
+
+enum Family {
+    REQUESTS, ERRORS, BYTES, DURATION, HEAP_SUM, HEAP_MAX, IN_FLIGHT, FREE_HEAP, MIN_FREE_HEAP, FAMILY_COUNT
+};
+
+struct FamilyInfo {
+    const char *name;
+    const char *type;
+    const char *help;
+    bool perRoute;
+};
+
+const FamilyInfo kFamilies[FAMILY_COUNT] = {
+    {"http_requests_total",           "counter",   "Requests pro Route", true},
+    {"http_request_errors_total",     "counter",   "Antworten mit Status >= 400", true},
+    {"http_response_bytes_total",     "counter",   "Gesendete Body-Bytes", true},
+    {"http_request_duration_seconds", "histogram", "Handler-Aufruf bis Verbindungsende", true},
+    {"http_request_heap_bytes_total", "counter",   "Heap, den die Antworten nach dem Handler belegten (Summe)", true},
+    {"http_request_heap_max_bytes",   "gauge",     "Größter Heap einer Antwort nach dem Handler", true},
+    {"http_requests_in_flight",       "gauge",     "Requests zwischen Handler-Aufruf und Verbindungsende", false},
+    {"esp_free_heap_bytes",           "gauge",     "Freier Heap", false},
+    {"esp_min_free_heap_bytes",       "gauge",     "Kleinster gesehener freier Heap", false},
+};
+
+const char* methodName(WebRequestMethodComposite method) {
+    switch (method) {
+        case HTTP_GET:     return "GET";
+        case HTTP_POST:    return "POST";
+        case HTTP_DELETE:  return "DELETE";
+        case HTTP_PUT:     return "PUT";
+        case HTTP_PATCH:   return "PATCH";
+        case HTTP_HEAD:    return "HEAD";
+        case HTTP_OPTIONS: return "OPTIONS";
+        default:           return "ANY";
+    }
+}
+
+uint32_t load(const std::atomic<uint32_t> &value) {
+    return value.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+bool RouteMetrics::nextLine(Cursor &cursor, char *out, size_t cap) const {
+    while (cursor.family < FAMILY_COUNT) {
+        const FamilyInfo &f = kFamilies[cursor.family];
+        size_t perRoute = cursor.family == DURATION ? kBuckets + 3 : 1;
+        size_t body = f.perRoute ? _count * perRoute : 1;
+        size_t line = cursor.line++;
+
+        if (line == 0) {
+            snprintf(out, cap, "# HELP %s %s", f.name, f.help);
+            return true;
+        }
+        if (line == 1) {
+            snprintf(out, cap, "# TYPE %s %s", f.name, f.type);
+            return true;
+        }
+        if (line - 2 >= body) {
+            cursor.family++;
+            cursor.line = 0;
+            continue;
+        }
+        if (!f.perRoute) {
+            uint32_t value = cursor.family == IN_FLIGHT ? inFlight()
+                           : cursor.family == FREE_HEAP ? ESP.getFreeHeap() : minFreeHeap();
+            snprintf(out, cap, "%s %u", f.name, (unsigned)value);
+            return true;
+        }
+
+        const Route &r = _routes[(line - 2) / perRoute];
+        const char *method = methodName(r.method);
+        switch (cursor.family) {
+            case REQUESTS: snprintf(out, cap, "%s{route=\"%s\",method=\"%s\"} %u", f.name, r.uri, method, (unsigned)load(r.requests)); break;
+            case ERRORS:   snprintf(out, cap, "%s{route=\"%s\",method=\"%s\"} %u", f.name, r.uri, method, (unsigned)load(r.errors)); break;
+            case BYTES:    snprintf(out, cap, "%s{route=\"%s\",method=\"%s\"} %u", f.name, r.uri, method, (unsigned)load(r.bytes)); break;
+            case HEAP_SUM: snprintf(out, cap, "%s{route=\"%s\",method=\"%s\"} %u", f.name, r.uri, method, (unsigned)load(r.heapSum)); break;
+            case HEAP_MAX: snprintf(out, cap, "%s{route=\"%s\",method=\"%s\"} %u", f.name, r.uri, method, (unsigned)load(r.heapMax)); break;
+            case DURATION: {
+                // Buckets sind kumulativ, +Inf = _count
+                size_t sub = (line - 2) % perRoute;
+                uint32_t cumulative = 0;
+                size_t upTo = sub <= kBuckets ? sub : kBuckets;
+                for (size_t b = 0; b <= upTo; b++) cumulative += load(r.buckets[b]);
+                if (sub < kBuckets) {
+                    snprintf(out, cap, "%s_bucket{route=\"%s\",method=\"%s\",le=\"%g\"} %u",
+                             f.name, r.uri, method, kBucketUs[sub] / 1e6, (unsigned)cumulative);
+                } else if (sub == kBuckets) {
+                    snprintf(out, cap, "%s_bucket{route=\"%s\",method=\"%s\",le=\"+Inf\"} %u",
+                             f.name, r.uri, method, (unsigned)cumulative);
+                } else if (sub == kBuckets + 1) {
+                    snprintf(out, cap, "%s_sum{route=\"%s\",method=\"%s\"} %.6f",
+                             f.name, r.uri, method, load(r.latencySumUs) / 1e6);
+                } else {
+                    snprintf(out, cap, "%s_count{route=\"%s\",method=\"%s\"} %u",
+                             f.name, r.uri, method, (unsigned)cumulative);
+                }
+                break;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+AsyncWebServerResponse* RouteMetrics::beginResponse(AsyncWebServerRequest *request) const {
+    // Zeile für Zeile in die TCP-Segmente, ohne die ganze Ausgabe im RAM
+    struct State {
+        Cursor cursor;
+        Meter  meter = current();
+        char   line[224];
+        size_t len = 0;
+        size_t pos = 0;
+    };
+    auto state = std::make_shared<State>();
+    return request->beginChunkedResponse("text/plain; version=0.0.4",
+        [this, state](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+            size_t n = 0;
+            while (n < maxLen) {
+                if (state->pos == state->len) {
+                    if (!nextLine(state->cursor, state->line, sizeof(state->line) - 1)) break;
+                    state->len = strlen(state->line);
+                    state->line[state->len++] = '\n';
+                    state->pos = 0;
+                }
+                size_t copy = std::min(state->len - state->pos, maxLen - n);
+                memcpy(buffer + n, state->line + state->pos, copy);
+                state->pos += copy;
+                n += copy;
+            }
+            state->meter.sent(n);
+            return n;
+        });
+}
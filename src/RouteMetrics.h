@@ -0,0 +1,129 @@
+#ifndef ROUTEMETRICS_H
+#define ROUTEMETRICS_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <atomic>
+#include <memory>
+#include "TraceBuffer.h"
+
+//----------------------------------------------------------------------------
+// RouteMetrics
+// Kennzahlen pro Route, eingehängt über wrap() bzw. Scope um jeden Handler
+// aus setupRoutes() und der RouteTable: Anzahl Requests und Fehler (Status
+// >= 400), Latenz als Histogramm mit festen, logarithmisch gestuften Grenzen, gesendete Bytes,
+// Heap, den die Antwort beim Verlassen des Handlers belegt, und der kleinste
+// je gesehene freie Heap. Ausgabe im Prometheus-Textformat (beginResponse).
+//
+// Die Latenz läuft vom Aufruf des Handlers bis zum Schließen der Verbindung
+// (onDisconnect), enthält also das Senden. ESPAsyncWebServer gibt die
+// Antwort des Requests nicht heraus; Status und Bytes meldet deshalb der
+// Code, der die Antwort erzeugt, über einen Meter (current()) – die
+// Renderer von TemplateEngine, PageCache und StaticPage zählen beim fill().
+// Mit -DWEB_TRACE landen dieselben Zeitpunkte zusätzlich im TraceBuffer.
+//
+// Erfassen ist lock-frei (32-Bit-Atomics, relaxed) und allokiert nicht.
+// Zähler laufen bei 2^32 über; für Prometheus ist das ein Reset.
+//----------------------------------------------------------------------------
+class RouteMetrics {
+public:
+    static constexpr size_t kMaxRoutes = 24;
+    static constexpr size_t kBuckets = 13;              // dazu +Inf
+    static const uint32_t kBucketUs[kBuckets];
+
+    struct Route {
+        const char *uri = nullptr;
+        WebRequestMethodComposite method = 0;
+        std::atomic<uint32_t> requests{0};
+        std::atomic<uint32_t> errors{0};
+        std::atomic<uint32_t> bytes{0};
+        std::atomic<uint32_t> latencySumUs{0};
+        std::atomic<uint32_t> heapSum{0};
+        std::atomic<uint32_t> heapMax{0};
+        std::atomic<uint32_t> buckets[kBuckets + 1] = {};
+    };
+
+    // Zählt für die Route, deren Handler beim Erzeugen lief; leer = nichts.
+    // id = Start des Requests in µs, zugleich Spur im TraceBuffer.
+    class Meter {
+    public:
+        Meter(Route *route = nullptr, uint32_t id = 0) : _route(route), _id(id) {}
+        void sent(size_t bytes) const {
+            if (_route) _route->bytes.fetch_add((uint32_t)bytes, std::memory_order_relaxed);
+        }
+        void status(int code) const {
+            if (_route && code >= 400) _route->errors.fetch_add(1, std::memory_order_relaxed);
+        }
+        uint32_t id() const { return _id; }
+        // Ein fill() der Antwort: Bytes zählen, Dauer in den TraceBuffer
+        template <typename Fill>
+        size_t fill(Fill &&fn) const {
+            TRACE_START(start);
+            size_t n = fn();
+            sent(n);
+            TRACE_COMPLETE(RENDER, start, _id, nullptr, n);
+            return n;
+        }
+    private:
+        Route *_route;
+        uint32_t _id;
+    };
+
+    // Misst einen Handleraufruf vom Konstruktor bis zum Destruktor, die Latenz
+    // bis onDisconnect; route == nullptr misst nichts (metrics darf dann fehlen)
+    class Scope {
+    public:
+        Scope(RouteMetrics *metrics, Route *route, AsyncWebServerRequest *request);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        RouteMetrics *_metrics;
+        Route *_route;
+        Route *_outer;
+        uint32_t _outerId;
+        uint32_t _start;
+        uint32_t _freeBefore;
+    };
+
+    // Route anlegen; nullptr = Tabelle voll
+    Route* add(const char *uri, WebRequestMethodComposite method);
+    Route* at(size_t i) { return i < _count ? &_routes[i] : nullptr; }
+
+    // Handler mit Messung; bei voller Tabelle unverändert
+    ArRequestHandlerFunction wrap(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction fn);
+
+    // Meter des gerade laufenden Handlers (Handler laufen nacheinander im AsyncTCP-Task)
+    static Meter current() { return Meter(_current, _currentId); }
+    // Requests vom Handler-Aufruf bis Verbindungsende, der laufende eingeschlossen
+    static uint32_t inFlight() { return _inFlight.load(std::memory_order_relaxed); }
+
+    // freien Heap auch außerhalb von Requests beobachten (loop())
+    void sampleHeap();
+
+    size_t routes() const { return _count; }
+    const Route& route(size_t i) const { return _routes[i]; }
+    uint32_t minFreeHeap() const { return _minFreeHeap.load(std::memory_order_relaxed); }
+
+    AsyncWebServerResponse* beginResponse(AsyncWebServerRequest *request) const;
+
+    // Eine Zeile der Ausgabe (ohne Zeilenende) nach out, false = fertig
+    struct Cursor {
+        size_t family = 0;
+        size_t line = 0;
+    };
+    bool nextLine(Cursor &cursor, char *out, size_t cap) const;
+
+private:
+    static void recordMax(std::atomic<uint32_t> &target, uint32_t value);
+    static void recordLatency(Route &route, uint32_t us);
+
+    Route _routes[kMaxRoutes];
+    size_t _count = 0;
+    std::atomic<uint32_t> _minFreeHeap{UINT32_MAX};
+    static Route *_current;
+    static uint32_t _currentId;
+    static std::atomic<uint32_t> _inFlight;
+};
+
+#endif
@@ -0,0 +1,215 @@
+#ifndef ROUTETABLE_H
+#define ROUTETABLE_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "AdmissionControl.h"
+#include "RouteMetrics.h"
+
+//----------------------------------------------------------------------------
+// RouteTable
+// Feste Routen als constexpr-Tabelle {Pfad, Methode, Kosten, Member-Funktion}
+// statt einzelner AsyncCallbackWebHandler mit std::function. index() baut
+// daraus zur Compile-Zeit einen perfekten Hash über die Pfade (FNV-1a, dann
+// "hash and displace": je Bucket ein Verschiebewert, so dass jeder Pfad
+// einen eigenen Slot hat). Zur Laufzeit kostet ein Treffer einen Hash über
+// die URL und einen strcmp, unabhängig von der Anzahl der Routen.
+//
+// Dispatcher ist ein einziger AsyncWebHandler für die ganze Tabelle, ohne
+// Heap pro Route; Tabelle und Index liegen im Flash. Pfade gelten exakt
+// (kein "uri/..." wie bei server.on()). Was nicht passt – andere Pfade
+// oder Methoden – geht weiter durch die Handler-Kette (server.on(),
+// ElegantOTA, onNotFound).
+//
+//   static constexpr RouteTable::Route<Owner> kRoutes[] = {
+//       {"/counter", HTTP_GET, AdmissionControl::CHEAP, &Owner::handleCounter},
+//   };
+//   static constexpr auto kIndex = RouteTable::index(kRoutes);
+//   _routes.install(this, kRoutes, kIndex).metrics(&_metrics);
+//
+// Doppelte Pfade oder ein Index, der nicht aufgeht, brechen die Übersetzung
+// ab (Aufruf von duplicatePath() bzw. noPerfectHash() im constexpr-Kontext).
+//----------------------------------------------------------------------------
+namespace RouteTable {
+
+template <typename Owner>
+struct Route {
+    const char *path;
+    WebRequestMethodComposite method;
+    AdmissionControl::Cost cost;
+    void (Owner::*handler)(AsyncWebServerRequest *request);
+};
+
+// nur deklariert: erreicht index() sie, ist es kein konstanter Ausdruck mehr
+void duplicatePath();
+void noPerfectHash();
+
+constexpr size_t pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+constexpr uint32_t hash(const char *s, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+constexpr size_t length(const char *s) {
+    size_t n = 0;
+    while (s[n]) n++;
+    return n;
+}
+
+constexpr bool equal(const char *a, const char *b) {
+    while (*a && *a == *b) a++, b++;
+    return *a == *b;
+}
+
+// Slot eines Pfads bei Verschiebung d (fmix32 aus MurmurHash3)
+constexpr uint32_t mix(uint32_t h, uint16_t d) {
+    h ^= d * 0x9E3779B9u;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+// Perfekter Hash für N Pfade: höchstens halb belegte Slots, ~2 Pfade je Bucket
+template <size_t N>
+struct Index {
+    static constexpr size_t kSlots = pow2(2 * N);
+    static constexpr size_t kBuckets = pow2((N + 1) / 2);
+    static_assert(N > 0 && N < 0xFFFF, "RouteTable: 1 bis 65534 Routen");
+
+    uint16_t displace[kBuckets] = {};
+    uint16_t slots[kSlots] = {};        // Routenindex + 1, 0 = frei
+
+    constexpr size_t slot(uint32_t h) const {
+        return mix(h, displace[h & (kBuckets - 1)]) & (kSlots - 1);
+    }
+};
+
+template <typename Owner, size_t N>
+constexpr Index<N> index(const Route<Owner> (&routes)[N]) {
+    using I = Index<N>;
+    I idx;
+    uint32_t h[N] = {};
+    size_t bucketSize[I::kBuckets] = {};
+    size_t largest = 0;
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < i; j++) {
+            if (equal(routes[i].path, routes[j].path)) duplicatePath();
+        }
+        h[i] = hash(routes[i].path, length(routes[i].path));
+        size_t b = h[i] & (I::kBuckets - 1);
+        if (++bucketSize[b] > largest) largest = bucketSize[b];
+    }
+    // volle Buckets zuerst, solange noch viele Slots frei sind
+    for (size_t size = largest; size > 0; size--) {
+        for (size_t b = 0; b < I::kBuckets; b++) {
+            if (bucketSize[b] != size) continue;
+            bool placed = false;
+            for (uint32_t d = 0; d < 0x10000 && !placed; d++) {
+                size_t taken[N] = {};
+                size_t count = 0;
+                bool ok = true;
+                for (size_t i = 0; i < N && ok; i++) {
+                    if ((h[i] & (I::kBuckets - 1)) != b) continue;
+                    size_t s = mix(h[i], (uint16_t)d) & (I::kSlots - 1);
+                    if (idx.slots[s]) ok = false;
+                    for (size_t k = 0; k < count && ok; k++) {
+                        if (taken[k] == s) ok = false;
+                    }
+                    taken[count++] = s;
+                }
+                if (!ok) continue;
+                idx.displace[b] = (uint16_t)d;
+                for (size_t i = 0, k = 0; i < N; i++) {
+                    if ((h[i] & (I::kBuckets - 1)) == b) idx.slots[taken[k++]] = (uint16_t)(i + 1);
+                }
+                placed = true;
+            }
+            if (!placed) noPerfectHash();
+        }
+    }
+    return idx;
+}
+
+template <typename Owner>
+class Dispatcher : public AsyncWebHandler {
+public:
+    template <size_t N>
+    Dispatcher& install(Owner *owner, const Route<Owner> (&routes)[N], const Index<N> &index) {
+        _owner = owner;
+        _routes = routes;
+        _displace = index.displace;
+        _slots = index.slots;
+        _bucketMask = Index<N>::kBuckets - 1;
+        _slotMask = Index<N>::kSlots - 1;
+        return *this;
+    }
+
+    // jede Route bekommt einen Eintrag in RouteMetrics, in Tabellenreihenfolge
+    Dispatcher& metrics(RouteMetrics *metrics, size_t count) {
+        _metrics = metrics;
+        _firstMeter = metrics->routes();
+        for (size_t i = 0; i < count; i++) metrics->add(_routes[i].path, _routes[i].method);
+        return *this;
+    }
+
+    // teure Routen nur nach AdmissionControl::admit()
+    Dispatcher& admission(AdmissionControl *admission) {
+        _admission = admission;
+        return *this;
+    }
+
+    const Route<Owner>* find(AsyncWebServerRequest *request) const {
+        if (!_routes) return nullptr;
+        const String &url = request->url();
+        uint32_t h = hash(url.c_str(), url.length());
+        uint16_t entry = _slots[mix(h, _displace[h & _bucketMask]) & _slotMask];
+        if (!entry) return nullptr;
+        const Route<Owner> &route = _routes[entry - 1];
+        if (!(route.method & request->method()) || !equal(route.path, url.c_str())) return nullptr;
+        return &route;
+    }
+
+    bool canHandle(AsyncWebServerRequest *request) override {
+        if (!find(request)) return false;
+        request->addInterestingHeader("ANY");   // wie AsyncCallbackWebHandler
+        return true;
+    }
+
+    void handleRequest(AsyncWebServerRequest *request) override {
+        const Route<Owner> *route = find(request);
+        if (!route) return;
+        RouteMetrics::Route *meter = _metrics ? _metrics->at(_firstMeter + (route - _routes)) : nullptr;
+        RouteMetrics::Scope scope(_metrics, meter, request);
+        if (route->cost == AdmissionControl::EXPENSIVE && _admission && !_admission->admit(request)) return;
+        (_owner->*route->handler)(request);
+    }
+
+    bool isRequestHandlerTrivial() override { return false; }
+
+private:
+    Owner *_owner = nullptr;
+    const Route<Owner> *_routes = nullptr;
+    const uint16_t *_displace = nullptr;
+    const uint16_t *_slots = nullptr;
+    uint32_t _bucketMask = 0;
+    uint32_t _slotMask = 0;
+    RouteMetrics *_metrics = nullptr;
+    size_t _firstMeter = 0;
+    AdmissionControl *_admission = nullptr;
+};
+
+} // namespace RouteTable
+
+#endif
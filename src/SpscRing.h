@@ -0,0 +1,52 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+//----------------------------------------------------------------------------
+// SpscRing
+// Ringpuffer fester Größe für genau einen Erzeuger und genau einen
+// Verbraucher, ohne Sperre und ohne Heap. Jeder Index wird nur von einer
+// Seite geschrieben; release/acquire auf den Indizes macht den Eintrag
+// sichtbar, bevor der andere ihn anfasst. N muss eine Zweierpotenz sein,
+// die Indizes laufen frei über und werden erst beim Zugriff maskiert.
+//----------------------------------------------------------------------------
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N muss eine Zweierpotenz sein");
+
+public:
+    // nur Erzeuger; false = voll
+    bool push(const T &item) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) == N) return false;
+        _items[head & (N - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // nur Verbraucher; false = leer
+    bool pop(T &item) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) return false;
+        item = _items[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Momentaufnahme, von beiden Seiten lesbar
+    size_t size() const {
+        uint32_t tail = _tail.load(std::memory_order_acquire);   // zuerst: head >= tail
+        return _head.load(std::memory_order_acquire) - tail;
+    }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    T _items[N];
+    std::atomic<uint32_t> _head{0};     // schreibt nur der Erzeuger
+    std::atomic<uint32_t> _tail{0};     // schreibt nur der Verbraucher
+};
+
+#endif
@@ -0,0 +1,119 @@
+#include "StateChannel.h"
+#include <ArduinoJson.h>
+
+enum FieldType : uint8_t { BOOL_FIELD, INT_FIELD, TEXT_FIELD };
+
+struct FieldInfo {
+    const char *key;
+    FieldType   type;
+};
+
+// Reihenfolge wie StateChannel::Field
+static const FieldInfo kFields[StateChannel::FIELD_COUNT] = {
+    { "led",       BOOL_FIELD },
+    { "blink",     BOOL_FIELD },
+    { "uptime",    INT_FIELD  },
+    { "counter",   INT_FIELD  },
+    { "wifi_mode", TEXT_FIELD },
+    { "ip",        TEXT_FIELD },
+};
+
+void StateChannel::set(Field field, int32_t value) {
+    Entry &e = _fields[field];
+    if (e.version != 0 && e.num == value) return;
+    e.num = value;
+    e.version = ++_version;
+}
+
+void StateChannel::set(Field field, const String &value) {
+    Entry &e = _fields[field];
+    if (e.version != 0 && e.text == value) return;
+    e.text = value;
+    e.version = ++_version;
+}
+
+// Anzahl Felder mit Version > since (full: alle), gleich für JSON und binär
+size_t StateChannel::changed(uint32_t since, bool full) const {
+    size_t fields = 0;
+    for (const Entry &e : _fields) {
+        if (e.version != 0 && (full || e.version > since)) fields++;
+    }
+    return fields;
+}
+
+// Felder mit Version > since (full: alle) als JSON in einen Fanout-Puffer
+AsyncWebSocketMessageBuffer* StateChannel::serialize(uint32_t since, bool full) {
+    JsonDocument doc;
+    doc["v"] = _version;
+    if (full) doc["full"] = true;
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        const Entry &e = _fields[i];
+        if (e.version == 0 || (!full && e.version <= since)) continue;
+        switch (kFields[i].type) {
+            case BOOL_FIELD: doc[kFields[i].key] = e.num != 0; break;
+            case INT_FIELD:  doc[kFields[i].key] = e.num; break;
+            case TEXT_FIELD: doc[kFields[i].key] = e.text; break;
+        }
+    }
+
+    size_t len = measureJson(doc);
+    AsyncWebSocketMessageBuffer *buffer = _fanout.makeBuffer(len);
+    if (buffer) serializeJson(doc, (char*)buffer->get(), len + 1);
+    return buffer;
+}
+
+void StateChannel::writeBinary(WsProtocol::Writer &w, uint32_t since, bool full) const {
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        const Entry &e = _fields[i];
+        if (e.version != 0 && (full || e.version > since)) mask |= 1 << i;
+    }
+    w.u8(full ? WsProtocol::OP_STATE_FULL : WsProtocol::OP_STATE_DELTA);
+    w.u32(_version);
+    w.u8(mask);
+    for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+        if (!(mask & (1 << i))) continue;
+        const Entry &e = _fields[i];
+        switch (kFields[i].type) {
+            case BOOL_FIELD: w.u8(e.num != 0); break;
+            case INT_FIELD:  w.i32(e.num); break;
+            case TEXT_FIELD: w.text(e.text.c_str(), e.text.length()); break;
+        }
+    }
+}
+
+// Gleicher Inhalt wie serialize(), als Binärframe (WsProtocol.h)
+AsyncWebSocketMessageBuffer* StateChannel::serializeBinary(uint32_t since, bool full) {
+    WsProtocol::Writer measure;
+    writeBinary(measure, since, full);
+    AsyncWebSocketMessageBuffer *buffer = _fanout.makeBuffer(measure.size());
+    if (!buffer) return nullptr;
+    WsProtocol::Writer w(buffer->get(), buffer->length());
+    writeBinary(w, since, full);
+    return buffer;
+}
+
+size_t StateChannel::publish() {
+    _fanout.update();
+    size_t sent = 0;
+
+    if (_version != _sentVersion) {
+        if (_fanout.clients() == 0) {
+            _sentVersion = _version;    // niemand verbunden, neue Clients bekommen ohnehin Snapshots
+        } else {
+            // Einmal pro Format serialisiert, Puffer wird per Referenzzähler von allen Clients geteilt
+            AsyncWebSocketMessageBuffer *json = _fanout.clients(false) ? serialize(_sentVersion, false) : nullptr;
+            AsyncWebSocketMessageBuffer *binary = _fanout.clients(true) ? serializeBinary(_sentVersion, false) : nullptr;
+            _fanout.sendDelta(json, binary);
+            sent += changed(_sentVersion, false);
+            _sentVersion = _version;
+        }
+    }
+    if (_fanout.needsSnapshot()) {
+        AsyncWebSocketMessageBuffer *json = _fanout.clients(false) ? serialize(0, true) : nullptr;
+        AsyncWebSocketMessageBuffer *binary = _fanout.clients(true) ? serializeBinary(0, true) : nullptr;
+        _fanout.sendSnapshot(json, binary);
+        sent += changed(0, true);
+    }
+    return sent;
+}
@@ -0,0 +1,52 @@
+#ifndef STATECHANNEL_H
+#define STATECHANNEL_H
+
+#include <Arduino.h>
+#include "WsFanout.h"
+#include "WsProtocol.h"
+
+//----------------------------------------------------------------------------
+// StateChannel
+// Versionierter Gerätezustand für die WebSocket-Clients. Jedes Feld merkt sich
+// die Version seiner letzten Änderung; publish() sendet nur die seit dem
+// letzten Senden geänderten Felder. Der Frame wird einmal serialisiert und
+// über WsFanout als gemeinsamer Puffer an alle Clients verteilt – je einmal
+// als JSON und als Binärframe (WsProtocol.h), falls Clients beider Art da sind. Neue oder
+// nachhängende Clients bekommen stattdessen einen vollständigen Snapshot.
+//
+// Nur aus loop() verwenden.
+//----------------------------------------------------------------------------
+class StateChannel {
+public:
+    enum Field : uint8_t { LED, BLINK, UPTIME, COUNTER, WIFI_MODE, WIFI_IP, FIELD_COUNT };
+
+    explicit StateChannel(WsFanout &fanout) : _fanout(fanout) {}
+
+    void set(Field field, int32_t value);
+    void set(Field field, const String &value);
+
+    // Sendet Delta bzw. Snapshots, falls nötig. Liefert Anzahl gesendeter
+    // Felder (Delta + Snapshot, unabhängig vom Format der Clients).
+    size_t publish();
+
+    uint32_t version() const { return _version; }
+
+private:
+    struct Entry {
+        int32_t  num = 0;
+        String   text;
+        uint32_t version = 0;
+    };
+
+    size_t changed(uint32_t since, bool full) const;
+    AsyncWebSocketMessageBuffer* serialize(uint32_t since, bool full);
+    AsyncWebSocketMessageBuffer* serializeBinary(uint32_t since, bool full);
+    void writeBinary(WsProtocol::Writer &w, uint32_t since, bool full) const;
+
+    WsFanout &_fanout;
+    Entry _fields[FIELD_COUNT];
+    uint32_t _version = 0;      // steigt bei jeder Änderung
+    uint32_t _sentVersion = 0;  // Stand des letzten gesendeten Frames
+};
+
+#endif
@@ -0,0 +1,92 @@
+#include "StaticAssetHandler.h"
+#include "TraceBuffer.h"
+
+// sortiert nach path (build_assets.py), Sentinel am Ende
+static const AssetInfo kAssets[] = { ASSET_TABLE_ENTRIES { nullptr, nullptr, nullptr, 0, 0 } };
+static const size_t kAssetCount = sizeof(kAssets) / sizeof(kAssets[0]) - 1;
+
+static const char kLongCache[] = "public, max-age=31536000, immutable";
+static const char kRevalidate[] = "no-cache";
+
+const AssetInfo* StaticAssetHandler::find(const char *path) {
+    size_t lo = 0, hi = kAssetCount;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int cmp = strcmp(path, kAssets[mid].path);
+        if (cmp == 0) return &kAssets[mid];
+        if (cmp < 0) hi = mid;
+        else lo = mid + 1;
+    }
+    return nullptr;
+}
+
+bool StaticAssetHandler::allowed(const String &url) const {
+    for (const char *prefix : _prefixes) {
+        if (url.startsWith(prefix)) return true;
+    }
+    return false;
+}
+
+bool StaticAssetHandler::canHandle(AsyncWebServerRequest *request) {
+    if (request->method() != HTTP_GET) return false;
+    const String &url = request->url();
+    if (!allowed(url)) return false;
+    if (!find(url.c_str()) && !(_bundle && _bundle->find(url)) && !(kAssetCount == 0 && _fs.exists(url))) return false;
+
+    request->addInterestingHeader("If-None-Match");
+    request->addInterestingHeader("Accept-Encoding");
+    return true;
+}
+
+void StaticAssetHandler::handleRequest(AsyncWebServerRequest *request) {
+    const String &url = request->url();
+    AssetBundle::Asset bundled = _bundle ? _bundle->find(url) : AssetBundle::Asset();
+    const AssetInfo *asset = bundled ? nullptr : find(url.c_str());
+    if (!bundled && !asset) {
+        // kein Manifest vorhanden: Datei wie bisher ausliefern
+        if (_admission && !_admission->admit(request, false)) return;
+        request->send(_fs, url);
+        return;
+    }
+
+    bool hasGzip = bundled ? bundled.gzSize > 0 : asset->gzSize > 0;
+    bool gzip = hasGzip && request->hasHeader("Accept-Encoding")
+                && request->header("Accept-Encoding").indexOf("gzip") >= 0;
+    // starke ETags je Content-Coding verschieden (RFC 9110 8.8.3), sonst kann
+    // ein Cache nach 304 die gzip-Bytes für eine Anfrage ohne gzip liefern
+    String etag = String("\"") + (bundled ? bundled.etag : asset->etag) + (gzip ? "-gz\"" : "\"");
+    bool versioned = request->hasParam("v") && request->getParam("v")->value() == ASSET_VERSION;
+    const char *cacheControl = versioned ? kLongCache : kRevalidate;
+
+    if (request->hasHeader("If-None-Match") && request->header("If-None-Match").indexOf(etag) >= 0) {
+        AsyncWebServerResponse *response = request->beginResponse(304);
+        response->addHeader("ETag", etag);
+        response->addHeader("Cache-Control", cacheControl);
+        request->send(response);
+        return;
+    }
+
+    // nicht über RouteMetrics::wrap() registriert, zählt also nicht in inFlight()
+    if (_admission && !_admission->admit(request, false)) return;
+
+    AsyncWebServerResponse *response;
+    if (bundled) {
+        // Zeiger in den Flash, die Bibliothek liest beim Senden direkt daraus
+        response = gzip ? request->beginResponse_P(200, bundled.contentType, bundled.gzData, bundled.gzSize)
+                        : request->beginResponse_P(200, bundled.contentType, bundled.data, bundled.size);
+    } else {
+        // nicht über RouteMetrics::wrap() registriert: eigene Spur
+        TRACE_SCOPE(OPEN_FILE, micros(), asset->path);
+        response = request->beginResponse(_fs, gzip ? url + ".gz" : url, asset->contentType);
+    }
+    if (!response) {
+        // im Manifest, aber nicht im SPIFFS (Image nicht neu hochgeladen)
+        request->send(404);
+        return;
+    }
+    if (gzip) response->addHeader("Content-Encoding", "gzip");
+    if (hasGzip) response->addHeader("Vary", "Accept-Encoding");
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", cacheControl);
+    request->send(response);
+}
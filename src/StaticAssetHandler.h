@@ -0,0 +1,61 @@
+#ifndef STATICASSETHANDLER_H
+#define STATICASSETHANDLER_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <ESPAsyncWebServer.h>
+#include <vector>
+#include "AssetManifest.h"
+#include "AssetBundle.h"
+#include "AdmissionControl.h"
+
+//----------------------------------------------------------------------------
+// StaticAssetHandler
+// Ersetzt serveStatic für CSS/JS/Bilder:
+//  - liefert <datei>.gz, wenn vorhanden und der Client gzip akzeptiert
+//  - ETag aus dem Build (tools/build_assets.py), für gzip mit "-gz",
+//    If-None-Match der Variante, die gesendet würde -> 304
+//  - ?v=ASSET_VERSION in der URL -> Cache-Control max-age 1 Jahr (immutable),
+//    sonst no-cache (Browser fragt mit ETag nach)
+//  - mit admission(): Datei nur öffnen, wenn AdmissionControl zustimmt
+//    (304 kostet nichts und läuft immer)
+//  - mit bundle(): Dateien aus dem Asset-Bundle direkt aus dem eingeblendeten
+//    Flash senden (Content-Length, kein Dateisystem), SPIFFS nur für den Rest
+//----------------------------------------------------------------------------
+class StaticAssetHandler : public AsyncWebHandler {
+public:
+    explicit StaticAssetHandler(fs::FS &fs) : _fs(fs) {}
+
+    // URL-Präfix freigeben, z.B. "/style.css" oder "/images/"
+    StaticAssetHandler& serve(const char *prefix) {
+        _prefixes.push_back(prefix);
+        return *this;
+    }
+
+    StaticAssetHandler& admission(AdmissionControl *admission) {
+        _admission = admission;
+        return *this;
+    }
+
+    // nur ein Bundle übergeben, das zur Firmware passt (matches(ASSET_VERSION)),
+    // sonst stimmen ETags und ?v= nicht mit html_template überein
+    StaticAssetHandler& bundle(const AssetBundle *bundle) {
+        _bundle = bundle;
+        return *this;
+    }
+
+    static const AssetInfo* find(const char *path);
+
+    bool canHandle(AsyncWebServerRequest *request) override;
+    void handleRequest(AsyncWebServerRequest *request) override;
+
+private:
+    bool allowed(const String &url) const;
+
+    fs::FS &_fs;
+    std::vector<const char*> _prefixes;
+    AdmissionControl *_admission = nullptr;
+    const AssetBundle *_bundle = nullptr;
+};
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef STATICTEMPLATE_H
+#define STATICTEMPLATE_H
+
+#include <array>
+#include <memory>
+#include "TemplateEngine.h"
+
+//----------------------------------------------------------------------------
+// StaticTemplate
+// Compile-Zeit-Variante von TemplateEngine für die konstanten Seiten aus
+// html_pages.h: html_template + Seiteninhalt werden vom Compiler in Segmente
+// zerlegt, jeder %NAME%-Platzhalter wird einem Enum-Slot zugeordnet.
+// Der Handler füllt die Slots per Index – keine Suche, keine std::map.
+//
+// Beispiel:
+//   #define STATUS_SLOTS(X) X(EEPROM_TEXT) X(CUR_COUNTER)
+//   DECLARE_TEMPLATE_SLOTS(StatusSlot, STATUS_SLOTS)
+//   using StatusPage = StaticPage<html_template, status_content, StatusSlot, StatusSlotNames>;
+//
+//   StatusPage::Values v;
+//   v.set(StatusSlot::CUR_COUNTER, String(_counter));
+//   request->send(StatusPage::beginResponse(request, std::move(v)));
+//----------------------------------------------------------------------------
+
+#define TEMPLATE_SLOT_ENUM(name) name,
+#define TEMPLATE_SLOT_NAME(name) #name,
+#define DECLARE_TEMPLATE_SLOTS(EnumName, LIST) \
+    enum class EnumName : uint8_t { LIST(TEMPLATE_SLOT_ENUM) COUNT }; \
+    constexpr const char *EnumName##Names[] = { LIST(TEMPLATE_SLOT_NAME) nullptr };
+
+namespace tpl {
+
+constexpr size_t length(const char *s) {
+    size_t n = 0;
+    while (s[n]) n++;
+    return n;
+}
+
+constexpr bool isNameChar(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// a[0..len) == b (b nullterminiert)
+constexpr bool equals(const char *a, size_t len, const char *b) {
+    for (size_t i = 0; i < len; i++) {
+        if (b[i] != a[i]) return false;
+    }
+    return b[len] == '\0';
+}
+
+constexpr size_t find(const char *text, const char *marker) {
+    size_t len = length(text);
+    size_t mlen = length(marker);
+    for (size_t i = 0; i + mlen <= len; i++) {
+        if (equals(text + i, mlen, marker)) return i;
+    }
+    return len;
+}
+
+constexpr int slotOf(const char *name, size_t len, const char *const *names) {
+    for (int i = 0; names[i]; i++) {
+        if (equals(name, len, names[i])) return i;
+    }
+    return -1;
+}
+
+struct ScanResult {
+    size_t count = 0;       // Anzahl Segmente
+    bool unknown = false;   // Platzhalter ohne Slot gefunden
+    uint32_t used = 0;      // Bitmaske der vorkommenden Slots
+};
+
+// Gleiche Regeln wie TemplateEngine::scan; out == nullptr zählt nur
+constexpr void scan(const char *text, size_t len, const char *const *names,
+                    TemplateEngine::Segment *out, ScanResult &r) {
+    auto literal = [&](size_t from, size_t to) {
+        while (from < to) {
+            size_t part = to - from > 0xFFFF ? 0xFFFF : to - from;
+            if (out) out[r.count] = TemplateEngine::Segment{text + from, (uint16_t)part, -1};
+            r.count++;
+            from += part;
+        }
+    };
+
+    size_t litStart = 0;
+    size_t i = 0;
+    while (i < len) {
+        if (text[i] != '%') { i++; continue; }
+        size_t j = i + 1;
+        while (j < len && isNameChar(text[j])) j++;
+        if (j >= len || text[j] != '%' || j == i + 1) {
+            i = j > i + 1 ? j : i + 1;
+            continue;
+        }
+        literal(litStart, i);
+        int slot = slotOf(text + i + 1, j - i - 1, names);
+        if (slot < 0) r.unknown = true;
+        else r.used |= 1u << slot;
+        if (out) out[r.count] = TemplateEngine::Segment{text + i, (uint16_t)(j + 1 - i), (int16_t)slot};
+        r.count++;
+        i = j + 1;
+        litStart = i;
+    }
+    literal(litStart, len);
+}
+
+constexpr ScanResult scanPage(const char *base, const char *body, const char *const *names,
+                              TemplateEngine::Segment *out = nullptr) {
+    ScanResult r;
+    size_t baseLen = length(base);
+    size_t marker = find(base, "_BODY_CONTENT_");
+    scan(base, marker, names, out, r);
+    scan(body, length(body), names, out, r);
+    if (marker < baseLen) {
+        size_t tail = marker + length("_BODY_CONTENT_");
+        scan(base + tail, baseLen - tail, names, out, r);
+    }
+    return r;
+}
+
+template <size_t N>
+struct SegmentTable {
+    TemplateEngine::Segment items[N];
+};
+
+template <size_t N>
+constexpr SegmentTable<N> buildTable(const char *base, const char *body, const char *const *names) {
+    SegmentTable<N> t{};
+    scanPage(base, body, names, t.items);
+    return t;
+}
+
+} // namespace tpl
+
+template <typename Slot>
+class SlotValues {
+public:
+    static constexpr size_t kCount = (size_t)Slot::COUNT;
+    static_assert(kCount <= 32, "maximal 32 Slots pro Seite");
+
+    void set(Slot slot, String value) {
+        _values[(size_t)slot] = std::move(value);
+        _filled |= 1u << (size_t)slot;
+    }
+    // nullptr = nicht gesetzt, Platzhalter bleibt stehen
+    const String* get(int slot) const {
+        return (slot >= 0 && (_filled & (1u << slot))) ? &_values[slot] : nullptr;
+    }
+
+private:
+    std::array<String, kCount> _values;
+    uint32_t _filled = 0;
+};
+
+template <const char *Base, const char *Body, typename Slot, const char *const *Names>
+class StaticPage {
+public:
+    using Values = SlotValues<Slot>;
+
+    static constexpr tpl::ScanResult kScan = tpl::scanPage(Base, Body, Names);
+    static_assert(!kScan.unknown, "Seite enthält einen Platzhalter, der nicht im Slot-Enum steht");
+    static_assert(kScan.used == (Values::kCount == 32 ? 0xFFFFFFFFu : (1u << Values::kCount) - 1),
+                  "Slot-Enum enthält einen Namen, der auf der Seite nicht vorkommt");
+
+    static constexpr size_t kSegments = kScan.count;
+    static constexpr tpl::SegmentTable<kSegments> kTable = tpl::buildTable<kSegments>(Base, Body, Names);
+
+    class Renderer {
+    public:
+        explicit Renderer(Values values) : _values(std::move(values)) {}
+        size_t fill(uint8_t *buffer, size_t maxLen) {
+            return TemplateEngine::fillSegments(kTable.items, kSegments,
+                                                [this](int slot) { return _values.get(slot); },
+                                                _seg, _pos, buffer, maxLen);
+        }
+        bool done() const { return _seg >= kSegments; }
+        RouteMetrics::Meter meter() const { return _meter; }
+    private:
+        RouteMetrics::Meter _meter = RouteMetrics::current();
+        Values _values;
+        size_t _seg = 0;
+        size_t _pos = 0;
+    };
+
+    static AsyncWebServerResponse* beginResponse(AsyncWebServerRequest *request,
+                                                 Values values,
+                                                 const char *contentType = "text/html") {
+        auto renderer = std::make_shared<Renderer>(std::move(values));
+        return request->beginChunkedResponse(contentType,
+            [renderer](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                return renderer->meter().fill([&] { return renderer->fill(buffer, maxLen); });
+            });
+    }
+};
+
+#endif
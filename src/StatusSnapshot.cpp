@@ -0,0 +1,106 @@
+#include "StatusSnapshot.h"
+#include <WebResponseImpl.h>
+#include "RouteMetrics.h"
+
+namespace {
+
+// Sendet den Puffer einer Lease; die Lease lebt so lange wie die Antwort
+class SnapshotResponse : public AsyncAbstractResponse {
+public:
+    explicit SnapshotResponse(StatusSnapshot::Lease &&lease) : _lease(std::move(lease)) {
+        _code = 200;
+        _contentType = "application/json";
+        _contentLength = _lease.length();
+    }
+    bool _sourceValid() const override { return true; }
+    size_t _fillBuffer(uint8_t *buf, size_t maxLen) override {
+        size_t n = _meter.fill([&] {
+            size_t left = _lease.length() - _pos;
+            size_t len = std::min(maxLen, left);
+            memcpy(buf, _lease.data() + _pos, len);
+            return len;
+        });
+        _pos += n;
+        return n;
+    }
+private:
+    StatusSnapshot::Lease _lease;
+    RouteMetrics::Meter _meter = RouteMetrics::current();
+    size_t _pos = 0;
+};
+
+} // namespace
+
+//----------------------------------------------------------------------------
+// Lease
+//----------------------------------------------------------------------------
+StatusSnapshot::Lease::Lease(const Lease &other) : _owner(other._owner), _slot(other._slot) {
+    if (_owner) _owner->_buffers[_slot].readers.fetch_add(1);
+}
+
+StatusSnapshot::Lease& StatusSnapshot::Lease::operator=(const Lease &other) {
+    if (this == &other) return *this;
+    release();
+    _owner = other._owner;
+    _slot = other._slot;
+    if (_owner) _owner->_buffers[_slot].readers.fetch_add(1);
+    return *this;
+}
+
+void StatusSnapshot::Lease::release() {
+    if (_owner) _owner->_buffers[_slot].readers.fetch_sub(1);
+    _owner = nullptr;
+}
+
+const char* StatusSnapshot::Lease::data() const {
+    return _owner ? _owner->_buffers[_slot].data : "";
+}
+
+size_t StatusSnapshot::Lease::length() const {
+    return _owner ? _owner->_buffers[_slot].length : 0;
+}
+
+//----------------------------------------------------------------------------
+// Erzeuger und Leser
+//----------------------------------------------------------------------------
+// Leser zählen sich erst ein und prüfen dann, ob ihr Puffer noch der
+// veröffentlichte ist; der Erzeuger schaltet erst um und prüft beim nächsten
+// begin() die Leser. Beides seq_cst: sieht der Erzeuger keinen Leser, sieht
+// ein später eintreffender Leser schon den neuen Puffer und weicht aus.
+char* StatusSnapshot::begin() {
+    Buffer &b = _buffers[1 - _published.load()];
+    if (b.readers.load() != 0) {
+        _stats.skipped++;
+        return nullptr;
+    }
+    return b.data;
+}
+
+void StatusSnapshot::commit(size_t len) {
+    if (len == 0 || len > kCapacity) return;
+    uint8_t slot = 1 - _published.load();
+    Buffer &b = _buffers[slot];
+    b.length = len;
+    _published.store(slot);
+    _version.store(_version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    _stats.commits++;
+}
+
+StatusSnapshot::Lease StatusSnapshot::acquire() {
+    if (version() == 0) return Lease();
+    for (;;) {
+        uint8_t slot = _published.load();
+        _buffers[slot].readers.fetch_add(1);
+        if (_published.load() == slot) return Lease(this, slot);
+        _buffers[slot].readers.fetch_sub(1);
+    }
+}
+
+AsyncWebServerResponse* StatusSnapshot::beginResponse(AsyncWebServerRequest *request) {
+    Lease lease = acquire();
+    if (!lease) {
+        RouteMetrics::current().status(503);
+        return request->beginResponse(503, "text/plain", "Status noch nicht bereit");
+    }
+    return new SnapshotResponse(std::move(lease));
+}
@@ -0,0 +1,80 @@
+#ifndef STATUSSNAPSHOT_H
+#define STATUSSNAPSHOT_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <atomic>
+
+//----------------------------------------------------------------------------
+// StatusSnapshot
+// Fertig formatierter Status (JSON) in zwei festen Puffern. Ein Erzeuger
+// (loop()) schreibt höchstens einmal pro Takt in den gerade nicht
+// veröffentlichten Puffer und schaltet dann um; Leser im AsyncTCP-Task
+// senden den veröffentlichten Puffer direkt, ohne JsonDocument oder String.
+//
+// Ein Leser hält den Puffer über eine Lease, bis seine Antwort gelöscht
+// wird; die Lease steckt im Antwortobjekt, weitere Allokationen gibt es
+// nicht. Hält noch ein Leser den freien Puffer, lässt der Erzeuger den Takt
+// aus (begin() == nullptr) – der alte Stand bleibt dann etwas länger gültig.
+//
+// Als Stream: WebServerClass sendet jeden committeten Puffer zusätzlich als
+// Event "status" über /events (EventStream::publishStatus).
+//----------------------------------------------------------------------------
+class StatusSnapshot {
+public:
+    static constexpr size_t kCapacity = 1024;
+
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(const Lease &other);
+        Lease(Lease &&other) : _owner(other._owner), _slot(other._slot) { other._owner = nullptr; }
+        Lease& operator=(const Lease &other);
+        ~Lease() { release(); }
+
+        explicit operator bool() const { return _owner != nullptr; }
+        const char* data() const;
+        size_t length() const;
+
+    private:
+        friend class StatusSnapshot;
+        // übernimmt den schon gezählten Leser
+        Lease(StatusSnapshot *owner, uint8_t slot) : _owner(owner), _slot(slot) {}
+        void release();
+
+        StatusSnapshot *_owner = nullptr;
+        uint8_t _slot = 0;
+    };
+
+    // Erzeuger: freier Puffer mit kCapacity Bytes, nullptr = noch gelesen
+    char* begin();
+    // Erzeuger: len Bytes aus begin() veröffentlichen; 0 verwirft den Takt
+    void commit(size_t len);
+
+    // Leser: veröffentlichter Stand; leer, solange noch nichts committet ist
+    Lease acquire();
+    uint32_t version() const { return _version.load(std::memory_order_acquire); }
+
+    // Antwort mit Content-Length aus dem veröffentlichten Puffer; 503 vor dem ersten commit()
+    AsyncWebServerResponse* beginResponse(AsyncWebServerRequest *request);
+
+    struct Stats {
+        uint32_t commits = 0;
+        uint32_t skipped = 0;       // Takte ohne freien Puffer
+    };
+    const Stats& stats() const { return _stats; }
+
+private:
+    struct Buffer {
+        char data[kCapacity];
+        size_t length = 0;
+        std::atomic<uint16_t> readers{0};
+    };
+
+    Buffer _buffers[2];
+    std::atomic<uint8_t> _published{0};
+    std::atomic<uint32_t> _version{0};
+    Stats _stats;
+};
+
+#endif
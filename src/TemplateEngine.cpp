@@ -0,0 +1,297 @@
+#include "TemplateEngine.h"
+
+static inline bool isPlaceholderChar(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+int TemplateEngine::Page::slotIndex(const char *name) const {
+    for (size_t i = 0; i < _slotNames.size(); i++) {
+        if (_slotNames[i] == name) return (int)i;
+    }
+    return -1;
+}
+
+// Zerlegt text in Literale und %NAME%-Slots. "100%;" o.ä. (CSS) bleibt Literal,
+// da zwischen zwei '%' nur Buchstaben, Ziffern und '_' erlaubt sind.
+void TemplateEngine::scan(Page &page, const char *text, size_t len) {
+    auto addLiteral = [&page](const char *p, size_t n) {
+        while (n > 0) {
+            uint16_t part = n > 0xFFFF ? 0xFFFF : (uint16_t)n;
+            page._segments.push_back({p, part, -1});
+            page._literalLen += part;
+            p += part;
+            n -= part;
+        }
+    };
+
+    size_t litStart = 0;
+    size_t i = 0;
+    while (i < len) {
+        if (text[i] != '%') { i++; continue; }
+        size_t j = i + 1;
+        while (j < len && isPlaceholderChar(text[j])) j++;
+        if (j >= len || text[j] != '%' || j == i + 1) {
+            i = j > i + 1 ? j : i + 1;
+            continue;
+        }
+        addLiteral(text + litStart, i - litStart);
+
+        String name;
+        name.reserve(j - i - 1);
+        for (size_t k = i + 1; k < j; k++) name += text[k];
+        int slot = page.slotIndex(name.c_str());
+        if (slot < 0) {
+            slot = (int)page._slotNames.size();
+            page._slotNames.push_back(name);
+        }
+        page._segments.push_back({text + i, (uint16_t)(j + 1 - i), (int16_t)slot});
+
+        i = j + 1;
+        litStart = i;
+    }
+    addLiteral(text + litStart, len - litStart);
+}
+
+void TemplateEngine::begin(const char *base, const char *marker) {
+    _base = base;
+    const char *pos = strstr_P(base, marker);
+    if (pos) {
+        _headLen = pos - base;
+        _tail = pos + strlen(marker);
+        _tailLen = strlen_P(_tail);
+    } else {
+        _headLen = strlen_P(base);
+        _tail = nullptr;
+        _tailLen = 0;
+    }
+
+    std::shared_ptr<Page> head = std::make_shared<Page>();
+    scan(*head, _base, _headLen);
+    _headPage = head;
+    std::shared_ptr<Page> tail = std::make_shared<Page>();
+    if (_tail) scan(*tail, _tail, _tailLen);
+    _tailPage = tail;
+
+    clear();
+}
+
+TemplateEngine::PagePtr TemplateEngine::compile(const char *content, size_t len, std::unique_ptr<char[]> owned) {
+    std::shared_ptr<Page> page = std::make_shared<Page>();
+    page->_buffer = std::move(owned);
+    if (_base) scan(*page, _base, _headLen);
+    scan(*page, content, len);
+    if (_tail) scan(*page, _tail, _tailLen);
+    return page;
+}
+
+TemplateEngine::PagePtr TemplateEngine::page(const char *content) {
+    auto it = _progmemPages.find(content);
+    if (it != _progmemPages.end()) return it->second;
+
+    PagePtr p = compile(content, strlen_P(content), nullptr);
+    _progmemPages[content] = p;
+    return p;
+}
+
+TemplateEngine::PagePtr TemplateEngine::file(fs::FS &fs, const char *path) {
+    auto it = _filePages.find(path);
+    if (it != _filePages.end()) return it->second;
+
+    File f;
+    {
+        TRACE_SCOPE(OPEN_FILE, RouteMetrics::current().id(), path);
+        f = fs.open(path, "r");
+    }
+    if (!f) return nullptr;
+    size_t size = f.size();
+    if (size > kMaxCachedFileSize) {
+        f.close();
+        return nullptr;
+    }
+    std::unique_ptr<char[]> buffer(new (std::nothrow) char[size + 1]);
+    if (!buffer) {
+        f.close();
+        return nullptr;
+    }
+    size_t got;
+    {
+        TRACE_SCOPE(READ_FILE, RouteMetrics::current().id(), path);
+        got = f.read((uint8_t*)buffer.get(), size);
+    }
+    f.close();
+    buffer[got] = '\0';
+
+    const char *content = buffer.get();
+    PagePtr p = compile(content, got, std::move(buffer));
+    _filePages[path] = p;
+    return p;
+}
+
+TemplateEngine::PagePtr TemplateEngine::file(const AssetBundle &bundle, const char *path) {
+    AssetBundle::Asset asset = bundle.find(path);
+    if (!asset) return nullptr;
+    // wie page(): Inhalt bleibt im Flash, die Adresse ist für die Laufzeit fest
+    const char *content = (const char*)asset.data;
+    auto it = _progmemPages.find(content);
+    if (it != _progmemPages.end()) return it->second;
+
+    PagePtr p = compile(content, asset.size, nullptr);
+    _progmemPages[content] = p;
+    return p;
+}
+
+void TemplateEngine::clear() {
+    _progmemPages.clear();
+    _filePages.clear();
+}
+
+TemplateEngine::SlotMap::SlotMap(const Page &page, std::map<String, String> values)
+: _values(std::move(values)) {
+    const auto &names = page.slotNames();
+    _bySlot.resize(names.size(), nullptr);
+    for (size_t i = 0; i < names.size(); i++) {
+        auto it = _values.find(names[i]);
+        if (it != _values.end()) _bySlot[i] = &it->second;
+    }
+}
+
+TemplateEngine::Renderer::Renderer(PagePtr page, std::map<String, String> values)
+: _page(std::move(page)), _values(*_page, std::move(values)) {}
+
+size_t TemplateEngine::Renderer::fill(uint8_t *buffer, size_t maxLen) {
+    const auto &segments = _page->segments();
+    return fillSegments(segments.data(), segments.size(),
+                        [this](int slot) { return _values.get(slot); },
+                        _seg, _pos, buffer, maxLen);
+}
+
+AsyncWebServerResponse* TemplateEngine::beginResponse(AsyncWebServerRequest *request,
+                                                      PagePtr page,
+                                                      std::map<String, String> values,
+                                                      const char *contentType) {
+    auto renderer = std::make_shared<Renderer>(std::move(page), std::move(values));
+    return request->beginChunkedResponse(contentType,
+        [renderer](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+            return renderer->meter().fill([&] { return renderer->fill(buffer, maxLen); });
+        });
+}
+
+AsyncWebServerResponse* TemplateEngine::beginFileResponse(AsyncWebServerRequest *request,
+                                                          fs::FS &fs, const char *path,
+                                                          std::map<String, String> values,
+                                                          bool wrap,
+                                                          const char *contentType) {
+    File file;
+    {
+        TRACE_SCOPE(OPEN_FILE, RouteMetrics::current().id(), path);
+        file = fs.open(path, "r");
+    }
+    if (!file) return nullptr;
+    auto renderer = std::make_shared<FileRenderer>(wrap ? _headPage : nullptr,
+                                                   wrap ? _tailPage : nullptr,
+                                                   file, std::move(values));
+    return request->beginChunkedResponse(contentType,
+        [renderer](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+            return renderer->meter().fill([&] { return renderer->fill(buffer, maxLen); });
+        });
+}
+
+TemplateEngine::FileRenderer::FileRenderer(PagePtr head, PagePtr tail, File file,
+                                           std::map<String, String> values)
+: _head(std::move(head)), _tail(std::move(tail)), _file(file), _values(std::move(values)) {}
+
+const String* TemplateEngine::FileRenderer::lookup(const char *name, size_t len) const {
+    for (const auto &pair : _values) {
+        if (pair.first.length() == len && memcmp(pair.first.c_str(), name, len) == 0) {
+            return &pair.second;
+        }
+    }
+    return nullptr;
+}
+
+size_t TemplateEngine::FileRenderer::fillPage(const PagePtr &page, uint8_t *buffer, size_t maxLen) {
+    if (!page) return 0;
+    const auto &segments = page->segments();
+    const auto &names = page->slotNames();
+    return fillSegments(segments.data(), segments.size(),
+                        [this, &names](int slot) {
+                            return lookup(names[slot].c_str(), names[slot].length());
+                        },
+                        _seg, _pos, buffer, maxLen);
+}
+
+size_t TemplateEngine::FileRenderer::fill(uint8_t *buffer, size_t maxLen) {
+    size_t written = 0;
+    while (written < maxLen && _phase != DONE) {
+        size_t n = 0;
+        switch (_phase) {
+            case HEAD: n = fillPage(_head, buffer + written, maxLen - written); break;
+            case BODY:
+                // Platzhalter sollen immer ganz in den Block passen -> Rest im nächsten Aufruf
+                if (!_value && written > 0 && maxLen - written < kMaxPlaceholder) return written;
+                n = fillBody(buffer + written, maxLen - written);
+                break;
+            case TAIL: n = fillPage(_tail, buffer + written, maxLen - written); break;
+            default: break;
+        }
+        written += n;
+        if (n == 0) {
+            _phase = (Phase)(_phase + 1);
+            _seg = 0;
+            _pos = 0;
+            if (_phase == DONE) _file.close();
+        }
+    }
+    return written;
+}
+
+// Liest direkt in buffer und kürzt beim ersten bekannten Platzhalter. Die Datei wird
+// hinter den Platzhalter positioniert (seek), der Wert beim nächsten Durchlauf
+// ausgegeben. Ein am Blockende abgeschnittener Platzhalter wird nicht ausgegeben,
+// sondern im nächsten Block erneut gelesen. Liefert 0 wenn die Datei zu Ende ist.
+size_t TemplateEngine::FileRenderer::fillBody(uint8_t *buffer, size_t maxLen) {
+    if (_value) {
+        size_t n = _value->length() - _valuePos;
+        if (n > maxLen) n = maxLen;
+        memcpy(buffer, _value->c_str() + _valuePos, n);
+        _valuePos += n;
+        if (_valuePos >= _value->length()) _value = nullptr;
+        // leerer Wert: trotzdem weiterlesen, 0 hieße Dateiende
+        return n ? n : fillBody(buffer, maxLen);
+    }
+
+    size_t start = _file.position();
+    size_t n = _file.read(buffer, maxLen);
+    if (n == 0) return 0;
+    bool eof = n < maxLen;
+
+    const char *text = (const char*)buffer;
+    size_t i = 0;
+    while (i < n) {
+        if (text[i] != '%') { i++; continue; }
+        size_t j = i + 1;
+        while (j < n && j - i < kMaxPlaceholder && isPlaceholderChar(text[j])) j++;
+
+        if (j >= n && !eof && j - i < kMaxPlaceholder) {
+            // möglicher Platzhalter reicht über das Blockende
+            if (i > 0 || maxLen >= kMaxPlaceholder) {
+                _file.seek(start + i);
+                return i;
+            }
+            // Puffer kleiner als ein Platzhalter: als Literal ausgeben
+            return n;
+        }
+        if (j < n && text[j] == '%' && j > i + 1) {
+            const String *value = lookup(text + i + 1, j - i - 1);
+            if (value) {
+                _value = value;
+                _valuePos = 0;
+                _file.seek(start + j + 1);
+                if (i == 0) return fillBody(buffer, maxLen);
+                return i;
+            }
+        }
+        i = j > i + 1 ? j : i + 1;
+    }
+    return n;
+}
@@ -0,0 +1,179 @@
+#ifndef TEMPLATEENGINE_H
+#define TEMPLATEENGINE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <ESPAsyncWebServer.h>
+#include <map>
+#include <memory>
+#include <vector>
+#include "RouteMetrics.h"
+#include "AssetBundle.h"
+
+//----------------------------------------------------------------------------
+// TemplateEngine
+// Zerlegt html_template + Seiteninhalt (PROGMEM oder SPIFFS-Datei) EINMAL in
+// Literal-Segmente und Platzhalter-Slots (%NAME%). Beim Request werden die
+// Segmente per Chunked-Response gestreamt – es entsteht kein Seiten-String.
+//
+// Größere Dateien werden nicht im RAM gehalten, sondern blockweise direkt in
+// den Sendepuffer gelesen (FileRenderer); Platzhalter werden im Datenstrom
+// ersetzt, auch wenn sie über eine Blockgrenze reichen.
+//
+// Dateien aus dem AssetBundle liegen schon eingeblendet im Flash: die
+// Segmente zeigen direkt hinein wie bei PROGMEM, ohne Größenlimit.
+//----------------------------------------------------------------------------
+class TemplateEngine {
+public:
+    static constexpr size_t kMaxCachedFileSize = 4096; // größere Dateien werden gestreamt
+    static constexpr size_t kMaxPlaceholder = 32;      // "%NAME%" inkl. beider '%'
+
+    struct Segment {
+        const char *data;   // Zeiger in PROGMEM/Bundle bzw. in den Dateipuffer der Seite
+        uint16_t    len;
+        int16_t     slot;   // -1 = Literal, sonst Index in slotNames(); data zeigt dann auf "%NAME%"
+    };
+
+    class Page {
+    public:
+        const std::vector<Segment>& segments() const { return _segments; }
+        const std::vector<String>&  slotNames() const { return _slotNames; }
+        int    slotIndex(const char *name) const;
+        size_t literalLength() const { return _literalLen; }
+    private:
+        friend class TemplateEngine;
+        std::unique_ptr<char[]> _buffer;   // nur bei Dateien: einmal gelesener Inhalt
+        std::vector<Segment>    _segments;
+        std::vector<String>     _slotNames;
+        size_t                  _literalLen = 0;
+    };
+    using PagePtr = std::shared_ptr<const Page>;
+
+    // Kopiert ab (seg, pos) so viele Bytes wie passen; value(slot) liefert den Slot-Wert
+    // oder nullptr – dann wird der Platzhalter unverändert ausgegeben.
+    template <typename ValueFn>
+    static size_t fillSegments(const Segment *segments, size_t count, ValueFn value,
+                               size_t &seg, size_t &pos, uint8_t *buffer, size_t maxLen) {
+        size_t written = 0;
+        while (written < maxLen && seg < count) {
+            const Segment &s = segments[seg];
+            const char *src = s.data;
+            size_t len = s.len;
+            if (s.slot >= 0) {
+                const String *v = value(s.slot);
+                if (v) {
+                    src = v->c_str();
+                    len = v->length();
+                }
+            }
+
+            size_t n = len - pos;
+            if (n > maxLen - written) n = maxLen - written;
+            memcpy_P(buffer + written, src + pos, n);
+            written += n;
+            pos += n;
+            if (pos >= len) {
+                seg++;
+                pos = 0;
+            }
+        }
+        return written;
+    }
+
+    // Ordnet die Werte einer Map einmalig den Slots einer Seite zu
+    class SlotMap {
+    public:
+        SlotMap(const Page &page, std::map<String, String> values);
+        SlotMap(SlotMap&&) = default;               // Map-Knoten bleiben beim Move erhalten
+        SlotMap(const SlotMap&) = delete;
+        const String* get(int slot) const { return _bySlot[slot]; }   // nullptr = nicht gesetzt
+        size_t size() const { return _bySlot.size(); }
+    private:
+        std::map<String, String>    _values;
+        std::vector<const String*>  _bySlot;
+    };
+
+    // Füllt Puffer aus den Segmenten einer Seite, Slot-Werte werden beim Start aufgelöst
+    class Renderer {
+    public:
+        Renderer(PagePtr page, std::map<String, String> values);
+        size_t fill(uint8_t *buffer, size_t maxLen);
+        bool   done() const { return _seg >= _page->segments().size(); }
+        RouteMetrics::Meter meter() const { return _meter; }
+    private:
+        RouteMetrics::Meter _meter = RouteMetrics::current();  // Route, deren Handler die Antwort erzeugt
+        PagePtr _page;
+        SlotMap _values;
+        size_t  _seg = 0;
+        size_t  _pos = 0;
+    };
+
+    // Liest die Datei blockweise direkt in den Sendepuffer. Pro Request wird nur
+    // der Zustand gehalten, unabhängig von der Dateigröße.
+    class FileRenderer {
+    public:
+        FileRenderer(PagePtr head, PagePtr tail, File file, std::map<String, String> values);
+        ~FileRenderer() { _file.close(); }
+        size_t fill(uint8_t *buffer, size_t maxLen);
+        bool   done() const { return _phase == DONE; }
+        RouteMetrics::Meter meter() const { return _meter; }
+    private:
+        enum Phase : uint8_t { HEAD, BODY, TAIL, DONE };
+        size_t fillBody(uint8_t *buffer, size_t maxLen);
+        size_t fillPage(const PagePtr &page, uint8_t *buffer, size_t maxLen);
+        const String* lookup(const char *name, size_t len) const;
+
+        PagePtr _head;
+        PagePtr _tail;
+        File    _file;
+        std::map<String, String> _values;
+        Phase   _phase = HEAD;
+        size_t  _seg = 0;
+        size_t  _pos = 0;
+        const String *_value = nullptr;     // gerade ausgegebener Platzhalter-Wert
+        size_t  _valuePos = 0;
+        RouteMetrics::Meter _meter = RouteMetrics::current();
+    };
+
+    // base = html_template, marker = Stelle, an der der Seiteninhalt eingefügt wird
+    void begin(const char *base, const char *marker = "_BODY_CONTENT_");
+
+    // Kompilierte Seite aus PROGMEM-Inhalt (wird nicht kopiert), Cache über Adresse
+    PagePtr page(const char *content);
+    // Kompilierte Seite aus Datei (einmal gelesen), Cache über Pfad; nullptr wenn nicht
+    // vorhanden oder größer als kMaxCachedFileSize
+    PagePtr file(fs::FS &fs, const char *path);
+    // Kompilierte Seite aus dem Bundle (wird nicht kopiert), Cache über Adresse;
+    // nullptr wenn path nicht im Bundle ist
+    PagePtr file(const AssetBundle &bundle, const char *path);
+    // Cache leeren, z.B. nach Upload neuer SPIFFS-Dateien
+    void clear();
+
+    AsyncWebServerResponse* beginResponse(AsyncWebServerRequest *request,
+                                          PagePtr page,
+                                          std::map<String, String> values,
+                                          const char *contentType = "text/html");
+    // Streamt path ohne die Datei in den RAM zu laden; wrap = in html_template einbetten.
+    // nullptr wenn die Datei nicht existiert.
+    AsyncWebServerResponse* beginFileResponse(AsyncWebServerRequest *request,
+                                              fs::FS &fs, const char *path,
+                                              std::map<String, String> values,
+                                              bool wrap = true,
+                                              const char *contentType = "text/html");
+
+private:
+    PagePtr compile(const char *content, size_t len, std::unique_ptr<char[]> owned);
+    static void scan(Page &page, const char *text, size_t len);
+
+    const char *_base = nullptr;
+    size_t _headLen = 0;        // Länge von base bis zum Marker
+    const char *_tail = nullptr; // base nach dem Marker
+    size_t _tailLen = 0;
+    PagePtr _headPage;          // base bis zum Marker, für FileRenderer
+    PagePtr _tailPage;          // base nach dem Marker
+
+    std::map<const char*, PagePtr> _progmemPages;
+    std::map<String, PagePtr>      _filePages;
+};
+
+#endif
@@ -0,0 +1,149 @@
+#include "TraceBuffer.h"
+
+#ifdef WEB_TRACE
+
+#include <memory>
+
+namespace {
+
+// Alle Felder atomar, damit ein gleichzeitiges Lesen kein Data Race ist.
+// Felder mit release/acquire statt Fences, das kann ThreadSanitizer prüfen
+// (env:native_tsan, -Wtsan)
+struct Slot {
+    std::atomic<uint32_t> seq{0};       // 2*i+1 = wird geschrieben, 2*i+2 = Eintrag i fertig
+    std::atomic<uint32_t> ts{0};
+    std::atomic<uint32_t> dur{0};
+    std::atomic<uint32_t> id{0};
+    std::atomic<uint32_t> n{0};
+    std::atomic<uint32_t> kind{0};      // Span | instant << 8
+    std::atomic<const char*> arg{nullptr};
+};
+
+Slot slots[TraceBuffer::kEvents];
+std::atomic<uint32_t> head{0};
+
+const char *const kNames[TraceBuffer::kSpanCount] = {
+    "request", "handler", "file_open", "file_read", "render", "send_queued", "send_done", "ws_publish"
+};
+
+} // namespace
+
+void TraceBuffer::write(Span span, bool instant, uint32_t ts, uint32_t dur, uint32_t id, const char *arg, uint32_t n) {
+    uint32_t i = head.fetch_add(1, std::memory_order_relaxed);
+    Slot &s = slots[i & (kEvents - 1)];
+    s.seq.store(2 * i + 1, std::memory_order_relaxed);
+    // release: wer ein neues Feld liest, sieht auch die ungerade Sequenz
+    s.ts.store(ts, std::memory_order_release);
+    s.dur.store(dur, std::memory_order_release);
+    s.id.store(id, std::memory_order_release);
+    s.n.store(n, std::memory_order_release);
+    s.kind.store(span | (instant ? 0x100 : 0), std::memory_order_release);
+    s.arg.store(arg, std::memory_order_release);
+    s.seq.store(2 * i + 2, std::memory_order_release);
+}
+
+void TraceBuffer::complete(Span span, uint32_t startUs, uint32_t id, const char *arg, uint32_t n) {
+    write(span, false, startUs, micros() - startUs, id, arg, n);
+}
+
+void TraceBuffer::instant(Span span, uint32_t id, const char *arg, uint32_t n) {
+    write(span, true, micros(), 0, id, arg, n);
+}
+
+uint32_t TraceBuffer::end() {
+    return head.load(std::memory_order_acquire);
+}
+
+uint32_t TraceBuffer::first() {
+    uint32_t e = end();
+    return e > kEvents ? e - kEvents : 0;
+}
+
+bool TraceBuffer::read(uint32_t index, Event &out) {
+    const Slot &s = slots[index & (kEvents - 1)];
+    uint32_t before = s.seq.load(std::memory_order_acquire);
+    if (before != 2 * index + 2) return false;
+    // acquire: die zweite Sequenz-Abfrage bleibt hinter den Feldern
+    out.ts = s.ts.load(std::memory_order_acquire);
+    out.dur = s.dur.load(std::memory_order_acquire);
+    out.id = s.id.load(std::memory_order_acquire);
+    out.n = s.n.load(std::memory_order_acquire);
+    uint32_t kind = s.kind.load(std::memory_order_acquire);
+    out.arg = s.arg.load(std::memory_order_acquire);
+    if (s.seq.load(std::memory_order_relaxed) != before) return false;
+    out.span = (Span)(kind & 0xFF);
+    out.instant = (kind & 0x100) != 0;
+    return out.span < kSpanCount;
+}
+
+const char* TraceBuffer::name(Span span) {
+    return span < kSpanCount ? kNames[span] : "?";
+}
+
+void TraceBuffer::clear() {
+    // nur für Tests: ohne gleichzeitige Schreiber
+    for (Slot &s : slots) s.seq.store(0, std::memory_order_relaxed);
+    head.store(0, std::memory_order_release);
+}
+
+AsyncWebServerResponse* TraceBuffer::beginResponse(AsyncWebServerRequest *request) {
+    // Bereich beim Request festhalten; was danach überschrieben wird, fällt weg
+    struct State {
+        uint32_t next;
+        uint32_t end;
+        bool     opened = false;
+        bool     closed = false;
+        char     line[192];
+        size_t   len = 0;
+        size_t   pos = 0;
+    };
+    auto state = std::make_shared<State>();
+    state->next = first();
+    state->end = end();
+    return request->beginChunkedResponse("application/json",
+        [state](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+            size_t n = 0;
+            while (n < maxLen) {
+                if (state->pos == state->len) {
+                    State &s = *state;
+                    s.pos = 0;
+                    s.len = 0;
+                    if (!s.opened) {
+                        s.len = snprintf(s.line, sizeof(s.line),
+                                         "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+                                         "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"esp32\"}}");
+                        s.opened = true;
+                    } else if (s.next < s.end) {
+                        Event e;
+                        if (!read(s.next++, e)) continue;
+                        const char *arg = e.arg ? e.arg : "";
+                        if (e.instant) {
+                            s.len = snprintf(s.line, sizeof(s.line),
+                                             ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%u,\"pid\":1,\"tid\":%u,"
+                                             "\"args\":{\"arg\":\"%s\",\"n\":%u}}",
+                                             name(e.span), (unsigned)e.ts, (unsigned)e.id, arg, (unsigned)e.n);
+                        } else {
+                            s.len = snprintf(s.line, sizeof(s.line),
+                                             ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%u,\"dur\":%u,\"pid\":1,\"tid\":%u,"
+                                             "\"args\":{\"arg\":\"%s\",\"n\":%u}}",
+                                             name(e.span), (unsigned)e.ts, (unsigned)e.dur, (unsigned)e.id, arg, (unsigned)e.n);
+                        }
+                        if (s.len >= sizeof(s.line)) s.len = 0;     // zu langer Pfad: Eintrag weglassen
+                    } else if (!s.closed) {
+                        s.len = snprintf(s.line, sizeof(s.line), "\n]}\n");
+                        s.closed = true;
+                    } else {
+                        break;
+                    }
+                    continue;
+                }
+                size_t copy = std::min(state->len - state->pos, maxLen - n);
+                memcpy(buffer + n, state->line + state->pos, copy);
+                state->pos += copy;
+                n += copy;
+            }
+            return n;
+        });
+}
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef TRACEBUFFER_H
+#define TRACEBUFFER_H
+
+#include <Arduino.h>
+
+//----------------------------------------------------------------------------
+// TraceBuffer
+// Ringpuffer fester Größe mit Zeitspannen (Start + Dauer in µs) für die
+// Abschnitte eines Requests: Handler, Datei öffnen/lesen, Rendern eines
+// Blocks, Antwort übergeben, Senden fertig. /trace gibt ihn als Chrome
+// Trace-Event-JSON aus (chrome://tracing, ui.perfetto.dev); jeder Request
+// bekommt eine eigene Spur (tid = Request-Id), loop() die Spur 0.
+//
+// Schreiben ist lock-frei und aus dem AsyncTCP-Task und loop() zugleich
+// erlaubt: ein Schreiber holt sich per fetch_add einen Platz, die Sequenz-
+// nummer des Platzes ist ungerade, solange er schreibt. Der Leser verwirft
+// Einträge, deren Sequenz sich während des Kopierens geändert hat. Ältere
+// Einträge werden überschrieben.
+//
+// Nur mit -DWEB_TRACE übersetzt; ohne sind die TRACE_*-Makros leer und
+// /trace entfällt.
+//----------------------------------------------------------------------------
+#ifdef WEB_TRACE
+
+#include <ESPAsyncWebServer.h>
+#include <atomic>
+
+class TraceBuffer {
+public:
+    static constexpr size_t kEvents = 256;          // Zweierpotenz
+    static_assert((kEvents & (kEvents - 1)) == 0, "kEvents muss eine Zweierpotenz sein");
+
+    enum Span : uint8_t {
+        REQUEST,        // Handler-Aufruf bis Verbindungsende
+        HANDLER,        // Handler selbst
+        OPEN_FILE,      // nicht FILE_*: FILE_READ ist in FS.h ein Makro
+        READ_FILE,
+        RENDER,         // ein fill() der Antwort, n = Bytes
+        SEND_QUEUED,    // Antwort an AsyncTCP übergeben (Zeitpunkt)
+        SEND_DONE,      // Verbindung geschlossen (Zeitpunkt)
+        WS_PUBLISH,     // loop(): Zustand an WebSocket-Clients, n = Felder
+        kSpanCount
+    };
+
+    struct Event {
+        uint32_t    ts;
+        uint32_t    dur;
+        uint32_t    id;         // Request-Id, 0 = loop()
+        uint32_t    n;
+        Span        span;
+        bool        instant;
+        const char *arg;        // statischer String (Route, Pfad) oder nullptr
+    };
+
+    static void complete(Span span, uint32_t startUs, uint32_t id, const char *arg = nullptr, uint32_t n = 0);
+    static void instant(Span span, uint32_t id, const char *arg = nullptr, uint32_t n = 0);
+
+    // Kopiert den i-ten Eintrag ab dem ältesten noch vorhandenen; false = belegt/überschrieben
+    static bool read(uint32_t index, Event &out);
+    // Bereich [first, end) der aktuell lesbaren Indizes
+    static uint32_t end();
+    static uint32_t first();
+    static const char* name(Span span);
+    static void clear();
+
+    static AsyncWebServerResponse* beginResponse(AsyncWebServerRequest *request);
+
+    // Zeitspanne bis zum Ende des Blocks
+    class Scope {
+    public:
+        Scope(Span span, uint32_t id, const char *arg = nullptr)
+        : _span(span), _id(id), _arg(arg), _start(micros()) {}
+        ~Scope() { complete(_span, _start, _id, _arg); }
+    private:
+        Span _span;
+        uint32_t _id;
+        const char *_arg;
+        uint32_t _start;
+    };
+
+private:
+    static void write(Span span, bool instant, uint32_t ts, uint32_t dur, uint32_t id, const char *arg, uint32_t n);
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(span, id, arg) TraceBuffer::Scope TRACE_CONCAT(traceScope_, __LINE__)(TraceBuffer::span, id, arg)
+#define TRACE_COMPLETE(span, startUs, id, arg, n) TraceBuffer::complete(TraceBuffer::span, startUs, id, arg, n)
+#define TRACE_INSTANT(span, id, arg) TraceBuffer::instant(TraceBuffer::span, id, arg)
+#define TRACE_START(var) uint32_t var = micros()
+
+#else
+
+#define TRACE_SCOPE(span, id, arg)
+#define TRACE_COMPLETE(span, startUs, id, arg, n) ((void)0)
+#define TRACE_INSTANT(span, id, arg) ((void)0)
+#define TRACE_START(var)
+
+#endif
+
+#endif
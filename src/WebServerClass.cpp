@@ -2,12 +2,26 @@
 #include <SPIFFS.h>
 #include <ArduinoJson.h>
 #include <ElegantOTA.h>
-#include "html_template.h"
-#include "html_pages.h"
+#include "static_pages.h"
 #include <ConfigManager.h>
 
+// Misst die Zeit vom Boot bis zum ersten HTTP-Request; bearbeitet selbst nichts
+class FirstRequestProbe : public AsyncWebHandler {
+public:
+    bool canHandle(AsyncWebServerRequest *request) override {
+        if (!_seen) {
+            _seen = true;
+            Serial.printf("⏱️  Erster HTTP-Request nach %lu ms: %s\n", millis(), request->url().c_str());
+        }
+        return false;
+    }
+private:
+    bool _seen = false;
+};
+
 WebServerClass::WebServerClass()
-: _server(80), _ws("/ws") {}
+: _server(80), _ws("/ws"), _fanout(_ws), _state(_fanout), _eventSource("/events"), _events(_eventSource),
+  _assets(SPIFFS), _wifi(_wifiDriver) {}
 
 void WebServerClass::setCredentials(const String& ssid, const String& password) {
     _ssid = ssid;
@@ -22,392 +36,668 @@ void WebServerClass::begin() {
     if (!SPIFFS.begin(true)) {
         Serial.println("Fehler beim Mounten von SPIFFS");
     }
+    // Asset-Bundle direkt aus dem Flash; fehlt es oder ist es älter als die
+    // Firmware (ETags, ?v=), bleibt SPIFFS die Quelle
+    if (_bundle.map() && !_bundle.matches(ASSET_VERSION)) {
+        Serial.println("Asset-Bundle passt nicht zur Firmware (pio run -t uploadassets), nutze SPIFFS");
+        _bundle.end();
+    }
 
     ConfigManager::begin();
+    // vor _server.begin(), danach schreibt nur noch handleSaveEeprom()
+    strncpy(_text, ConfigManager::text(), sizeof(_text) - 1);
     if (_ssid.isEmpty() || _password.isEmpty()) {
         Serial.println("Keine WLAN-Daten gesetzt, lese aus ConfigManager...");
         loadEEPROMWifiConf(false);
         loadEEPROMWifiConf(true); // AP-Daten laden
     }
-    connectOrStartAP();
-
-    // Statische Assets
-    _server.serveStatic("/favicon-96x96.png", SPIFFS, "/favicon-96x96.png");
-    _server.serveStatic("/style.css",   SPIFFS, "/style.css");
-    _server.serveStatic("/script.js",   SPIFFS, "/script.js");
-    _server.serveStatic("/images",      SPIFFS, "/images");
+    // vor _server.begin(), danach übernimmt applyCommands() die Änderungen
+    strncpy(_statusApSsid, _apSsid.c_str(), sizeof(_statusApSsid) - 1);
+    _statusApSN = _apSN;
+    // Verbindungsaufbau läuft im Hintergrund (WifiManager::loop), der Server startet sofort
+    _wifiDriver.configureAp(_apSsid, _apPassword, _apIP, _apGW, _apSN);
+    _wifiDriver.attach(_wifi);
+    _wifi.begin(_ssid, _password, millis());
+
+    _templates.begin(html_template);
+    _server.addHandler(new FirstRequestProbe());
+
+    // Statische Assets (gzip + ETag, siehe tools/build_assets.py)
+    _assets.serve("/favicon-96x96.png")
+           .serve("/style.css")
+           .serve("/script.js")
+           .serve("/images/")
+           .admission(&_admission)
+           .bundle(&_bundle);
+    _server.addHandler(&_assets);
 
     setupWebSocket();
+    // neue Epoche je Start: Last-Event-IDs von vor dem Neustart gelten nicht
+    _events.begin((uint16_t)esp_random());
+    _server.addHandler(&_eventSource);
     setupRoutes();
+    updateStatus();
 
     // ElegantOTA Setup (Basic-Auth admin/admin; bei Bedarf ändern)
     ElegantOTA.begin(&_server); // No credentials by default; see docs for auth
 
     _server.begin();
-    Serial.println("✅ Async Webserver gestartet.");
+    Serial.printf("✅ Async Webserver gestartet nach %lu ms.\n", millis());
 }
 
 void WebServerClass::loop() {
+    _wifi.loop(millis());
+    applyCommands();
+    ConfigManager::loop();
+    _metrics.sampleHeap();
+
+    if (millis() - _lastStatus >= kStatusRefreshMs) {
+        _lastStatus = millis();
+        updateStatus();
+    }
+
     static unsigned long previousMillis = 0;
     if (millis() - previousMillis >= 1000) {
         previousMillis = millis();
-        _counter++;
+        _device.update([](DeviceState::Snapshot &d) { d.counter++; });
     }
 
-    // WebSocket Broadcast + ggf. Blinken
+    // Blinken + Zustand für WebSocket und /events einsammeln
     if (millis() - _lastWsBroadcast >= 1000) {
-        if (_blinkState) {
-            _ledState = !_ledState;
-            digitalWrite(_ledPin, _ledState ? HIGH : LOW);
-        }
-        JsonDocument doc;
-        doc["uptime"] = millis() / 1000;
-        doc["led"] = _ledState;
-
-        String json;
-        serializeJson(doc, json);
-        _ws.textAll(json);
+        _device.update([](DeviceState::Snapshot &d) {
+            if (d.blink) d.led = !d.led;
+        });
+        unsigned long uptime = millis() / 1000;
+        _state.set(StateChannel::UPTIME,    (int32_t)(uptime - uptime % kUptimePublishSec));
+        _state.set(StateChannel::WIFI_MODE, currentMode());
+        _state.set(StateChannel::WIFI_IP,   currentIP());
+        _events.set(EventStream::UPTIME,    (int32_t)uptime);
+        _events.set(EventStream::FREE_HEAP, (int32_t)ESP.getFreeHeap());
 
         _lastWsBroadcast = millis();
     }
+    // ein konsistenter Stand für Pin, WebSocket und /events
+    DeviceState::Snapshot device = _device.read();
+    if (device.led != _ledOutput) {
+        _ledOutput = device.led;
+        digitalWrite(_ledPin, _ledOutput ? HIGH : LOW);
+    }
+    _state.set(StateChannel::COUNTER, device.counter);
+    _state.set(StateChannel::LED,     device.led);
+    _state.set(StateChannel::BLINK,   device.blink);
+    // nur geänderte Felder, ein Frame für alle Clients
+    TRACE_START(publishStart);
+    size_t published = _state.publish();
+    if (published > 0) TRACE_COMPLETE(WS_PUBLISH, publishStart, 0, nullptr, published);
+    // Zähler kann sich auch über /counter_reset und /set_counter ändern
+    _events.set(EventStream::COUNTER, device.counter);
+    _events.set(EventStream::LED,     device.led);
+    _events.publish();
 
     // Geplanter Neustart?
-    if (_pendingRestartAt != 0 && millis() >= _pendingRestartAt) {
+    if (device.restartAt != 0 && millis() >= device.restartAt) {
         Serial.println("🔄 Neustart wird jetzt ausgeführt...");
+        // noch nicht gespeicherte Konfiguration (ConfigCache) nicht verlieren
+        if (ConfigManager::pending() && !ConfigManager::flush()) {
+            Serial.println("Fehler: Konfiguration vor dem Neustart nicht gespeichert");
+        }
         delay(100);
         ESP.restart();
     }
 }
 
-void WebServerClass::connectOrStartAP() {
-    if (_ssid.isEmpty() || _password.isEmpty()) {
-        Serial.println("⚠️  Keine WLAN-Daten gesetzt – starte AP.");
-        startAP();
+void WebServerClass::setupWebSocket() {
+    _ws.onEvent([this](AsyncWebSocket *server, AsyncWebSocketClient *client,
+                       AwsEventType type, void *arg, uint8_t *data, size_t len) {
+
+        if (type == WS_EVT_CONNECT) {
+            // Subprotocol wurde vom Browser angefragt und von AsyncWebSocket bestätigt
+            AsyncWebServerRequest *request = (AsyncWebServerRequest*)arg;
+            if (request && request->hasHeader("Sec-WebSocket-Protocol")
+                && request->header("Sec-WebSocket-Protocol") == WsProtocol::kSubprotocol) {
+                WsFanout::markBinary(client);
+            }
+            // Neuer Client bekommt beim nächsten loop() den vollständigen Zustand (WsFanout)
+            DBG_PRINTLN(WsFanout::isBinary(client) ? "WebSocket verbunden (binär)" : "WebSocket verbunden");
+            return;
+        }
+        if (type == WS_EVT_DISCONNECT) {
+            _wsRx.release(client->id());
+            return;
+        }
+        if (type == WS_EVT_DATA) {
+            // data ist evtl. nur ein Teil der Nachricht (Fragmente, TCP-Segmente)
+            size_t msgLen = 0;
+            uint8_t opcode = 0;
+            const uint8_t *msg = _wsRx.feed(client->id(), *(AwsFrameInfo*)arg, data, len, msgLen, opcode);
+            if (msg) handleWsMessage(client->id(), opcode, msg, msgLen);
+        }
+    });
+    _server.addHandler(&_ws);
+}
+
+// Vollständige Nachricht auswerten, direkt auf den empfangenen Bytes
+void WebServerClass::handleWsMessage(uint32_t clientId, uint8_t opcode, const uint8_t *data, size_t len) {
+    WsProtocol::Command cmd;
+    if (opcode == WS_BINARY) {
+        if (WsProtocol::decodeCommand(data, len, cmd)) handleWsCommand(cmd, clientId);
+        else DBG_PRINTLN("Ungültiger Binärframe empfangen");
+        return;
+    }
+
+    // JsonDocument auf festem Puffer: kein String, kein Heap
+    _wsJsonPool.reset();
+    JsonDocument doc(&_wsJsonPool);
+    DeserializationError err = deserializeJson(doc, (const char*)data, len);
+    if (err) {
+        Serial.println("Ungültiges JSON empfangen");
         return;
     }
 
-    Serial.printf("🔌 Verbinde zu %s, %s ...\n", _ssid.c_str(), _password.c_str());
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(_ssid.c_str(), _password.c_str());
+    cmd.hasBlink = doc["blink"].is<bool>();
+    cmd.blink    = doc["blink"];
+    cmd.hasLed   = doc["led"].is<bool>();
+    cmd.led      = doc["led"];
+    handleWsCommand(cmd, clientId);
+}
+
+// LED/Blinken aus JSON- oder Binärnachricht an loop() weiterreichen (applyCommands)
+void WebServerClass::handleWsCommand(const WsProtocol::Command &cmd, uint32_t clientId) {
+    CommandQueue::Command queued;
+    queued.kind = CommandQueue::WS_SET;
+    queued.clientId = clientId;
+    queued.set = cmd;
+    if (!_commands.push(queued)) DBG_PRINTLN("Befehlspuffer voll, WebSocket-Befehl verworfen");
+}
 
-    const unsigned long timeoutMs = 12000;
-    unsigned long start = millis();
-    while (WiFi.status() != WL_CONNECTED && millis() - start < timeoutMs) {
-        delay(400);
-        Serial.print(".");
+// Befehle aus den Handlern anwenden; hier darf es blockieren (ConfigManager-
+// Sperre während eines Commits), die Verbindungen laufen im AsyncTCP-Task weiter
+void WebServerClass::applyCommands() {
+    CommandQueue::Batch batch;
+    if (!_commands.take(batch)) return;
+
+    if (batch.hasSet) {
+        const WsProtocol::Command &set = batch.set;
+        _device.update([&set](DeviceState::Snapshot &d) {
+            if (set.hasBlink) d.blink = set.blink;
+            if (set.hasLed)   d.led = set.led;
+        });
+        if (set.hasBlink) DBG_PRINTLN(set.blink ? "Blinken aktiviert" : "Blinken deaktiviert");
+        if (set.hasLed)   DBG_PRINTLN(set.led ? "LED AN" : "LED AUS");
+    }
+    if (batch.hasText && strcmp(batch.text, ConfigManager::text()) != 0) {
+        // landet im RAM-Abbild, gespeichert wird gesammelt in ConfigManager::loop()
+        ConfigManager::writeString(batch.text);
+        Serial.printf("EEPROM-Text geändert: %s\n", batch.text);
     }
+    for (int ap = 0; ap < 2; ap++) {
+        if (batch.hasWifi[ap]) ConfigManager::writeWifiConf(batch.wifi[ap], ap == 1);
+    }
+    if (batch.hasWifi[1]) {
+        // gleich groß wie WifiConf::ssid, das letzte Byte bleibt '\0'
+        memcpy(_statusApSsid, batch.wifi[1].ssid, sizeof(_statusApSsid) - 1);
+        _statusApSN = batch.wifi[1].sn;
+    }
+    if (batch.reboot) {
+        uint32_t restartAt = millis() + 2000;
+        _device.update([restartAt](DeviceState::Snapshot &d) { d.restartAt = restartAt; });
+    }
+    _commands.done(batch.lastSeq);
+
+    // Quittung an die WebSocket-Absender, der neue Zustand folgt als Delta
+    for (size_t i = 0; i < batch.ackCount; i++) {
+        AsyncWebSocketClient *client = _ws.client(batch.acks[i].clientId);
+        if (!client) continue;
+        if (WsFanout::isBinary(client)) {
+            uint8_t frame[5];
+            client->binary(frame, WsProtocol::encodeAck(batch.acks[i].seq, frame, sizeof(frame)));
+        } else {
+            char json[24];
+            snprintf(json, sizeof(json), "{\"ack\":%u}", (unsigned)batch.acks[i].seq);
+            client->text(json);
+        }
+    }
+}
+
+void WebServerClass::setupRoutes() {
+    // Feste Routen: ein Handler, perfekter Hash zur Compile-Zeit (RouteTable).
+    // Ohne Angabe teuer, siehe AdmissionControl
+    using R = RouteTable::Route<WebServerClass>;
+    constexpr AdmissionControl::Cost CHEAP = AdmissionControl::CHEAP;
+    constexpr AdmissionControl::Cost EXPENSIVE = AdmissionControl::EXPENSIVE;
+    static constexpr R kRoutes[] = {
+        {"/",              HTTP_GET,             CHEAP,     &WebServerClass::handleRoot},
+        {"/index",         HTTP_GET,             EXPENSIVE, &WebServerClass::handleIndex},
+        {"/status",        HTTP_GET,             EXPENSIVE, &WebServerClass::handleStatusPage},
+        {"/save_eeprom",   HTTP_POST,            CHEAP,     &WebServerClass::handleSaveEeprom},
+        {"/counter_reset", HTTP_GET,             CHEAP,     &WebServerClass::handleCounterReset},
+        {"/set_counter",   HTTP_POST,            CHEAP,     &WebServerClass::handleSetCounter},
+        {"/counter",       HTTP_GET,             CHEAP,     &WebServerClass::handleCounter},
+        {"/status.json",   HTTP_GET,             CHEAP,     &WebServerClass::handleStatusJson},
+        {"/websocket",     HTTP_GET,             EXPENSIVE, &WebServerClass::handleWebsocketPage},
+        {"/config",        HTTP_GET,             EXPENSIVE, &WebServerClass::handleConfigPage},
+        {"/save_sta",      HTTP_POST,            CHEAP,     &WebServerClass::handleSaveSta},
+        {"/save_ap",       HTTP_POST,            CHEAP,     &WebServerClass::handleSaveAp},
+        {"/test",          HTTP_GET,             EXPENSIVE, &WebServerClass::handleTestPage},
+        {"/admission",     HTTP_GET | HTTP_POST, CHEAP,     &WebServerClass::handleAdmission},
+        {"/metrics",       HTTP_GET,             CHEAP,     &WebServerClass::handleMetrics},
+#ifdef WEB_TRACE
+        {"/trace",         HTTP_GET,             CHEAP,     &WebServerClass::handleTrace},
+#endif
+    };
+    static constexpr auto kIndex = RouteTable::index(kRoutes);
+    _routes.install(this, kRoutes, kIndex)
+           .metrics(&_metrics, sizeof(kRoutes) / sizeof(kRoutes[0]))
+           .admission(&_admission);
+    _server.addHandler(&_routes);
+
+    // 404 für alles andere
+    _server.onNotFound(_metrics.wrap("*", HTTP_ANY, [this](AsyncWebServerRequest *request) {
+        send(request, 404, "text/plain", "Seite nicht gefunden");
+    }));
+}
+
+// Redirect Root -> /index (bestehende Startseite)
+void WebServerClass::handleRoot(AsyncWebServerRequest *request) {
+    request->redirect("/index");
+}
+
+//----------------------------------------------------------------------------
+// Startseite erstellt mit html_template und index.html
+//----------------------------------------------------------------------------
+void WebServerClass::handleIndex(AsyncWebServerRequest *request) {
+    std::map<String, String> values = {
+        {"UPTIME", String(millis() / 1000)}
+    };
+    sendCachedFile(request, "/index", "/index.html", std::move(values), {"UPTIME"});
+}
 
-    if (WiFi.status() == WL_CONNECTED) {
-        Serial.println("\n📡 WLAN verbunden");
-        Serial.print("🌐 IP-Adresse: ");
-        Serial.println(WiFi.localIP());
+//----------------------------------------------------------------------------
+// Status-Seite erstellt mit htm_template und status_content aus html_pages.h
+//----------------------------------------------------------------------------
+void WebServerClass::handleStatusPage(AsyncWebServerRequest *request) {
+    // Slots zur Compile-Zeit aufgelöst (static_pages.h), kein Map-Aufbau je Request.
+    // EEPROM_TEXT ist stabil: ein neuer Text ergibt einen neuen Cache-Schlüssel
+    StatusPage::Values values;
+    String counter(_device.read().counter);
+    values.set(StatusSlot::EEPROM_TEXT,   _text);
+    values.set(StatusSlot::COUNTER_VALUE, counter);
+    values.set(StatusSlot::SET_COUNTER,   "0");
+    values.set(StatusSlot::CUR_COUNTER,   counter);
+    // Zählerstände ändern sich sekündlich und bleiben als Lücke im Cache
+    uint32_t volatileSlots = PageCache::slotMask({(int)StatusSlot::COUNTER_VALUE,
+                                                  (int)StatusSlot::CUR_COUNTER});
+    auto entry = _pageCache.fetch("/status", StatusPage::kTable.items, StatusPage::kSegments,
+                                  StatusPage::Values::kCount, values, volatileSlots);
+    request->send(PageCache::beginResponse(request, entry, std::move(values)));
+}
+
+// Daten entgegennehmen und in EEPROM speichern
+void WebServerClass::handleSaveEeprom(AsyncWebServerRequest *request) {
+    if (request->hasParam("data", true)) {
+        // Vergleichen und Schreiben in loop() (applyCommands), /status zeigt
+        // sofort den eingereihten Text
+        CommandQueue::Command cmd;
+        cmd.kind = CommandQueue::SAVE_TEXT;
+        strncpy(cmd.text, request->getParam("data", true)->value().c_str(), sizeof(cmd.text) - 1);
+        uint32_t seq = _commands.push(cmd);
+        if (seq != 0) memcpy(_text, cmd.text, sizeof(_text));
+        sendQueued(request, seq, "OK");
     } else {
-        Serial.println("\n⛔ Konnte nicht verbinden – starte AP.");
-        startAP();
+        send(request, 400, "text/plain", "Bad Request");
     }
 }
 
-void WebServerClass::startAP() {
-    WiFi.mode(WIFI_AP);
-    WiFi.softAPConfig(_apIP, _apGW, _apSN);
-    WiFi.softAP(_apSsid.c_str(), _apPassword.c_str());
-    delay(200); // kurze Stabilisierung
-    Serial.printf("📶 AP gestartet: SSID=%s, PASS=%s\n", _apSsid.c_str(), _apPassword.c_str());
-    Serial.print("🌐 AP-IP: "); Serial.println(WiFi.softAPIP());
+// Zähler zurücksetzen
+void WebServerClass::handleCounterReset(AsyncWebServerRequest *request) {
+    _device.update([](DeviceState::Snapshot &d) { d.counter = 0; });
+    send(request, 200, "text/plain", "Ok");
 }
 
-void WebServerClass::setupWebSocket() {
-    _ws.onEvent([this](AsyncWebSocket *server, AsyncWebSocketClient *client,
-                       AwsEventType type, void *arg, uint8_t *data, size_t len) {
+// Zähler neu setzen
+void WebServerClass::handleSetCounter(AsyncWebServerRequest *request) {
+    if (request->hasParam("data", true)) {
+        String receivedData = request->getParam("data", true)->value();
+        int32_t counter = receivedData.toInt();
+        _device.update([counter](DeviceState::Snapshot &d) { d.counter = counter; });
+        _pageCache.invalidate("/status");
+    }
+    send(request, 200, "text/plain", "Ok");
+}
 
-        if (type == WS_EVT_CONNECT) {
-            DBG_PRINTLN("WebSocket verbunden");
-            client->text("{\"status\":\"verbunden\"}");
-            return;
-        }
-        if (type == WS_EVT_DATA) {
-            String msg;
-            msg.reserve(len + 1);
-            for (size_t i = 0; i < len; i++) msg += (char)data[i];
-
-            JsonDocument doc;
-            DeserializationError err = deserializeJson(doc, msg);
-            if (err) {
-                Serial.println("Ungültiges JSON empfangen");
-                return;
-            }
+// Counter endpoints
+void WebServerClass::handleCounter(AsyncWebServerRequest *request) {
+    send(request, 200, "text/plain", String(_device.read().counter));
+}
 
-            if (doc["blink"].is<bool>()) {
-                _blinkState = doc["blink"];
-                DBG_PRINTLN(_blinkState ? "Blinken aktiviert" : "Blinken deaktiviert");
-            }
-            if (doc["led"].is<bool>()) {
-                _ledState = doc["led"];
-                digitalWrite(_ledPin, _ledState ? HIGH : LOW);
-                DBG_PRINTLN(_ledState ? "LED AN" : "LED AUS");
-            }
-        }
-    });
-    _server.addHandler(&_ws);
+// JSON-Status
+void WebServerClass::handleStatusJson(AsyncWebServerRequest *request) {
+    request->send(_status.beginResponse(request));
 }
 
-void WebServerClass::setupRoutes() {
-    auto sendPage = [this](AsyncWebServerRequest *request, 
-                        const char* content, 
-                        const std::map<String, String> &replacements) {
-        String output = html_template;
-        output.replace("_BODY_CONTENT_", content);
-        for (const auto& pair : replacements) {
-            output.replace("%" + pair.first + "%", pair.second);
-        }
-        request->send(200, "text/html", output);
+//----------------------------------------------------------------------------
+// WebSocket Demo Seite websocket.html
+//----------------------------------------------------------------------------
+void WebServerClass::handleWebsocketPage(AsyncWebServerRequest *request) {
+    sendDynamicFile(request, "/websocket.html", {});
+}
+
+//----------------------------------------------------------------------------
+// Konfiguration Seite erstellt mit html_template und index.html
+//----------------------------------------------------------------------------
+void WebServerClass::handleConfigPage(AsyncWebServerRequest *request) {
+    std::map<String, String> replacements = {
+        {"CUR_IP",    currentIP()},
+        {"CUR_SUB",   currentSubnet(_apSN)},
+        {"STA_SSID",  (WiFi.getMode() & WIFI_STA) ? WiFi.SSID() : _ssid},
+        {"STA_PASS",   _password},
+        {"IP_ADR",    _locIP.toString()},
+        {"SN_MASK",    _locSN.toString()},
+        {"AP_SSID",   _apSsid},
+        {"AP_PASS",   _apPassword},
+        {"AP_IP_ADR", _apIP.toString()},
+        {"AP_GW_ADR", _apGW.toString()},
+        {"AP_SN_MASK",_apSN.toString()}    
     };
+    sendCachedFile(request, "/config", "/config.html", std::move(replacements));
+}
 
-    // Redirect Root -> /index (bestehende Startseite)
-    _server.on("/", HTTP_GET, [this](AsyncWebServerRequest *request) {
-        request->redirect("/index");
-    });
-    //----------------------------------------------------------------------------
-    // Startseite erstellt mit html_template und index.html
-    //----------------------------------------------------------------------------
-    _server.on("/index", HTTP_GET, [this](AsyncWebServerRequest *request) {
-        std::map<String, String> values = {
-            {"UPTIME", String(millis() / 1000)}
-        };
-        sendDynamicFile(request, "/index.html", values);
-    });
-    //----------------------------------------------------------------------------
-    // Status-Seite erstellt mit htm_template und status_content aus html_pages.h
-    //----------------------------------------------------------------------------
-    _server.on("/status", HTTP_GET, [this](AsyncWebServerRequest *request) {
-        ConfigManager::readString(_eepromText);
-        std::map<String, String> replacements = {
-            {"EEPROM_TEXT", _eepromText},
-            {"SET_COUNTER", "0"},
-            {"CUR_COUNTER", String(_counter)}
-        };
-        sendDynamicPage(request, status_content, replacements);
-    });
-    // Daten entgegennehmen und in EEPROM speichern
-    _server.on("/save_eeprom", HTTP_POST, [this](AsyncWebServerRequest *request){
-        if (request->hasParam("data", true)) {
-            String receivedData = request->getParam("data", true)->value();
-            if (_eepromText != receivedData) {
-                _eepromText = receivedData;
-
-                // [EEPROM_WRITE] -> hier später mit deiner EEPROM-Klasse ersetzen
-                ConfigManager::writeString(_eepromText);
-                Serial.println("EEPROM-Text geändert: " + receivedData);
-            }
-            request->send(200, "text/plain", "OK");
-        } else {
-            request->send(400, "text/plain", "Bad Request");
-        }
-    });
-    // Zähler zurücksetzen
-    _server.on("/counter_reset", HTTP_GET, [this](AsyncWebServerRequest *request){
-        _counter = 0;
-        request->send(200, "text/plain", "Ok");
-    });
-    // Zähler neu setzen
-    _server.on("/set_counter", HTTP_POST, [this](AsyncWebServerRequest *request){
-        if (request->hasParam("data", true)) {
-            String receivedData = request->getParam("data", true)->value();
-            _counter = receivedData.toInt();
-        }
-        request->send(200, "text/plain", "Ok");
-    });
-    // Counter endpoints
-    _server.on("/counter", HTTP_GET, [this](AsyncWebServerRequest *request){
-        request->send(200, "text/plain", String(_counter));
-    });
-    // JSON-Status
-    _server.on("/status.json", HTTP_GET, [this](AsyncWebServerRequest *request) {
-        JsonDocument doc;
-        doc["uptime_sec"]   = millis() / 1000;
-        doc["counter"]      = _counter;
-        doc["wifi_mode"]    = currentMode();
-        doc["wifi_ssid"]    = (WiFi.getMode() & WIFI_STA) ? WiFi.SSID() : _apSsid;
-        doc["ip"]           = currentIP();
-        doc["subnet"]       = currentSubnet();
-        doc["free_heap"]    = ESP.getFreeHeap();
-
-        String json;
-        serializeJson(doc, json);
-        request->send(200, "application/json", json);
-    });
-    //----------------------------------------------------------------------------
-    // WebSocket Demo Seite websocket.html
-    //----------------------------------------------------------------------------
-    _server.on("/websocket", HTTP_GET, [this](AsyncWebServerRequest *request) {
-        sendDynamicFile(request, "/websocket.html", {});
-    });
-    //----------------------------------------------------------------------------
-    // Konfiguration Seite erstellt mit html_template und index.html
-    //----------------------------------------------------------------------------
-    _server.on("/config", HTTP_GET, [this](AsyncWebServerRequest *request) {
-        std::map<String, String> replacements = {
-            {"CUR_IP",    currentIP()},
-            {"CUR_SUB",   currentSubnet()},
-            {"STA_SSID",  (WiFi.getMode() & WIFI_STA) ? WiFi.SSID() : _ssid},
-            {"STA_PASS",   _password},
-            {"IP_ADR",    _locIP.toString()},
-            {"SN_MASK",    _locSN.toString()},
-            {"AP_SSID",   _apSsid},
-            {"AP_PASS",   _apPassword},
-            {"AP_IP_ADR", _apIP.toString()},
-            {"AP_GW_ADR", _apGW.toString()},
-            {"AP_SN_MASK",_apSN.toString()}    
-        };
-        sendDynamicFile(request, "/config.html", replacements);
-    });
-    //------------ Speichern der Client (STA) Konfiguration ----------------
-    _server.on("/save_sta", HTTP_POST, [this](AsyncWebServerRequest *request) {
-        auto getP = [&](const String& name)->String{
-            return request->hasParam(name, true) ? request->getParam(name, true)->value() : "";
-        };
-        String newStaSsid = getP("sta_ssid");
-        String newStaPass = getP("sta_pass");
-        String newStaIP = getP("sta_ip");
-        String newStaSN = getP("sta_sn");
-        String staReboot  = getP("sta_reboot"); // "on" wenn Checkbox
-
-        if (newStaSsid.length()) _ssid = newStaSsid;
-        if (newStaPass.length()) _password = newStaPass;
-        if (newStaIP.length()) _locIP.fromString(newStaIP);
-        if (newStaSN.length()) _locSN.fromString(newStaSN);
-
-        saveEEPROMWifiConf(false);
-        
-        bool doReboot = (staReboot == "on");
-
-        String msg = "Konfiguration gespeichert.";
-        if (doReboot) {
-            msg += " Neustart in 2 Sekunden...";
-            _pendingRestartAt = millis() + 2000;
-            request->send(200, "text/plain", msg);
-        }
-        else         request->redirect("/config");        
-    });
-    //------------ Speichern der Access Point (AP) Konfiguration ----------------
-    _server.on("/save_ap", HTTP_POST, [this](AsyncWebServerRequest *request) {
-        auto getP = [&](const String& name)->String{
-            return request->hasParam(name, true) ? request->getParam(name, true)->value() : "";
+//------------ Speichern der Client (STA) Konfiguration ----------------
+void WebServerClass::handleSaveSta(AsyncWebServerRequest *request) {
+    auto getP = [&](const String& name)->String{
+        return request->hasParam(name, true) ? request->getParam(name, true)->value() : "";
+    };
+    String newStaSsid = getP("sta_ssid");
+    String newStaPass = getP("sta_pass");
+    String newStaIP = getP("sta_ip");
+    String newStaSN = getP("sta_sn");
+    String staReboot  = getP("sta_reboot"); // "on" wenn Checkbox
+
+    String ssid = newStaSsid.length() ? newStaSsid : _ssid;
+    String password = newStaPass.length() ? newStaPass : _password;
+    IPAddress ip = _locIP, sn = _locSN;
+    if (newStaIP.length()) ip.fromString(newStaIP);
+    if (newStaSN.length()) sn.fromString(newStaSN);
+
+    // Speichern und Neustart in loop() (applyCommands); die Member erst
+    // übernehmen, wenn der Befehl in der Queue steht
+    CommandQueue::Command cmd;
+    cmd.kind = CommandQueue::SAVE_WIFI;
+    cmd.wifi = wifiConf(ssid, password, ip, IPAddress(), sn);
+    cmd.reboot = (staReboot == "on");
+    uint32_t seq = _commands.push(cmd);
+    if (seq != 0) {
+        _ssid = ssid;
+        _password = password;
+        _locIP = ip;
+        _locSN = sn;
+        _pageCache.invalidate("/config");
+    }
+
+    if (cmd.reboot) sendQueued(request, seq, "Konfiguration gespeichert. Neustart in 2 Sekunden...");
+    else            sendQueued(request, seq, "", "/config");
+}
+
+//------------ Speichern der Access Point (AP) Konfiguration ----------------
+void WebServerClass::handleSaveAp(AsyncWebServerRequest *request) {
+    auto getP = [&](const String& name)->String{
+        return request->hasParam(name, true) ? request->getParam(name, true)->value() : "";
+    };
+    String newApSsid  = getP("ap_ssid");
+    String newApPass  = getP("ap_pass");
+    String newApIP = getP("ap_ip");
+    String newApGW = getP("ap_gw");
+    String newApSN = getP("ap_sn");
+    String apReboot   = getP("ap_reboot");
+
+    String ssid = newApSsid.length() ? newApSsid : _apSsid;
+    String password = newApPass.length() ? newApPass : _apPassword;
+    IPAddress ip = _apIP, gw = _apGW, sn = _apSN;
+    if (newApIP.length()) ip.fromString(newApIP);
+    if (newApGW.length()) gw.fromString(newApGW);
+    if (newApSN.length()) sn.fromString(newApSN);
+
+    CommandQueue::Command cmd;
+    cmd.kind = CommandQueue::SAVE_WIFI;
+    cmd.ap = true;
+    cmd.wifi = wifiConf(ssid, password, ip, gw, sn);
+    cmd.reboot = (apReboot == "on");
+    uint32_t seq = _commands.push(cmd);
+    if (seq != 0) {
+        _apSsid = ssid;
+        _apPassword = password;
+        _apIP = ip;
+        _apGW = gw;
+        _apSN = sn;
+        _pageCache.invalidate("/config");
+    }
+    sendQueued(request, seq, "", "/config");
+}
+
+//------------ Beispiel für eine weitere Seite ----------------------------
+// z.B. für eine weitere Seite mit eigener HTML-Datei im SPIFFS
+//----------------------------------------------------------------------------
+void WebServerClass::handleTestPage(AsyncWebServerRequest *request) {
+    // Vollständige HTML-Datei (ohne html_template): aus dem Bundle direkt
+    // aus dem Flash, aus SPIFFS blockweise gestreamt
+    AssetBundle::Asset bundled = _bundle.find("/test.html");
+    if (bundled) {
+        RouteMetrics::Meter meter = RouteMetrics::current();
+        meter.status(200);
+        meter.sent(bundled.size);
+        request->send_P(200, "text/html", bundled.data, bundled.size);
+        return;
+    }
+    AsyncWebServerResponse *response = _templates.beginFileResponse(request, SPIFFS, "/test.html", {}, false);
+    if (!response) {
+        send(request, 404, "text/plain", "Datei nicht gefunden");
+        return;
+    }
+    request->send(response);
+}
+
+// Zulassung: Grenzen und Zähler lesen, per POST zur Laufzeit setzen
+// (max_in_flight, min_free_heap, retry_after)
+void WebServerClass::handleAdmission(AsyncWebServerRequest *request) {
+    AdmissionControl::Limits limits = _admission.limits();
+    if (request->method() == HTTP_POST) {
+        auto read = [request](const char *name, uint32_t &target) {
+            if (!request->hasParam(name, true)) return;
+            long value = request->getParam(name, true)->value().toInt();
+            if (value >= 0) target = (uint32_t)value;
         };
-        String newApSsid  = getP("ap_ssid");
-        String newApPass  = getP("ap_pass");
-        String newApIP = getP("ap_ip");
-        String newApGW = getP("ap_gw");
-        String newApSN = getP("ap_sn");
-        String apReboot   = getP("ap_reboot");
-
-        if (newApSsid.length()) _apSsid = newApSsid;
-        if (newApPass.length()) _apPassword = newApPass;
-        if (newApIP.length()) _apIP.fromString(newApIP);
-        if (newApGW.length()) _apGW.fromString(newApGW);
-        if (newApSN.length()) _apSN.fromString(newApSN);
-
-        saveEEPROMWifiConf(true);
-
-        bool doReboot = (apReboot == "on");
-
-        String msg = "Konfiguration AP gespeichert.";
-        if (doReboot) {
-            msg += " Neustart in 2 Sekunden...";
-            _pendingRestartAt = millis() + 2000;
-        }
-        request->redirect("/config");
-    });
-    //------------ Beispiel für eine weitere Seite ----------------------------
-    // z.B. für eine weitere Seite mit eigener HTML-Datei im SPIFFS
-    //----------------------------------------------------------------------------
-    _server.on("/test", HTTP_GET, [this](AsyncWebServerRequest *request) {
-        File file = SPIFFS.open("/test.html", "r");
-        if (!file) {
-            request->send(404, "text/plain", "Datei nicht gefunden");
-            return;
-        }
-        String page = file.readString();
-        file.close();
-        request->send(200, "text/html", page);
-    });
-    // 404 für alles andere
-    _server.onNotFound([](AsyncWebServerRequest *request) {
-        request->send(404, "text/plain", "Seite nicht gefunden");
-    });
+        read("max_in_flight", limits.maxInFlight);
+        read("min_free_heap", limits.minFreeHeap);
+        read("retry_after",   limits.retryAfterSec);
+        _admission.setLimits(limits);
+    }
+    AdmissionControl::Stats stats = _admission.stats();
+    JsonDocument doc;
+    doc["max_in_flight"] = limits.maxInFlight;
+    doc["min_free_heap"] = limits.minFreeHeap;
+    doc["retry_after"]   = limits.retryAfterSec;
+    doc["in_flight"]     = RouteMetrics::inFlight();
+    doc["admitted"]      = stats.admitted;
+    doc["rejected_busy"] = stats.rejectedBusy;
+    doc["rejected_heap"] = stats.rejectedHeap;
+    String json;
+    serializeJson(doc, json);
+    send(request, 200, "application/json", json);
 }
 
-void WebServerClass::sendDynamicPage(AsyncWebServerRequest *request,
-                                     const String &content,
-                                     const std::map<String, String> &replacements)
-{
-    String output = html_template;
-    output.replace("_BODY_CONTENT_", content);
+// Kennzahlen pro Route im Prometheus-Textformat
+void WebServerClass::handleMetrics(AsyncWebServerRequest *request) {
+    request->send(_metrics.beginResponse(request));
+}
 
-    for (auto const &pair : replacements) {
-        output.replace("%" + pair.first + "%", pair.second);
+#ifdef WEB_TRACE
+// letzte Zeitspannen als Chrome Trace-Event-JSON
+void WebServerClass::handleTrace(AsyncWebServerRequest *request) {
+    request->send(TraceBuffer::beginResponse(request));
+}
+#endif
+
+// Status-JSON für /status.json in den freien Puffer von _status; die Requests
+// senden nur noch den fertigen Puffer, /events bekommt ihn als Event "status". Läuft in loop(): keine Member lesen,
+// die die Handler ändern (_apSsid, _apSN), Zähler nur über atomare stats()
+void WebServerClass::updateStatus() {
+    char *buffer = _status.begin();
+    if (!buffer) return;
+    JsonDocument doc;
+    doc["uptime_sec"]   = millis() / 1000;
+    doc["counter"]      = _device.read().counter;
+    doc["wifi_mode"]    = currentMode();
+    doc["wifi_ssid"]    = (WiFi.getMode() & WIFI_STA) ? WiFi.SSID() : String(_statusApSsid);
+    doc["ip"]           = currentIP();
+    doc["subnet"]       = currentSubnet(_statusApSN);
+    doc["wifi_state"]   = _wifi.stateName();
+    doc["wifi_attempts"] = _wifi.stats().attempts;
+    doc["wifi_drops"]    = _wifi.stats().drops;
+    doc["free_heap"]    = ESP.getFreeHeap();
+    doc["min_free_heap"] = _metrics.minFreeHeap();
+    doc["page_cache_hits"]   = _pageCache.stats().hits;
+    doc["page_cache_misses"] = _pageCache.stats().misses;
+    doc["ws_clients"]        = _fanout.clients();
+    doc["ws_queued"]         = _fanout.stats().queued;
+    doc["ws_max_queue"]      = _fanout.stats().maxQueue;
+    doc["ws_dropped"]        = _fanout.stats().dropped;
+    doc["ws_evictions"]      = _fanout.stats().evictions;
+    doc["ws_rx_reassembled"] = _wsRx.stats().reassembled;
+    doc["ws_rx_rejected"]    = _wsRx.stats().oversized + _wsRx.stats().noSlot + _wsRx.stats().protocol;
+    doc["config_writes"]     = ConfigManager::cacheStats().writes;
+    doc["config_commits"]    = ConfigManager::cacheStats().commits;
+    doc["config_appends"]    = ConfigManager::stats().appends;
+    doc["admission_rejected"] = _admission.stats().rejectedBusy + _admission.stats().rejectedHeap;
+    doc["commands_applied"]  = _commands.stats().applied;
+
+    size_t len = measureJson(doc);
+    if (len >= StatusSnapshot::kCapacity) {
+        Serial.println("Fehler: Status passt nicht in StatusSnapshot::kCapacity");
+        return;
     }
-    
-    request->send(200, "text/html", output);
+    serializeJson(doc, buffer, StatusSnapshot::kCapacity);
+    _status.commit(len);
+    // derselbe Stand als Stream für /events; buffer bleibt bis zum nächsten
+    // begin() unverändert
+    _events.publishStatus(buffer);
+}
+
+// Antwort auf einen Befehl an loop(): X-Command-Id nennt seine Nummer, angewendet
+// ist er, sobald commands_applied in /status.json sie erreicht. location: 302
+// dorthin. seq == 0 (Puffer voll): 503 mit Retry-After wie AdmissionControl
+void WebServerClass::sendQueued(AsyncWebServerRequest *request, uint32_t seq,
+                                const char *content, const char *location) {
+    int code = seq == 0 ? 503 : location ? 302 : 200;
+    if (seq == 0) content = "Befehlspuffer voll";
+    AsyncWebServerResponse *response = request->beginResponse(code, "text/plain", content);
+    if (seq == 0) {
+        response->addHeader("Retry-After", "1");
+    } else {
+        response->addHeader("X-Command-Id", String(seq));
+        if (location) response->addHeader("Location", location);
+    }
+    RouteMetrics::Meter meter = RouteMetrics::current();
+    meter.status(code);
+    meter.sent(strlen(content));
+    request->send(response);
+}
+
+// request->send() mit Status und Länge für RouteMetrics; die Antwort selbst
+// gibt ESPAsyncWebServer nicht mehr heraus
+void WebServerClass::send(AsyncWebServerRequest *request, int code,
+                          const char *contentType, const String &content) {
+    RouteMetrics::Meter meter = RouteMetrics::current();
+    meter.status(code);
+    meter.sent(content.length());
+    request->send(code, contentType, content);
 }
 
 void WebServerClass::sendDynamicFile(AsyncWebServerRequest *request,
                                      const char* path,
-                                     const std::map<String, String> &replacements)
+                                     std::map<String, String> replacements)
 {
-    File file = SPIFFS.open(path, "r");
-    if (!file) {
-        request->send(404, "text/plain", "Datei nicht gefunden");
+    // Kleine Seiten einmal zerlegen und im RAM halten, größere blockweise streamen
+    TemplateEngine::PagePtr page = filePage(path);
+    AsyncWebServerResponse *response = page
+        ? _templates.beginResponse(request, page, std::move(replacements))
+        : _templates.beginFileResponse(request, SPIFFS, path, std::move(replacements));
+    if (!response) {
+        send(request, 404, "text/plain", "Datei nicht gefunden");
         return;
     }
-    String content = file.readString();
-    file.close();
+    request->send(response);
+}
 
-    sendDynamicPage(request, content, replacements);
+// Wie sendDynamicFile, die gerenderte Seite wird aber pro Route im PageCache gehalten.
+// volatileSlots werden nicht gecacht, sondern bei jedem Request neu eingesetzt.
+void WebServerClass::sendCachedFile(AsyncWebServerRequest *request,
+                                    const char* route,
+                                    const char* path,
+                                    std::map<String, String> replacements,
+                                    std::initializer_list<const char*> volatileSlots)
+{
+    TemplateEngine::PagePtr page = filePage(path);
+    if (!page) {
+        // zu groß oder nicht vorhanden -> ungecacht streamen
+        sendDynamicFile(request, path, std::move(replacements));
+        return;
+    }
+    uint32_t volatileMask = 0;
+    for (const char *name : volatileSlots) volatileMask |= PageCache::slotMask({page->slotIndex(name)});
+
+    TemplateEngine::SlotMap values(*page, std::move(replacements));
+    const auto &segments = page->segments();
+    auto entry = _pageCache.fetch(route, segments.data(), segments.size(), values.size(), values, volatileMask);
+    request->send(PageCache::beginResponse(request, entry, std::move(values)));
+}
+
+// Seite aus dem Bundle (ohne Kopie, ohne Größenlimit), sonst aus SPIFFS
+TemplateEngine::PagePtr WebServerClass::filePage(const char *path) {
+    TemplateEngine::PagePtr page = _templates.file(_bundle, path);
+    return page ? page : _templates.file(SPIFFS, path);
 }
 
 // Nur Marker – du setzt hier später deine EEPROM-Klasse ein
 void WebServerClass::loadEEPROMWifiConf(bool ap) {
 //    Serial.println("[EEPROM_READ] Platzhalter – hier später Implementierung einfügen.");
-    WifiConf wifiConf;
-    ConfigManager::readWifiConf(wifiConf, ap);
+    const WifiRecord &rec = ConfigManager::wifi(ap);
     if (!ap) {
-        if (String(wifiConf.ssid).length() > 0) _ssid = String(wifiConf.ssid);
-        else _ssid = "";
-        if (String(wifiConf.password).length() > 0)_password = String(wifiConf.password);
-        else _password = "";
-        _locIP = wifiConf.ip;
-        _locSN = wifiConf.sn;
+        _ssid = rec.ssid;
+        _password = rec.password;
+        _locIP = ConfigManager::ip_from_bytes(rec.ip);
+        _locSN = ConfigManager::ip_from_bytes(rec.sn);
     } else {
-        if (String(wifiConf.ssid).length() > 0) _apSsid = String(wifiConf.ssid);
-        else _apSsid = "ESP32-Setup";
-        if (String(wifiConf.password).length() > 0) _apPassword = String(wifiConf.password);
-        else _apPassword = "admin";
-        _apIP = wifiConf.ip;    
-        _apGW = wifiConf.gw;    
-        _apSN = wifiConf.sn;        
+        _apSsid = rec.ssid[0] ? rec.ssid : "ESP32-Setup";
+        _apPassword = rec.password[0] ? rec.password : "admin";
+        _apIP = ConfigManager::ip_from_bytes(rec.ip);
+        _apGW = ConfigManager::ip_from_bytes(rec.gw);
+        _apSN = ConfigManager::ip_from_bytes(rec.sn);
     }
 }
 void WebServerClass::saveEEPROMWifiConf(bool ap) {
-    // Serial.println("[EEPROM_WRITE] Platzhalter – hier später Implementierung einfügen.");
+    ConfigManager::writeWifiConf(wifiConf(ap), ap);
+    _pageCache.invalidate("/config");
+}
+// Aktuelle STA- bzw. AP-Einstellungen als Datensatz für den ConfigManager
+WifiConf WebServerClass::wifiConf(bool ap) {
+    if (!ap) return wifiConf(_ssid, _password, _locIP, IPAddress(), _locSN);
+    return wifiConf(_apSsid, _apPassword, _apIP, _apGW, _apSN);
+}
+WifiConf WebServerClass::wifiConf(const String &ssid, const String &password,
+                                  IPAddress ip, IPAddress gw, IPAddress sn) {
     WifiConf wifiConf{};
-    if(!ap) {
-        strncpy(wifiConf.ssid, _ssid.c_str(), sizeof(wifiConf.ssid));
-        strncpy(wifiConf.password, _password.c_str(), sizeof(wifiConf.password));
-        wifiConf.ip = _locIP;
-        wifiConf.sn = _locSN;   
-    } else {
-        strncpy(wifiConf.ssid, _apSsid.c_str(), sizeof(wifiConf.ssid));
-        strncpy(wifiConf.password, _apPassword.c_str(), sizeof(wifiConf.password)); 
-        wifiConf.ip = _apIP;
-        wifiConf.gw = _apGW;
-        wifiConf.sn = _apSN;       
-    }
-    ConfigManager::writeWifiConf(wifiConf, ap);
+    strncpy(wifiConf.ssid, ssid.c_str(), sizeof(wifiConf.ssid));
+    strncpy(wifiConf.password, password.c_str(), sizeof(wifiConf.password));
+    wifiConf.ip = ip;
+    wifiConf.gw = gw;
+    wifiConf.sn = sn;
+    return wifiConf;
 }
 void WebServerClass::loadEEPROMText(String &text) {
     ConfigManager::readString(text);
 }
+// vor begin(), aus loop() nur ConfigManager: /status zeigt dann bis zum
+// nächsten /save_eeprom noch den alten Text (_text gehört dem AsyncTCP-Task)
 void WebServerClass::saveEEPROMText(const String &text) {
     ConfigManager::writeString(text);
 }
@@ -419,11 +709,12 @@ String WebServerClass::currentIP() {
     }
     return WiFi.softAPIP().toString();
 }
-String WebServerClass::currentSubnet() {
+// apSN: Kopie des Aufrufers (Handler: _apSN, loop(): _statusApSN)
+String WebServerClass::currentSubnet(IPAddress apSN) {
     if (WiFi.getMode() & WIFI_STA && WiFi.status() == WL_CONNECTED) {
         return WiFi.subnetMask().toString();
     }
-    return _apSN.toString();
+    return apSN.toString();
 }
 String WebServerClass::currentMode() {
     if (WiFi.getMode() & WIFI_STA && WiFi.status() == WL_CONNECTED) return "STA";
@@ -9,6 +9,23 @@
 #endif
 #include <ESPAsyncWebServer.h>
 #include <map>
+#include "TemplateEngine.h"
+#include "PageCache.h"
+#include "StaticAssetHandler.h"
+#include "StateChannel.h"
+#include "WsProtocol.h"
+#include "WsReassembler.h"
+#include "JsonPoolAllocator.h"
+#include "WifiManager.h"
+#include "EspWifiDriver.h"
+#include "RouteMetrics.h"
+#include "StatusSnapshot.h"
+#include "EventStream.h"
+#include "AdmissionControl.h"
+#include "DeviceState.h"
+#include "CommandQueue.h"
+#include "RouteTable.h"
+#include "AssetBundle.h"
 
 class WebServerClass {
 public:
@@ -27,6 +44,26 @@ private:
     // Web
     AsyncWebServer _server;
     AsyncWebSocket _ws;
+    WsFanout _fanout;
+    StateChannel _state;
+    AsyncEventSource _eventSource;  // /events (SSE) für Seiten, die nur lesen
+    EventStream _events;
+    WsReassembler _wsRx;
+    JsonPoolAllocator<2048> _wsJsonPool;   // Befehle sind klein, Rest meldet NoMemory
+    TemplateEngine _templates;
+    PageCache _pageCache;
+    AssetBundle _bundle;            // data/ aus der Partition "assets", sonst SPIFFS
+    StaticAssetHandler _assets;
+    RouteMetrics _metrics;
+    RouteTable::Dispatcher<WebServerClass> _routes;  // feste Routen aus setupRoutes()
+    AdmissionControl _admission;    // 503 für teure Routen bei Last/wenig Heap
+    StatusSnapshot _status;         // /status.json, in loop() neu formatiert
+    unsigned long _lastStatus = 0;
+    static constexpr unsigned long kStatusRefreshMs = 250;  // Dashboards fragen alle 500 ms
+
+    // WLAN (nicht blockierend, siehe WifiManager)
+    EspWifiDriver _wifiDriver;
+    WifiManager _wifi;
 
     // Standalone (STA) (Client) Credentials
     String _ssid;
@@ -43,32 +80,70 @@ private:
 
     // WebSocket Demo
     int _ledPin = 2;
-    bool _ledState = false;
-    bool _blinkState = false;
+    bool _ledOutput = false;        // zuletzt an _ledPin geschrieben, nur loop()
     unsigned long _lastWsBroadcast = 0;
+    static constexpr unsigned long kUptimePublishSec = 10; // Browser zählt dazwischen selbst
 
-    // Status/sonstiges
-    int _counter = 0;
-    String _eepromText = "";
-    unsigned long _pendingRestartAt = 0; // 0 = kein Neustart geplant
+    // Zähler, LED, Blinken, geplanter Neustart: Handler (AsyncTCP-Task) und
+    // loop() teilen sich den Zustand, siehe DeviceState
+    DeviceState _device;
+    // Befehle aus den Handlern, angewendet in loop() (Flash, GPIO)
+    CommandQueue _commands;
+    // EEPROM-Text für /status, gehört dem AsyncTCP-Task: ConfigManager::text() ändert
+    // loop() (applyCommands), die Handler lesen nur diese Kopie
+    char _text[MAX_TEXT] = {};
+    // AP-Name und Subnetz für /status.json, gehören loop(): die Handler ändern
+    // _apSsid/_apSN, loop() übernimmt sie aus dem Befehl (applyCommands)
+    char _statusApSsid[MAX_SSID] = {};
+    IPAddress _statusApSN;
 
 private:
-    void connectOrStartAP();
-    void startAP();
-
     void setupRoutes();
     void setupWebSocket();
+    void send(AsyncWebServerRequest *request, int code, const char *contentType, const String &content);
+    void updateStatus();
+    void handleWsMessage(uint32_t clientId, uint8_t opcode, const uint8_t *data, size_t len);
+    void handleWsCommand(const WsProtocol::Command &cmd, uint32_t clientId);
+    void applyCommands();
+    void sendQueued(AsyncWebServerRequest *request, uint32_t seq, const char *content,
+                    const char *location = nullptr);
+    WifiConf wifiConf(bool ap);
+    static WifiConf wifiConf(const String &ssid, const String &password,
+                             IPAddress ip, IPAddress gw, IPAddress sn);
+
+    // Handler der festen Routen (setupRoutes)
+    void handleRoot(AsyncWebServerRequest *request);
+    void handleIndex(AsyncWebServerRequest *request);
+    void handleStatusPage(AsyncWebServerRequest *request);
+    void handleSaveEeprom(AsyncWebServerRequest *request);
+    void handleCounterReset(AsyncWebServerRequest *request);
+    void handleSetCounter(AsyncWebServerRequest *request);
+    void handleCounter(AsyncWebServerRequest *request);
+    void handleStatusJson(AsyncWebServerRequest *request);
+    void handleWebsocketPage(AsyncWebServerRequest *request);
+    void handleConfigPage(AsyncWebServerRequest *request);
+    void handleSaveSta(AsyncWebServerRequest *request);
+    void handleSaveAp(AsyncWebServerRequest *request);
+    void handleTestPage(AsyncWebServerRequest *request);
+    void handleAdmission(AsyncWebServerRequest *request);
+    void handleMetrics(AsyncWebServerRequest *request);
+#ifdef WEB_TRACE
+    void handleTrace(AsyncWebServerRequest *request);
+#endif
 
-    void sendDynamicPage(AsyncWebServerRequest *request,
-                         const String &baseContent,
-                         const std::map<String, String> &replacements = {});
     void sendDynamicFile(AsyncWebServerRequest *request,
                          const char* path,
-                         const std::map<String, String> &replacements = {});
+                         std::map<String, String> replacements = {});
+    void sendCachedFile(AsyncWebServerRequest *request,
+                        const char* route,
+                        const char* path,
+                        std::map<String, String> replacements,
+                        std::initializer_list<const char*> volatileSlots = {});
+    TemplateEngine::PagePtr filePage(const char *path);
 
     // Helfer für Anzeige auf Config-Seite
     String currentIP();
-    String currentSubnet();
+    String currentSubnet(IPAddress apSN);
     String currentMode(); // "STA" oder "AP"
 };
 
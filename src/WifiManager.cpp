@@ -0,0 +1,108 @@
+#include "WifiManager.h"
+
+const char* WifiManager::stateName() const {
+    switch (_state) {
+        case State::AP_ONLY:    return "AP_ONLY";
+        case State::CONNECTING: return "CONNECTING";
+        case State::CONNECTED:  return "CONNECTED";
+        case State::BACKOFF:    return "BACKOFF";
+        default:                return "IDLE";
+    }
+}
+
+void WifiManager::begin(const String &ssid, const String &password, uint32_t now) {
+    _ssid = ssid;
+    _password = password;
+    _failures = 0;
+    _events.store(0);
+
+    if (_ssid.isEmpty() || _password.isEmpty()) {
+        Serial.println("⚠️  Keine WLAN-Daten gesetzt – starte AP.");
+        enableAp();
+        _state = State::AP_ONLY;
+        _since = now;
+        return;
+    }
+    startAttempt(now);
+}
+
+void WifiManager::loop(uint32_t now) {
+    uint8_t ev = _events.exchange(0);
+    if (ev & EV_DISCONNECTED) {
+        if (_state == State::CONNECTED) onLost(now);
+        else if (_state == State::CONNECTING) onFailed(now);
+    }
+    // GOT_IP und DISCONNECTED im selben Durchlauf: der Treiber entscheidet
+    if ((ev & EV_GOT_IP) && _state != State::CONNECTED && _state != State::AP_ONLY
+        && _driver.staConnected()) {
+        onConnected(now);
+    }
+
+    switch (_state) {
+        case State::CONNECTING:
+            if (now - _since >= kConnectTimeoutMs) onFailed(now);
+            break;
+        case State::BACKOFF:
+            if (now - _since >= _backoffMs) startAttempt(now);
+            break;
+        case State::CONNECTED:
+            if (_apActive && now - _since >= kApLingerMs && _driver.apStations() == 0) {
+                _driver.stopAp();
+                _apActive = false;
+                Serial.println("📶 AP abgeschaltet (STA verbunden)");
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void WifiManager::startAttempt(uint32_t now) {
+    _stats.attempts++;
+    _events.store(0);   // Disconnect-Meldungen des vorigen Versuchs verwerfen
+    Serial.printf("🔌 Verbinde zu %s (Versuch %u) ...\n", _ssid.c_str(), (unsigned)(_failures + 1));
+    _driver.connectSta(_ssid, _password);
+    _state = State::CONNECTING;
+    _since = now;
+}
+
+void WifiManager::onConnected(uint32_t now) {
+    _stats.connects++;
+    _stats.lastConnectMs = now - _since;
+    Serial.printf("📡 WLAN verbunden nach %u ms\n", (unsigned)_stats.lastConnectMs);
+    _failures = 0;
+    _backoffMs = 0;
+    _state = State::CONNECTED;
+    _since = now;
+}
+
+void WifiManager::onFailed(uint32_t now) {
+    _stats.failures++;
+    _driver.disconnectSta();
+    if (_failures < 31) _failures++;
+    if (!_apActive && _failures >= kApAfterFailures) {
+        Serial.println("⛔ Konnte nicht verbinden – AP zusätzlich aktiv, STA wird weiter versucht.");
+        enableAp();
+    }
+    uint32_t shift = _failures - 1 < 5 ? _failures - 1 : 5;
+    _backoffMs = kBackoffBaseMs << shift;
+    if (_backoffMs > kBackoffMaxMs) _backoffMs = kBackoffMaxMs;
+    _state = State::BACKOFF;
+    _since = now;
+}
+
+// Verbindung im Betrieb verloren: gleich neu versuchen, erst danach Backoff
+void WifiManager::onLost(uint32_t now) {
+    _stats.drops++;
+    Serial.println("⚠️  WLAN-Verbindung verloren");
+    _driver.disconnectSta();
+    _failures = 0;
+    _backoffMs = kRetryDelayMs;
+    _state = State::BACKOFF;
+    _since = now;
+}
+
+void WifiManager::enableAp() {
+    _driver.startAp();
+    _apActive = true;
+}
@@ -0,0 +1,91 @@
+#ifndef WIFIMANAGER_H
+#define WIFIMANAGER_H
+
+#include <Arduino.h>
+#include <atomic>
+
+//----------------------------------------------------------------------------
+// WifiDriver
+// Schnittstelle zur WLAN-Hardware. Auf dem ESP32 EspWifiDriver (WiFi.*),
+// im Host-Test ein simulierter Treiber. Alle Aufrufe kehren sofort zurück.
+//----------------------------------------------------------------------------
+class WifiDriver {
+public:
+    virtual ~WifiDriver() = default;
+
+    virtual void connectSta(const String &ssid, const String &password) = 0;
+    virtual void disconnectSta() = 0;
+    virtual bool staConnected() = 0;
+    virtual void startAp() = 0;         // AP zusätzlich zu STA (AP+STA)
+    virtual void stopAp() = 0;
+    virtual uint8_t apStations() = 0;   // am AP angemeldete Geräte
+};
+
+//----------------------------------------------------------------------------
+// WifiManager
+// Nicht blockierender Verbindungsaufbau als Zustandsautomat:
+//   CONNECTING -> CONNECTED            bei GOT_IP
+//   CONNECTING -> BACKOFF              bei Timeout / Disconnect
+//   BACKOFF    -> CONNECTING           nach Wartezeit (exponentiell, max. kBackoffMaxMs)
+//   CONNECTED  -> BACKOFF              bei Verbindungsverlust (Neuversuch nach kRetryDelayMs)
+// Nach kApAfterFailures Fehlversuchen läuft zusätzlich der AP, damit die
+// Oberfläche erreichbar bleibt; ist STA wieder da und kein Gerät mehr am AP,
+// wird er abgeschaltet. Ohne Zugangsdaten nur AP (AP_ONLY).
+//
+// Ereignisse kommen aus dem WiFi-Event-Task (notify), ausgewertet wird in loop().
+//----------------------------------------------------------------------------
+class WifiManager {
+public:
+    enum class State : uint8_t { IDLE, AP_ONLY, CONNECTING, CONNECTED, BACKOFF };
+    enum Event : uint8_t { EV_GOT_IP = 0x01, EV_DISCONNECTED = 0x02 };
+
+    static constexpr uint32_t kConnectTimeoutMs = 10000;
+    static constexpr uint32_t kRetryDelayMs     = 500;    // nach Verbindungsverlust
+    static constexpr uint32_t kBackoffBaseMs    = 2000;
+    static constexpr uint32_t kBackoffMaxMs     = 60000;
+    static constexpr uint8_t  kApAfterFailures  = 1;
+    static constexpr uint32_t kApLingerMs       = 30000;  // AP nach STA-Verbindung noch so lange halten
+
+    struct Stats {
+        uint32_t attempts = 0;
+        uint32_t connects = 0;
+        uint32_t failures = 0;     // Timeouts und abgebrochene Versuche
+        uint32_t drops = 0;        // Verbindungsverluste im Betrieb
+        uint32_t lastConnectMs = 0; // Dauer des letzten erfolgreichen Versuchs
+    };
+
+    explicit WifiManager(WifiDriver &driver) : _driver(driver) {}
+
+    void begin(const String &ssid, const String &password, uint32_t now);
+    void loop(uint32_t now);
+
+    // threadsicher, aus WiFi.onEvent
+    void notify(Event ev) { _events.fetch_or(ev); }
+
+    State state() const { return _state; }
+    const char* stateName() const;
+    bool apActive() const { return _apActive; }
+    uint32_t backoffMs() const { return _backoffMs; }
+    const Stats& stats() const { return _stats; }
+
+private:
+    void startAttempt(uint32_t now);
+    void onConnected(uint32_t now);
+    void onFailed(uint32_t now);
+    void onLost(uint32_t now);
+    void enableAp();
+
+    WifiDriver &_driver;
+    String _ssid;
+    String _password;
+
+    State _state = State::IDLE;
+    std::atomic<uint8_t> _events{0};
+    bool _apActive = false;
+    uint8_t _failures = 0;        // Fehlversuche seit der letzten Verbindung
+    uint32_t _since = 0;          // Beginn des aktuellen Zustands
+    uint32_t _backoffMs = 0;
+    Stats _stats;
+};
+
+#endif
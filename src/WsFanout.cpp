@@ -0,0 +1,154 @@
+#include "WsFanout.h"
+#include "WsProtocol.h"
+
+// _tempObject ist im AsyncWebSocketClient für eigene Daten vorgesehen
+void WsFanout::markBinary(AsyncWebSocketClient *client) {
+    client->_tempObject = (void*)WsProtocol::kSubprotocol;
+}
+
+bool WsFanout::isBinary(AsyncWebSocketClient *client) {
+    return client->_tempObject == (void*)WsProtocol::kSubprotocol;
+}
+
+WsFanout::~WsFanout() {
+    for (auto *buffer : _buffers) delete buffer;
+}
+
+AsyncWebSocketMessageBuffer* WsFanout::makeBuffer(size_t len) {
+    auto *buffer = new (std::nothrow) AsyncWebSocketMessageBuffer(len);
+    if (buffer && !buffer->get()) {
+        delete buffer;
+        return nullptr;
+    }
+    if (buffer) _buffers.push_back(buffer);
+    return buffer;
+}
+
+WsFanout::ClientState* WsFanout::state(uint32_t id, bool create) {
+    ClientState *freeSlot = nullptr;
+    for (auto &s : _clients) {
+        if (s.used && s.id == id) return &s;
+        if (!s.used && !freeSlot) freeSlot = &s;
+    }
+    if (!create || !freeSlot) return nullptr;
+    *freeSlot = ClientState();
+    freeSlot->id = id;
+    freeSlot->used = true;
+    freeSlot->needSnapshot = true;   // neuer Client: erst einmal alles
+    return freeSlot;
+}
+
+bool WsFanout::lagging(AsyncWebSocketClient *client) {
+    return client->queueIsFull() || client->queueLen() >= kMaxQueue;
+}
+
+void WsFanout::update() {
+    unsigned long now = millis();
+    for (auto &s : _clients) s.seen = false;
+
+    _stats.queued = 0;
+    for (const auto &client : _ws.getClients()) {
+        if (client->status() != WS_CONNECTED) continue;
+        ClientState *s = state(client->id(), true);
+        if (!s) continue;   // mehr Clients als kMaxClients: cleanupClients() räumt auf
+        s->seen = true;
+        s->binary = isBinary(client);
+
+        size_t queue = client->queueLen();
+        _stats.queued += queue;
+        if (queue > _stats.maxQueue) _stats.maxQueue = queue;
+
+        if (!lagging(client)) {
+            s->behindSince = 0;
+        } else if (s->behindSince == 0) {
+            s->behindSince = now ? now : 1;
+        } else if (now - s->behindSince > kEvictAfterMs) {
+            Serial.printf("⚠️  WebSocket-Client %u hängt – wird getrennt\n", (unsigned)client->id());
+            client->close();
+            s->used = false;
+            _stats.evictions++;
+        }
+    }
+    for (auto &s : _clients) {
+        if (s.used && !s.seen) s.used = false;
+    }
+
+    // nicht mehr referenzierte Frames freigeben
+    for (size_t i = 0; i < _buffers.size();) {
+        if (_buffers[i]->canDelete()) {
+            delete _buffers[i];
+            _buffers[i] = _buffers.back();
+            _buffers.pop_back();
+        } else {
+            i++;
+        }
+    }
+
+    if (now - _lastCleanup >= 1000) {
+        _ws.cleanupClients(kMaxClients);
+        _lastCleanup = now;
+    }
+}
+
+void WsFanout::send(AsyncWebSocketClient *client, const ClientState &s,
+                    AsyncWebSocketMessageBuffer *json, AsyncWebSocketMessageBuffer *binary) {
+    if (s.binary) client->binary(binary);
+    else          client->text(json);
+    _stats.sent++;
+}
+
+void WsFanout::sendDelta(AsyncWebSocketMessageBuffer *json, AsyncWebSocketMessageBuffer *binary) {
+    if (json) json->lock();
+    if (binary) binary->lock();
+    for (const auto &client : _ws.getClients()) {
+        if (client->status() != WS_CONNECTED) continue;
+        ClientState *s = state(client->id(), true);
+        if (!s || s->needSnapshot) continue;
+        if (lagging(client) || !(s->binary ? binary : json)) {
+            // Delta verwerfen, Client holt später den aktuellen Stand per Snapshot nach
+            s->needSnapshot = true;
+            _stats.dropped++;
+            continue;
+        }
+        send(client, *s, json, binary);
+    }
+    if (json) json->unlock();
+    if (binary) binary->unlock();
+}
+
+bool WsFanout::needsSnapshot() const {
+    for (const auto &s : _clients) {
+        if (s.used && s.needSnapshot && s.behindSince == 0) return true;
+    }
+    return false;
+}
+
+void WsFanout::sendSnapshot(AsyncWebSocketMessageBuffer *json, AsyncWebSocketMessageBuffer *binary) {
+    if (json) json->lock();
+    if (binary) binary->lock();
+    for (const auto &client : _ws.getClients()) {
+        if (client->status() != WS_CONNECTED) continue;
+        ClientState *s = state(client->id(), false);
+        if (!s || !s->needSnapshot || lagging(client) || !(s->binary ? binary : json)) continue;
+        send(client, *s, json, binary);
+        s->needSnapshot = false;
+    }
+    if (json) json->unlock();
+    if (binary) binary->unlock();
+}
+
+size_t WsFanout::clients() const {
+    size_t n = 0;
+    for (const auto &s : _clients) {
+        if (s.used) n++;
+    }
+    return n;
+}
+
+size_t WsFanout::clients(bool binary) const {
+    size_t n = 0;
+    for (const auto &s : _clients) {
+        if (s.used && s.binary == binary) n++;
+    }
+    return n;
+}
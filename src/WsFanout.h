@@ -0,0 +1,78 @@
+#ifndef WSFANOUT_H
+#define WSFANOUT_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <vector>
+
+//----------------------------------------------------------------------------
+// WsFanout
+// Verteilt Frames an die WebSocket-Clients und achtet auf deren Sendequeue.
+// Ein Client mit voller Queue bekommt keine weiteren Deltas, sondern wird für
+// einen Snapshot vorgemerkt – sobald er wieder aufnimmt, erhält er nur den
+// neuesten Zustand. Bleibt er länger als kEvictAfterMs hinterher, wird er
+// getrennt. Alle Frames sind gemeinsam genutzte Puffer (Referenzzähler).
+//
+// Nur aus loop() verwenden.
+//----------------------------------------------------------------------------
+class WsFanout {
+public:
+    static constexpr size_t kMaxClients = 8;
+    static constexpr size_t kMaxQueue = 4;              // ab so vielen Frames gilt ein Client als hinterher
+    static constexpr unsigned long kEvictAfterMs = 5000;
+
+    struct Stats {
+        uint32_t sent = 0;          // Frames an Clients übergeben
+        uint32_t dropped = 0;       // wegen voller Queue verworfen (durch Snapshot ersetzt)
+        uint32_t evictions = 0;     // getrennte Clients
+        uint32_t maxQueue = 0;      // größte beobachtete Queue-Länge
+        uint32_t queued = 0;        // Summe der Queue-Längen beim letzten update()
+    };
+
+    explicit WsFanout(AsyncWebSocket &ws) : _ws(ws) {}
+    ~WsFanout();
+
+    // Puffer für einen Frame, gehört dem Fanout (Freigabe in update())
+    AsyncWebSocketMessageBuffer* makeBuffer(size_t len);
+
+    // Client-Tabelle abgleichen, Queues prüfen, hängende Clients trennen
+    void update();
+
+    // Client hat beim Verbinden das Binär-Subprotocol gewählt (aus WS_EVT_CONNECT)
+    static void markBinary(AsyncWebSocketClient *client);
+    static bool isBinary(AsyncWebSocketClient *client);
+
+    // Delta an alle aufnahmefähigen Clients, je nach Protokoll json oder binary.
+    // Fehlt der passende Puffer (Speicher voll), wird der Client für einen Snapshot vorgemerkt.
+    void sendDelta(AsyncWebSocketMessageBuffer *json, AsyncWebSocketMessageBuffer *binary);
+    // Snapshot an alle vorgemerkten (neuen oder nachgezogenen) Clients
+    bool needsSnapshot() const;
+    void sendSnapshot(AsyncWebSocketMessageBuffer *json, AsyncWebSocketMessageBuffer *binary);
+
+    const Stats& stats() const { return _stats; }
+    size_t clients() const;
+    size_t clients(bool binary) const;
+
+private:
+    struct ClientState {
+        uint32_t id = 0;
+        bool     used = false;
+        bool     seen = false;
+        bool     needSnapshot = false;
+        bool     binary = false;
+        unsigned long behindSince = 0;  // 0 = Queue im Rahmen
+    };
+
+    ClientState* state(uint32_t id, bool create);
+    static bool lagging(AsyncWebSocketClient *client);
+    void send(AsyncWebSocketClient *client, const ClientState &s,
+              AsyncWebSocketMessageBuffer *json, AsyncWebSocketMessageBuffer *binary);
+
+    AsyncWebSocket &_ws;
+    ClientState _clients[kMaxClients];
+    std::vector<AsyncWebSocketMessageBuffer*> _buffers;
+    unsigned long _lastCleanup = 0;
+    Stats _stats;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef WSPROTOCOL_H
+#define WSPROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------
+// Binäres WebSocket-Protokoll (Subprotocol "esp.bin.v1"), Alternative zu JSON.
+// Alle Zahlen little endian. Ohne Subprotocol bleibt es bei JSON.
+//
+// Client -> Server
+//   SET    [0x01][flags]              flags: bit0 led gesetzt, bit1 led,
+//                                            bit2 blink gesetzt, bit3 blink
+// Server -> Client
+//   DELTA  [0x10][version u32][mask u8][Felder...]
+//   FULL   [0x11][version u32][mask u8][Felder...]
+//          Felder in StateChannel::Field-Reihenfolge, nur die in mask gesetzten:
+//          bool = u8, int = i32, text = u8 Länge + Bytes (max. 255)
+//   ACK    [0x12][seq u32]            SET ist angewendet (CommandQueue)
+//
+// Decoder arbeiten direkt auf den empfangenen Bytes, ohne Heap.
+//----------------------------------------------------------------------------
+namespace WsProtocol {
+
+constexpr char kSubprotocol[] = "esp.bin.v1";
+
+enum Opcode : uint8_t {
+    OP_SET         = 0x01,
+    OP_STATE_DELTA = 0x10,
+    OP_STATE_FULL  = 0x11,
+    OP_ACK         = 0x12,
+};
+
+enum SetFlags : uint8_t {
+    SET_HAS_LED   = 0x01,
+    SET_LED       = 0x02,
+    SET_HAS_BLINK = 0x04,
+    SET_BLINK     = 0x08,
+};
+
+struct Command {
+    bool hasLed = false;
+    bool led = false;
+    bool hasBlink = false;
+    bool blink = false;
+};
+
+inline bool decodeCommand(const uint8_t *data, size_t len, Command &cmd) {
+    if (len != 2 || data[0] != OP_SET) return false;
+    uint8_t flags = data[1];
+    cmd.hasLed   = flags & SET_HAS_LED;
+    cmd.led      = flags & SET_LED;
+    cmd.hasBlink = flags & SET_HAS_BLINK;
+    cmd.blink    = flags & SET_BLINK;
+    return true;
+}
+
+inline size_t encodeCommand(const Command &cmd, uint8_t *out, size_t cap) {
+    if (cap < 2) return 0;
+    out[0] = OP_SET;
+    out[1] = (cmd.hasLed ? SET_HAS_LED : 0) | (cmd.led ? SET_LED : 0)
+           | (cmd.hasBlink ? SET_HAS_BLINK : 0) | (cmd.blink ? SET_BLINK : 0);
+    return 2;
+}
+
+inline size_t encodeAck(uint32_t seq, uint8_t *out, size_t cap) {
+    if (cap < 5) return 0;
+    out[0] = OP_ACK;
+    for (int i = 0; i < 4; i++) out[1 + i] = (uint8_t)(seq >> (8 * i));
+    return 5;
+}
+
+// Schreibt in einen festen Puffer; out == nullptr zählt nur die Länge
+class Writer {
+public:
+    Writer(uint8_t *out = nullptr, size_t cap = 0) : _out(out), _cap(cap) {}
+
+    void u8(uint8_t v) { put(&v, 1); }
+    void u32(uint32_t v) {
+        uint8_t b[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+        put(b, 4);
+    }
+    void i32(int32_t v) { u32((uint32_t)v); }
+    void text(const char *s, size_t len) {
+        if (len > 255) len = 255;
+        u8((uint8_t)len);
+        put((const uint8_t*)s, len);
+    }
+
+    size_t size() const { return _pos; }
+    bool ok() const { return _out == nullptr || _pos <= _cap; }
+
+private:
+    void put(const uint8_t *p, size_t n) {
+        if (_out && _pos + n <= _cap) memcpy(_out + _pos, p, n);
+        _pos += n;
+    }
+
+    uint8_t *_out;
+    size_t _cap;
+    size_t _pos = 0;
+};
+
+} // namespace WsProtocol
+
+#endif
@@ -0,0 +1,95 @@
+#include "WsReassembler.h"
+
+WsReassembler::Slot* WsReassembler::slot(uint32_t clientId, bool create) {
+    Slot *freeSlot = nullptr;
+    for (auto &s : _slots) {
+        if (s.used && s.clientId == clientId) return &s;
+        if (!s.used && !freeSlot) freeSlot = &s;
+    }
+    if (!create || !freeSlot) return nullptr;
+    freeSlot->clientId = clientId;
+    freeSlot->used = true;
+    freeSlot->overflow = false;
+    freeSlot->frameStart = 0;
+    freeSlot->pos = 0;
+    return freeSlot;
+}
+
+void WsReassembler::release(uint32_t clientId) {
+    Slot *s = slot(clientId, false);
+    if (s) s->used = false;
+}
+
+// info.index = Offset von data im aktuellen Frame, info.len = Framelänge,
+// info.num = Framenummer innerhalb der Nachricht, info.final = letzter Frame.
+const uint8_t* WsReassembler::feed(uint32_t clientId, const AwsFrameInfo &info,
+                                   const uint8_t *data, size_t len,
+                                   size_t &msgLen, uint8_t &opcode) {
+    bool frameEnd = info.index + len == info.len;
+    bool messageStart = info.num == 0 && info.index == 0;
+
+    // Häufigster Fall: ganze Nachricht in einem Event -> ohne Kopie weiterreichen
+    if (messageStart && info.final && frameEnd) {
+        release(clientId);
+        if (len > kMaxMessage) {
+            _oversized.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        msgLen = len;
+        opcode = info.opcode;
+        _messages.fetch_add(1, std::memory_order_relaxed);
+        return data;
+    }
+
+    Slot *s = slot(clientId, messageStart);
+    if (!s) {
+        if (messageStart) _noSlot.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;   // Rest einer verworfenen Nachricht
+    }
+    if (messageStart) {
+        s->overflow = info.len > kMaxMessage;   // schon am Header erkennbar
+        s->opcode = info.message_opcode;
+        s->frameStart = 0;
+        s->pos = 0;
+    } else if (info.index == 0) {
+        s->frameStart = s->pos;                 // neuer Fortsetzungsframe
+    }
+
+    if (!s->overflow) {
+        if (s->frameStart + info.index != s->pos) {
+            // Lücke oder Wiederholung – Nachricht ist nicht mehr rekonstruierbar
+            _protocol.fetch_add(1, std::memory_order_relaxed);
+            s->used = false;
+            return nullptr;
+        }
+        if (s->pos + len > kMaxMessage) {
+            s->overflow = true;
+        } else {
+            memcpy(s->data + s->pos, data, len);
+            s->pos += len;
+        }
+    }
+
+    if (!(info.final && frameEnd)) return nullptr;
+
+    s->used = false;
+    if (s->overflow) {
+        _oversized.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    msgLen = s->pos;
+    opcode = s->opcode;
+    _messages.fetch_add(1, std::memory_order_relaxed);
+    _reassembled.fetch_add(1, std::memory_order_relaxed);
+    return s->data;
+}
+
+WsReassembler::Stats WsReassembler::stats() const {
+    Stats s;
+    s.messages = _messages.load(std::memory_order_relaxed);
+    s.reassembled = _reassembled.load(std::memory_order_relaxed);
+    s.oversized = _oversized.load(std::memory_order_relaxed);
+    s.noSlot = _noSlot.load(std::memory_order_relaxed);
+    s.protocol = _protocol.load(std::memory_order_relaxed);
+    return s;
+}
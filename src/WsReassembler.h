@@ -0,0 +1,64 @@
+#ifndef WSREASSEMBLER_H
+#define WSREASSEMBLER_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <atomic>
+
+//----------------------------------------------------------------------------
+// WsReassembler
+// Setzt fragmentierte bzw. über mehrere TCP-Pakete verteilte WebSocket-
+// Nachrichten pro Client in einem vorab reservierten Puffer zusammen und gibt
+// nur vollständige Nachrichten heraus. Nachrichten in einem einzigen Event
+// werden ohne Kopie direkt aus den Eventdaten geliefert. Zu große Nachrichten
+// werden verworfen, ohne Speicher anzufordern.
+//
+// Nur aus dem WebSocket-Eventhandler (AsyncTCP-Task) verwenden, stats()
+// auch aus loop().
+//----------------------------------------------------------------------------
+class WsReassembler {
+public:
+    static constexpr size_t kMaxMessage = 256;  // Befehle sind wenige Bytes groß
+    static constexpr size_t kSlots = 8;         // gleichzeitig fragmentierende Clients
+
+    struct Stats {
+        uint32_t messages = 0;      // vollständig ausgelieferte Nachrichten
+        uint32_t reassembled = 0;   // davon aus mehreren Teilen zusammengesetzt
+        uint32_t oversized = 0;     // wegen kMaxMessage verworfen
+        uint32_t noSlot = 0;        // kein freier Puffer
+        uint32_t protocol = 0;      // Teile passten nicht zusammen (Offset/Reihenfolge)
+    };
+
+    // Liefert die vollständige Nachricht (in data oder im Slot-Puffer, gültig bis zum
+    // nächsten feed() dieses Clients) oder nullptr, solange sie noch nicht komplett ist.
+    const uint8_t* feed(uint32_t clientId, const AwsFrameInfo &info,
+                        const uint8_t *data, size_t len,
+                        size_t &msgLen, uint8_t &opcode);
+
+    // Client getrennt: angefangene Nachricht verwerfen
+    void release(uint32_t clientId);
+
+    Stats stats() const;
+
+private:
+    struct Slot {
+        uint32_t clientId = 0;
+        bool     used = false;
+        bool     overflow = false;   // Rest der Nachricht ignorieren
+        uint8_t  opcode = 0;
+        size_t   frameStart = 0;     // Position des aktuellen Frames im Puffer
+        size_t   pos = 0;
+        uint8_t  data[kMaxMessage];
+    };
+
+    Slot* slot(uint32_t clientId, bool create);
+
+    Slot  _slots[kSlots];
+    std::atomic<uint32_t> _messages{0};
+    std::atomic<uint32_t> _reassembled{0};
+    std::atomic<uint32_t> _oversized{0};
+    std::atomic<uint32_t> _noSlot{0};
+    std::atomic<uint32_t> _protocol{0};
+};
+
+#endif
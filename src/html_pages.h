@@ -1,12 +1,14 @@
+#ifndef HTML_PAGES_H
+#define HTML_PAGES_H
 
-const char root_content[] PROGMEM = R"rawliteral(
+constexpr char root_content[] PROGMEM = R"rawliteral(
     <div class="content">
         <h1>Willkommen auf meiner Hauptseite!</h1>
         <p>Dies ist die Startseite. Benutze das Menü oben, um zu den anderen Seiten zu navigieren.</p>
     </div>
 )rawliteral";
 
-const char submenu01_content[] PROGMEM = R"rawliteral(
+constexpr char submenu01_content[] PROGMEM = R"rawliteral(
     <div class="content">
         <h2>Dieser Block ist der Inhalt</h2>
         <p>Zählerstand: <span id="counterValue">%COUNTER_VALUE%</span></p>
@@ -18,16 +20,12 @@ const char submenu01_content[] PROGMEM = R"rawliteral(
         <button onclick="window.history.back()">Zurück</button>
     </div>
     <script>
-        function updateCounter() {
-            var xhr = new XMLHttpRequest();
-            xhr.onreadystatechange = function() {
-                if (this.readyState == 4 && this.status == 200) {
-                    document.getElementById("counterValue").innerHTML = this.responseText;
-                }
-            };
-            xhr.open("GET", "/counter", true);
-            xhr.send();
-        }
+        // Zähler live über Server-Sent Events (/events) statt Polling
+        var events = new EventSource("/events");
+        events.addEventListener("state", function(e) {
+            var d = JSON.parse(e.data);
+            if (d.counter !== undefined) document.getElementById("counterValue").innerHTML = d.counter;
+        });
         function counterReset() {
             var xhr = new XMLHttpRequest();
             xhr.open("GET", "/counterReset", true);
@@ -45,11 +43,10 @@ const char submenu01_content[] PROGMEM = R"rawliteral(
             };
             xhr.send("data=" + text);
         }
-        setInterval(updateCounter, 1000);
     </script>
 )rawliteral";
 
-const char status_content[] PROGMEM = R"rawliteral(
+constexpr char status_content[] PROGMEM = R"rawliteral(
 <div class="form-container">
   <h2>Status</h2>
 
@@ -86,17 +83,25 @@ const char status_content[] PROGMEM = R"rawliteral(
 </div>
 
 <script>
-function updateCounter() {
-    var xhr = new XMLHttpRequest();
-    xhr.onreadystatechange = function() {
-        if (this.readyState == 4 && this.status == 200) {
-            document.getElementById("counterValue").innerHTML = this.responseText;
-            document.getElementById("cur_counter").value = this.responseText;
-        }
-    };
-    xhr.open("GET", "/counter", true);
-    xhr.send();
-}
+// Live-Daten über Server-Sent Events (/events) statt Polling; der Browser
+// verbindet selbst neu und holt Verpasstes über Last-Event-ID nach
+let showJson = false;
+const events = new EventSource('/events');
+events.addEventListener('state', e => {
+  const d = JSON.parse(e.data);
+  if (d.counter !== undefined) {
+    document.getElementById("counterValue").innerHTML = d.counter;
+    document.getElementById("cur_counter").value = d.counter;
+  }
+  if (!showJson) return;
+  if (d.uptime !== undefined) uptime.value = d.uptime;
+  if (d.counter !== undefined) counter.value = d.counter;
+  if (d.free_heap !== undefined) heap.value = d.free_heap;
+});
+// vollständiger Status (/status.json) als Stream, nur bei offener Anzeige nötig
+events.addEventListener('status', e => {
+  if (showJson) showStatus(JSON.parse(e.data));
+});
 function counterReset() {
     var xhr = new XMLHttpRequest();
     xhr.open("GET", "/counter_reset", true);
@@ -126,29 +131,31 @@ function setCounter() {
     xhr.send("data=" + value);
 }
 
-setInterval(updateCounter, 1000);
-
-let intervalId = null;
+function showStatus(d) {
+  uptime.value = d.uptime_sec;
+  counter.value = d.counter;
+  mode.value = d.wifi_mode;
+  ssid.value = d.wifi_ssid;
+  ip.value = d.ip;
+  subnet.value = d.subnet;
+  heap.value = d.free_heap;
+}
+// beim Einblenden sofort, danach über das Event "status"
 function fetchStatus() {
   fetch('/status.json')
     .then(r => r.json())
-    .then(d => {
-      uptime.value = d.uptime_sec;
-      counter.value = d.counter;
-      mode.value = d.wifi_mode;
-      ssid.value = d.wifi_ssid;
-      ip.value = d.ip;
-      subnet.value = d.subnet;
-      heap.value = d.free_heap;
-    });
+    .then(showStatus);
 }
 function toggleJson() {
   const btn = document.getElementById('toggleBtn');
-  if (intervalId) {
-    clearInterval(intervalId); intervalId = null; btn.textContent = 'JSON anzeigen';
+  showJson = !showJson;
+  if (showJson) {
+    fetchStatus(); btn.textContent = 'Stop';
   } else {
-    fetchStatus(); intervalId = setInterval(fetchStatus, 1000); btn.textContent = 'Stop';
+    btn.textContent = 'JSON anzeigen';
   }
 }
 </script>
 )rawliteral";
+
+#endif
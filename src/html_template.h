@@ -1,11 +1,18 @@
-const char html_template[] PROGMEM = R"rawliteral(
+#ifndef HTML_TEMPLATE_H
+#define HTML_TEMPLATE_H
+
+#include "AssetManifest.h"
+
+// constexpr, damit StaticTemplate die Seite zur Compile-Zeit zerlegen kann.
+// ?v=ASSET_VERSION: Assets dürfen im Browser lange gecacht werden (StaticAssetHandler)
+constexpr char html_template[] PROGMEM = R"rawliteral(
 <!DOCTYPE html>
 <html lang="de">
 <head>
     <meta charset="UTF-8">
     <meta name="viewport" content="width=device-width, initial-scale=1.0">
     <title>ESP32 UI</title>
-    <link rel="stylesheet" href="/style.css">
+    <link rel="stylesheet" href="/style.css?v=)rawliteral" ASSET_VERSION R"rawliteral(">
 </head>
 <body>
   <nav>
@@ -25,7 +32,9 @@ const char html_template[] PROGMEM = R"rawliteral(
   <h2 class="h_color">Template mit dynamischen Inhalten</h2>
   <p>Diese Seite nutzt ein Template, in das der Seiteninhalt eingefügt wird.</p>
     _BODY_CONTENT_
-  <script src="/script.js"></script>
+  <script src="/script.js?v=)rawliteral" ASSET_VERSION R"rawliteral("></script>
 </body>
 </html>
 )rawliteral";
+
+#endif
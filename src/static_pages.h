@@ -0,0 +1,24 @@
+#ifndef STATIC_PAGES_H
+#define STATIC_PAGES_H
+
+#include "StaticTemplate.h"
+#include "html_template.h"
+#include "html_pages.h"
+
+//----------------------------------------------------------------------------
+// Slots der PROGMEM-Seiten aus html_pages.h. Fehlt ein Platzhalter im Enum
+// (oder steht ein Name im Enum, der auf der Seite fehlt), bricht der Build ab.
+//----------------------------------------------------------------------------
+#define ROOT_SLOTS(X)
+DECLARE_TEMPLATE_SLOTS(RootSlot, ROOT_SLOTS)
+using RootPage = StaticPage<html_template, root_content, RootSlot, RootSlotNames>;
+
+#define SUBMENU01_SLOTS(X) X(COUNTER_VALUE) X(EEPROM_TEXT)
+DECLARE_TEMPLATE_SLOTS(Submenu01Slot, SUBMENU01_SLOTS)
+using Submenu01Page = StaticPage<html_template, submenu01_content, Submenu01Slot, Submenu01SlotNames>;
+
+#define STATUS_SLOTS(X) X(EEPROM_TEXT) X(COUNTER_VALUE) X(SET_COUNTER) X(CUR_COUNTER)
+DECLARE_TEMPLATE_SLOTS(StatusSlot, STATUS_SLOTS)
+using StatusPage = StaticPage<html_template, status_content, StatusSlot, StatusSlotNames>;
+
+#endif
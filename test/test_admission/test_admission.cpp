@@ -0,0 +1,106 @@
+// Unity-Tests für AdmissionControl (pio test -e native)
+// Routen über server.on() mit RouteMetrics::wrap() außen, teure Routen
+// zusätzlich durch admit() (wie RouteTable::Dispatcher). Offene Requests bleiben im Scope, bis
+// ihr Destruktor onDisconnect auslöst; der freie Heap kommt aus
+// NativeHost::heapUsed.
+#include <unity.h>
+#include <memory>
+#include <vector>
+#include "AdmissionControl.h"
+#include "RouteMetrics.h"
+
+static AsyncWebServer server(8083);
+static RouteMetrics *metrics;
+static AdmissionControl admission;
+
+typedef std::unique_ptr<AsyncWebServerRequest> RequestPtr;
+
+static RequestPtr get(const char *url) {
+  RequestPtr request(new AsyncWebServerRequest(HTTP_GET, url));
+  server.hostHandle(*request);
+  return request;
+}
+
+static int status(const char *url) {
+  return get(url)->hostResponse()->code();
+}
+
+void setUp() {
+  admission.setLimits(AdmissionControl::Limits());
+  NativeHost::heapUsed = 0;
+}
+void tearDown() { NativeHost::heapUsed = 0; }
+
+void test_expensive_rejected_when_busy() {
+  AdmissionControl::Limits limits;
+  limits.maxInFlight = 2;
+  limits.retryAfterSec = 5;
+  admission.setLimits(limits);
+
+  std::vector<RequestPtr> open;
+  open.push_back(get("/page"));
+  open.push_back(get("/page"));
+  TEST_ASSERT_EQUAL(200, open[0]->hostResponse()->code());
+  TEST_ASSERT_EQUAL(200, open[1]->hostResponse()->code());
+  TEST_ASSERT_EQUAL_UINT32(2, RouteMetrics::inFlight());
+
+  RequestPtr third = get("/page");
+  TEST_ASSERT_EQUAL(503, third->hostResponse()->code());
+  const String *retry = third->hostResponse()->header("Retry-After");
+  TEST_ASSERT_NOT_NULL(retry);
+  TEST_ASSERT_EQUAL_STRING("5", retry->c_str());
+  TEST_ASSERT_EQUAL_UINT32(1, admission.stats().rejectedBusy);
+
+  // billige Route läuft weiter
+  TEST_ASSERT_EQUAL(200, status("/counter"));
+
+  // sobald eine Verbindung zu ist, wieder frei
+  third.reset();
+  open.pop_back();
+  TEST_ASSERT_EQUAL(200, status("/page"));
+}
+
+void test_low_heap_rejects_only_expensive_routes() {
+  NativeHost::heapUsed = NativeHost::kHeapSize - 16 * 1024;
+  uint32_t before = admission.stats().rejectedHeap;
+  TEST_ASSERT_EQUAL(503, status("/page"));
+  TEST_ASSERT_EQUAL(200, status("/counter"));
+  TEST_ASSERT_EQUAL_UINT32(before + 1, admission.stats().rejectedHeap);
+}
+
+void test_limits_change_at_runtime() {
+  NativeHost::heapUsed = NativeHost::kHeapSize - 16 * 1024;
+  TEST_ASSERT_EQUAL(503, status("/page"));
+  AdmissionControl::Limits limits = admission.limits();
+  limits.minFreeHeap = 8 * 1024;
+  admission.setLimits(limits);
+  TEST_ASSERT_EQUAL(200, status("/page"));
+}
+
+void test_rejections_count_as_route_errors() {
+  NativeHost::heapUsed = NativeHost::kHeapSize;
+  status("/page");
+  AsyncWebServerRequest request(HTTP_GET, "/metrics");
+  request.send(metrics->beginResponse(&request));
+  String text = request.hostBody();
+  TEST_ASSERT_TRUE(text.indexOf("http_request_errors_total{route=\"/page\",method=\"GET\"} ") >= 0);
+  TEST_ASSERT_TRUE(text.indexOf("http_request_errors_total{route=\"/page\",method=\"GET\"} 0\n") < 0);
+  TEST_ASSERT_TRUE(text.indexOf("\nhttp_requests_in_flight 0\n") >= 0);
+}
+
+int main() {
+  metrics = new RouteMetrics();
+  server.on("/page", HTTP_GET, metrics->wrap("/page", HTTP_GET, [](AsyncWebServerRequest *request) {
+    if (!admission.admit(request)) return;
+    request->send(200, "text/html", "<p>Seite</p>");
+  }));
+  server.on("/counter", HTTP_GET, metrics->wrap("/counter", HTTP_GET, [](AsyncWebServerRequest *request) {
+    request->send(200, "text/plain", "42");
+  }));
+  UNITY_BEGIN();
+  RUN_TEST(test_expensive_rejected_when_busy);
+  RUN_TEST(test_low_heap_rejects_only_expensive_routes);
+  RUN_TEST(test_limits_change_at_runtime);
+  RUN_TEST(test_rejections_count_as_route_errors);
+  return UNITY_END();
+}
@@ -0,0 +1,158 @@
+// Unity-Tests für AssetBundle (pio test -e native)
+// Blendet das von tools/build_assets.py gepackte .pio/assets.bin als
+// Partition "assets" ein und vergleicht es mit Manifest und .pio/data.
+#include <unity.h>
+#include <SPIFFS.h>
+#include <vector>
+#include "AssetBundle.h"
+#include "StaticAssetHandler.h"
+#include "TemplateEngine.h"
+
+static const AssetInfo kManifest[] = { ASSET_TABLE_ENTRIES { nullptr, nullptr, nullptr, 0, 0 } };
+static const size_t kManifestCount = sizeof(kManifest) / sizeof(kManifest[0]) - 1;
+
+static AssetBundle bundle;
+static StaticAssetHandler assets(SPIFFS);
+
+// Kopie des Bundles zum Beschädigen, 4-Byte-ausgerichtet
+static std::vector<uint32_t> copy() {
+  std::vector<uint32_t> words((bundle.size() + 3) / 4);
+  esp_partition_read(esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "assets"),
+                     0, words.data(), bundle.size());
+  return words;
+}
+
+static AssetBundle::Entry* entries(std::vector<uint32_t> &words) {
+  return (AssetBundle::Entry*)((uint8_t*)words.data() + sizeof(AssetBundle::Header));
+}
+
+void setUp() {
+  if (kManifestCount == 0) {
+    TEST_IGNORE_MESSAGE("kein Asset-Manifest (src/assets_generated.h), erst tools/build_assets.py laufen lassen");
+  }
+  if (!bundle.valid()) {
+    TEST_IGNORE_MESSAGE(".pio/assets.bin fehlt, Test aus dem Projektverzeichnis starten");
+  }
+}
+
+void tearDown() {}
+
+void test_bundle_matches_manifest() {
+  TEST_ASSERT_TRUE(bundle.matches(ASSET_VERSION));
+  TEST_ASSERT_FALSE(bundle.matches("0"));
+  TEST_ASSERT_EQUAL_UINT32(kManifestCount, bundle.count());
+  for (size_t i = 0; i < kManifestCount; i++) {
+    const AssetInfo &info = kManifest[i];
+    AssetBundle::Asset asset = bundle.find(info.path);
+    TEST_ASSERT_TRUE_MESSAGE((bool)asset, info.path);
+    TEST_ASSERT_EQUAL_STRING(info.path, asset.path);
+    TEST_ASSERT_EQUAL_STRING(info.contentType, asset.contentType);
+    TEST_ASSERT_EQUAL_STRING(info.etag, asset.etag);
+    TEST_ASSERT_EQUAL_UINT32(info.size, asset.size);
+    TEST_ASSERT_EQUAL_UINT32(info.gzSize, asset.gzSize);
+    TEST_ASSERT_EQUAL_UINT8(0, asset.data[asset.size]);   // als C-String lesbar
+    TEST_ASSERT_EQUAL_UINT32(0, (uintptr_t)asset.data % 4);
+
+    File file = SPIFFS.open(info.path);
+    TEST_ASSERT_TRUE(file);
+    String content = file.readString();
+    TEST_ASSERT_EQUAL_MEMORY(content.c_str(), asset.data, asset.size);
+  }
+}
+
+void test_unknown_paths_miss() {
+  TEST_ASSERT_FALSE(bundle.find("/style"));
+  TEST_ASSERT_FALSE(bundle.find("/style.cssx"));
+  TEST_ASSERT_FALSE(bundle.find("style.css"));
+  TEST_ASSERT_FALSE(bundle.find(""));
+  TEST_ASSERT_FALSE(bundle.find("/zzz"));
+  TEST_ASSERT_FALSE(bundle.find("/images/"));
+  // Länge zählt, nicht das '\0'
+  TEST_ASSERT_TRUE(bundle.find("/style.css.gz", 10));
+}
+
+void test_rejects_damaged_bundle() {
+  AssetBundle other;
+  std::vector<uint32_t> words = copy();
+  TEST_ASSERT_TRUE(other.begin((const uint8_t*)words.data(), bundle.size()));
+  TEST_ASSERT_FALSE(other.begin((const uint8_t*)words.data(), bundle.size() - 4));
+
+  words[0] = 0xFFFFFFFF;            // gelöschte Partition
+  TEST_ASSERT_FALSE(other.begin((const uint8_t*)words.data(), bundle.size()));
+  TEST_ASSERT_FALSE(other.valid());
+  TEST_ASSERT_FALSE(other.find("/style.css"));
+
+  words = copy();
+  std::swap(entries(words)[0], entries(words)[1]);
+  TEST_ASSERT_FALSE(other.begin((const uint8_t*)words.data(), bundle.size()));
+
+  words = copy();
+  entries(words)[0].size = (uint32_t)bundle.size();
+  TEST_ASSERT_FALSE(other.begin((const uint8_t*)words.data(), bundle.size()));
+
+  words = copy();
+  entries(words)[0].pathLen++;      // Pfad nicht mehr mit '\0' abgeschlossen
+  TEST_ASSERT_FALSE(other.begin((const uint8_t*)words.data(), bundle.size()));
+}
+
+void test_handler_serves_without_filesystem() {
+  const AssetInfo *css = StaticAssetHandler::find("/style.css");
+  SPIFFS.hostClear();
+  uint32_t opens = SPIFFS.hostStats().opens;
+
+  AsyncWebServerRequest request(HTTP_GET, "/style.css");
+  request.hostHeader("Accept-Encoding", "gzip");
+  TEST_ASSERT_TRUE(assets.canHandle(&request));
+  assets.handleRequest(&request);
+  AsyncWebServerResponse *response = request.hostResponse();
+  TEST_ASSERT_EQUAL_INT(200, response->code());
+  const String *etag = response->header("ETag");
+  TEST_ASSERT_NOT_NULL(etag);
+  TEST_ASSERT_TRUE(etag->indexOf(css->etag) >= 0);
+  if (css->gzSize) {
+    TEST_ASSERT_NOT_NULL(response->header("Content-Encoding"));
+    TEST_ASSERT_EQUAL_UINT32(css->gzSize, request.hostDrain());
+  } else {
+    TEST_ASSERT_EQUAL_UINT32(css->size, request.hostDrain());
+  }
+
+  AsyncWebServerRequest revalidate(HTTP_GET, "/style.css");
+  revalidate.hostHeader("Accept-Encoding", "gzip");
+  revalidate.hostHeader("If-None-Match", *etag);
+  assets.handleRequest(&revalidate);
+  TEST_ASSERT_EQUAL_INT(304, revalidate.hostResponse()->code());
+
+  TEST_ASSERT_EQUAL_UINT32(opens, SPIFFS.hostStats().opens);
+  SPIFFS.hostLoadDir(".pio/data");
+}
+
+void test_template_page_points_into_bundle() {
+  TemplateEngine engine;
+  engine.begin("<main>_BODY_CONTENT_</main>");
+  TemplateEngine::PagePtr page = engine.file(bundle, "/config.html");
+  TEST_ASSERT_NOT_NULL(page.get());
+  TEST_ASSERT_TRUE(page == engine.file(bundle, "/config.html"));
+  TEST_ASSERT_NULL(engine.file(bundle, "/missing.html").get());
+
+  AssetBundle::Asset asset = bundle.find("/config.html");
+  const char *begin = (const char*)asset.data;
+  size_t inside = 0;
+  for (const auto &segment : page->segments()) {
+    if (segment.data >= begin && segment.data + segment.len <= begin + asset.size) inside += segment.len;
+  }
+  // alles außer html_template liegt im Bundle, nichts davon wurde kopiert
+  TEST_ASSERT_EQUAL_UINT32(asset.size, inside);
+}
+
+int main() {
+  SPIFFS.hostLoadDir(".pio/data");
+  if (NativeHost::loadPartitionFile("assets", ".pio/assets.bin")) bundle.map();
+  assets.serve("/style.css").serve("/script.js").bundle(&bundle);
+  UNITY_BEGIN();
+  RUN_TEST(test_bundle_matches_manifest);
+  RUN_TEST(test_unknown_paths_miss);
+  RUN_TEST(test_rejects_damaged_bundle);
+  RUN_TEST(test_handler_serves_without_filesystem);
+  RUN_TEST(test_template_page_points_into_bundle);
+  return UNITY_END();
+}
@@ -0,0 +1,102 @@
+// Unity-Tests für StaticAssetHandler (pio test -e native)
+// Liest das von tools/build_assets.py vorbereitete Verzeichnis .pio/data und
+// misst die Bytes auf der Leitung beim ersten (kalt) und wiederholten (warm) Laden.
+#include <unity.h>
+#include <SPIFFS.h>
+#include "StaticAssetHandler.h"
+
+static StaticAssetHandler assets(SPIFFS);
+
+struct Wire {
+  int code;
+  size_t header;
+  size_t body;
+  String etag;
+};
+
+static Wire get(const char *url, const char *ifNoneMatch = nullptr, bool gzip = true) {
+  AsyncWebServerRequest request(HTTP_GET, url);
+  if (gzip) request.hostHeader("Accept-Encoding", "gzip, deflate");
+  if (ifNoneMatch) request.hostHeader("If-None-Match", ifNoneMatch);
+  TEST_ASSERT_TRUE(assets.canHandle(&request));
+  assets.handleRequest(&request);
+  AsyncWebServerResponse *response = request.hostResponse();
+  TEST_ASSERT_NOT_NULL(response);
+  const String *etag = response->header("ETag");
+  return { response->code(), response->headerBytes(), request.hostDrain(), etag ? *etag : String() };
+}
+
+void setUp() {
+  if (StaticAssetHandler::find("/style.css") == nullptr) {
+    TEST_IGNORE_MESSAGE("kein Asset-Manifest (src/assets_generated.h), erst tools/build_assets.py laufen lassen");
+  }
+  if (!SPIFFS.exists("/style.css")) {
+    TEST_IGNORE_MESSAGE(".pio/data fehlt, Test aus dem Projektverzeichnis starten");
+  }
+}
+
+void tearDown() {}
+
+void test_cold_load_prefers_gzip() {
+  const AssetInfo *css = StaticAssetHandler::find("/style.css");
+  Wire plain = get("/style.css", nullptr, false);
+  TEST_ASSERT_EQUAL_INT(200, plain.code);
+  TEST_ASSERT_EQUAL_UINT32(css->size, plain.body);
+  if (css->gzSize) {
+    Wire packed = get("/style.css");
+    TEST_ASSERT_EQUAL_UINT32(css->gzSize, packed.body);
+    TEST_ASSERT_LESS_THAN_UINT32(plain.body, packed.body);
+  }
+}
+
+void test_warm_load_is_not_modified() {
+  Wire cold = get("/style.css");
+  TEST_ASSERT_TRUE(cold.etag.length() > 2);
+  Wire warm = get("/style.css", cold.etag.c_str());
+  TEST_ASSERT_EQUAL_INT(304, warm.code);
+  TEST_ASSERT_EQUAL_UINT32(0, warm.body);
+  TEST_ASSERT_LESS_THAN_UINT32(cold.header + cold.body, warm.header);
+}
+
+// gzip und unkomprimiert haben verschiedene ETags; If-None-Match gilt nur für
+// die Variante, die gesendet würde
+void test_etag_differs_per_content_coding() {
+  const AssetInfo *css = StaticAssetHandler::find("/style.css");
+  if (!css->gzSize) TEST_IGNORE_MESSAGE("style.css ohne gzip-Variante");
+  Wire packed = get("/style.css");
+  Wire plain = get("/style.css", nullptr, false);
+  TEST_ASSERT_TRUE(packed.etag != plain.etag);
+  TEST_ASSERT_EQUAL_INT(200, get("/style.css", packed.etag.c_str(), false).code);
+  TEST_ASSERT_EQUAL_INT(200, get("/style.css", plain.etag.c_str()).code);
+  TEST_ASSERT_EQUAL_INT(304, get("/style.css", plain.etag.c_str(), false).code);
+}
+
+// Manifest kennt die Datei, das SPIFFS-Image ist aber veraltet
+void test_missing_file_is_404() {
+  SPIFFS.hostClear();
+  AsyncWebServerRequest request(HTTP_GET, "/script.js");
+  assets.handleRequest(&request);
+  TEST_ASSERT_EQUAL_INT(404, request.hostResponse()->code());
+  SPIFFS.hostLoadDir(".pio/data");
+}
+
+void test_versioned_url_is_immutable() {
+  AsyncWebServerRequest request(HTTP_GET, "/script.js");
+  request.hostParam("v", ASSET_VERSION);
+  assets.handleRequest(&request);
+  const String *cache = request.hostResponse()->header("Cache-Control");
+  TEST_ASSERT_NOT_NULL(cache);
+  TEST_ASSERT_TRUE(cache->indexOf("immutable") >= 0);
+}
+
+int main() {
+  SPIFFS.hostLoadDir(".pio/data");
+  assets.serve("/style.css").serve("/script.js").serve("/images/");
+  UNITY_BEGIN();
+  RUN_TEST(test_cold_load_prefers_gzip);
+  RUN_TEST(test_warm_load_is_not_modified);
+  RUN_TEST(test_etag_differs_per_content_coding);
+  RUN_TEST(test_missing_file_is_404);
+  RUN_TEST(test_versioned_url_is_immutable);
+  return UNITY_END();
+}
@@ -0,0 +1,153 @@
+// Unity-Tests für SpscRing und CommandQueue (pio test -e native, der
+// nebenläufige Fall auch unter ThreadSanitizer: pio test -e native_tsan)
+// Erzeuger wie die Handler im AsyncTCP-Task, Verbraucher wie loop().
+#include <unity.h>
+#include <thread>
+#include "CommandQueue.h"
+
+static CommandQueue::Command led(bool on, uint32_t clientId = 0) {
+  CommandQueue::Command cmd;
+  cmd.kind = CommandQueue::WS_SET;
+  cmd.clientId = clientId;
+  cmd.set.hasLed = true;
+  cmd.set.led = on;
+  return cmd;
+}
+
+static CommandQueue::Command text(const char *value) {
+  CommandQueue::Command cmd;
+  cmd.kind = CommandQueue::SAVE_TEXT;
+  strncpy(cmd.text, value, sizeof(cmd.text) - 1);
+  return cmd;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_take_applies_and_completes() {
+  CommandQueue queue;
+  CommandQueue::Batch batch;
+  TEST_ASSERT_FALSE(queue.take(batch));
+
+  CommandQueue::Command cmd = text("Hallo");
+  uint32_t seq = queue.push(cmd);
+  TEST_ASSERT_NOT_EQUAL(0, seq);
+  TEST_ASSERT_EQUAL(1, queue.pending());
+  TEST_ASSERT_FALSE(queue.completed(seq));
+
+  TEST_ASSERT_TRUE(queue.take(batch));
+  TEST_ASSERT_TRUE(batch.hasText);
+  TEST_ASSERT_EQUAL_STRING("Hallo", batch.text);
+  TEST_ASSERT_FALSE(batch.hasSet);
+  TEST_ASSERT_EQUAL_UINT32(seq, batch.lastSeq);
+  TEST_ASSERT_FALSE(queue.completed(seq));
+  queue.done(batch.lastSeq);
+  TEST_ASSERT_TRUE(queue.completed(seq));
+  TEST_ASSERT_EQUAL(0, queue.pending());
+}
+
+void test_repeated_commands_merge() {
+  CommandQueue queue;
+  CommandQueue::Command cmd = led(true, 7);
+  uint32_t first = queue.push(cmd);
+  cmd = led(false, 7);
+  queue.push(cmd);
+  cmd = led(true, 9);
+  queue.push(cmd);
+  CommandQueue::Command blink;
+  blink.kind = CommandQueue::WS_SET;
+  blink.clientId = 7;
+  blink.set.hasBlink = blink.set.blink = true;
+  uint32_t last = queue.push(blink);
+
+  CommandQueue::Batch batch;
+  TEST_ASSERT_TRUE(queue.take(batch));
+  // ein Endzustand statt vier Befehlen
+  TEST_ASSERT_TRUE(batch.hasSet);
+  TEST_ASSERT_TRUE(batch.set.hasLed);
+  TEST_ASSERT_TRUE(batch.set.led);
+  TEST_ASSERT_TRUE(batch.set.hasBlink);
+  TEST_ASSERT_TRUE(batch.set.blink);
+  TEST_ASSERT_EQUAL_UINT32(3, queue.stats().merged);
+
+  // eine Quittung je Client, mit seiner letzten Nummer
+  TEST_ASSERT_EQUAL(2, batch.ackCount);
+  TEST_ASSERT_EQUAL_UINT32(7, batch.acks[0].clientId);
+  TEST_ASSERT_EQUAL_UINT32(last, batch.acks[0].seq);
+  TEST_ASSERT_EQUAL_UINT32(9, batch.acks[1].clientId);
+
+  queue.done(batch.lastSeq);
+  TEST_ASSERT_TRUE(queue.completed(first));
+  TEST_ASSERT_TRUE(queue.completed(last));
+}
+
+void test_wifi_merges_per_record() {
+  CommandQueue queue;
+  CommandQueue::Command sta;
+  sta.kind = CommandQueue::SAVE_WIFI;
+  strncpy(sta.wifi.ssid, "alt", sizeof(sta.wifi.ssid) - 1);
+  queue.push(sta);
+  strncpy(sta.wifi.ssid, "neu", sizeof(sta.wifi.ssid) - 1);
+  queue.push(sta);
+  CommandQueue::Command ap;
+  ap.kind = CommandQueue::SAVE_WIFI;
+  ap.ap = true;
+  ap.reboot = true;
+  strncpy(ap.wifi.ssid, "ESP32-AP", sizeof(ap.wifi.ssid) - 1);
+  queue.push(ap);
+
+  CommandQueue::Batch batch;
+  TEST_ASSERT_TRUE(queue.take(batch));
+  TEST_ASSERT_TRUE(batch.hasWifi[0]);
+  TEST_ASSERT_TRUE(batch.hasWifi[1]);
+  TEST_ASSERT_EQUAL_STRING("neu", batch.wifi[0].ssid);
+  TEST_ASSERT_EQUAL_STRING("ESP32-AP", batch.wifi[1].ssid);
+  TEST_ASSERT_TRUE(batch.reboot);
+  TEST_ASSERT_EQUAL_UINT32(1, queue.stats().merged);
+}
+
+void test_full_queue_rejects() {
+  CommandQueue queue;
+  for (size_t i = 0; i < CommandQueue::kCapacity; i++) {
+    CommandQueue::Command cmd = led(i & 1);
+    TEST_ASSERT_NOT_EQUAL(0, queue.push(cmd));
+  }
+  CommandQueue::Command cmd = led(true);
+  TEST_ASSERT_EQUAL_UINT32(0, queue.push(cmd));
+  TEST_ASSERT_EQUAL_UINT32(1, queue.stats().full);
+
+  CommandQueue::Batch batch;
+  TEST_ASSERT_TRUE(queue.take(batch));
+  TEST_ASSERT_NOT_EQUAL(0, queue.push(cmd));
+}
+
+void test_ring_concurrent_producer_consumer() {
+  static SpscRing<uint32_t, 8> ring;
+  static const uint32_t kItems = 200000;
+  std::thread producer([] {
+    for (uint32_t i = 1; i <= kItems;) {
+      if (ring.push(i)) i++;
+    }
+  });
+  uint32_t expected = 1;
+  bool ordered = true;
+  while (expected <= kItems) {
+    uint32_t value;
+    if (!ring.pop(value)) continue;
+    if (value != expected) ordered = false;
+    expected++;
+  }
+  producer.join();
+  TEST_ASSERT_TRUE(ordered);
+  TEST_ASSERT_EQUAL(0, ring.size());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_take_applies_and_completes);
+  RUN_TEST(test_repeated_commands_merge);
+  RUN_TEST(test_wifi_merges_per_record);
+  RUN_TEST(test_full_queue_rejects);
+  RUN_TEST(test_ring_concurrent_producer_consumer);
+  return UNITY_END();
+}
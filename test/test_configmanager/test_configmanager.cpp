@@ -0,0 +1,416 @@
+// Unity-Tests für Log-Speicher, Schema und RAM-Cache hinter ConfigManager (pio test)
+// Simulierter NOR-Flash: zählt Löschzyklen und kann den Strom nach N Bytes "abschalten".
+#include <unity.h>
+#include <string.h>
+#include <vector>
+#include "LogStore.h"
+#include "ConfigSchema.h"
+#include "ConfigCache.h"
+
+class SimFlash : public FlashDevice {
+public:
+  SimFlash(size_t sectorSize, size_t sectors)
+  : _sectorSize(sectorSize), _mem(sectorSize * sectors, 0xFF), _erases(sectors, 0) {}
+
+  size_t sectorSize() const override { return _sectorSize; }
+  size_t sectorCount() const override { return _erases.size(); }
+
+  bool read(uint32_t addr, void *out, size_t len) override {
+    if (addr + len > _mem.size()) return false;
+    memcpy(out, &_mem[addr], len);
+    return true;
+  }
+  bool write(uint32_t addr, const void *data, size_t len) override {
+    if (addr + len > _mem.size() || _dead) return false;
+    const uint8_t *p = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) {
+      if (!budget()) return false;
+      _mem[addr + i] &= p[i];   // NOR: nur 1 -> 0
+    }
+    return true;
+  }
+  bool erase(size_t sector) override {
+    if (sector >= _erases.size() || _dead) return false;
+    _erases[sector]++;
+    for (size_t i = 0; i < _sectorSize; i++) {
+      if (!budget()) return false;   // halb gelöschter Sektor
+      _mem[sector * _sectorSize + i] = 0xFF;
+    }
+    return true;
+  }
+
+  // nach n weiteren Bytes fällt der Strom aus (-1 = nie)
+  void cutAfter(long n) { _budget = n; _dead = false; }
+  void powerOn() { _budget = -1; _dead = false; }
+  bool dead() const { return _dead; }
+
+  uint32_t erases(size_t sector) const { return _erases[sector]; }
+  std::vector<uint8_t> snapshot() const { return _mem; }
+  void restore(const std::vector<uint8_t> &mem) { _mem = mem; }
+
+private:
+  bool budget() {
+    if (_budget < 0) return true;
+    if (_budget == 0) { _dead = true; return false; }
+    _budget--;
+    return true;
+  }
+
+  size_t _sectorSize;
+  std::vector<uint8_t> _mem;
+  std::vector<uint32_t> _erases;
+  long _budget = -1;
+  bool _dead = false;
+};
+
+struct Value {
+  uint32_t counter;
+  char text[40];
+};
+
+static Value makeValue(uint32_t n) {
+  Value v{};
+  v.counter = n;
+  snprintf(v.text, sizeof(v.text), "Wert %lu", (unsigned long)n);
+  return v;
+}
+
+static void test_roundtrip_and_replay() {
+  SimFlash flash(1024, 4);
+  {
+    LogStore store(flash);
+    TEST_ASSERT_TRUE(store.mount());
+    TEST_ASSERT_TRUE(store.empty());
+    Value v = makeValue(1);
+    TEST_ASSERT_TRUE(store.put(1, &v, sizeof(v)));
+    v = makeValue(2);
+    TEST_ASSERT_TRUE(store.put(1, &v, sizeof(v)));
+    uint8_t b = 42;
+    TEST_ASSERT_TRUE(store.put(3, &b, 1));
+  }
+  LogStore store(flash);
+  TEST_ASSERT_TRUE(store.mount());
+  Value v;
+  TEST_ASSERT_TRUE(store.get(1, &v, sizeof(v)));
+  TEST_ASSERT_EQUAL_UINT32(2, v.counter);
+  TEST_ASSERT_EQUAL_STRING("Wert 2", v.text);
+  uint8_t b = 0;
+  TEST_ASSERT_TRUE(store.get(3, &b, 1));
+  TEST_ASSERT_EQUAL_UINT8(42, b);
+  TEST_ASSERT_FALSE(store.get(2, &b, 1));
+}
+
+static void test_unchanged_value_is_not_written() {
+  SimFlash flash(1024, 4);
+  LogStore store(flash);
+  TEST_ASSERT_TRUE(store.mount());
+  Value v = makeValue(7);
+  for (int i = 0; i < 100; i++) TEST_ASSERT_TRUE(store.put(1, &v, sizeof(v)));
+  TEST_ASSERT_EQUAL_UINT32(1, store.stats().appends);
+  TEST_ASSERT_EQUAL_UINT32(99, store.stats().skipped);
+}
+
+// Viele Schreibzugriffe: Löschzyklen verteilen sich gleichmäßig, Werte bleiben erhalten
+static void test_wear_leveling() {
+  SimFlash flash(1024, 4);
+  LogStore store(flash);
+  TEST_ASSERT_TRUE(store.mount());
+  uint8_t fixed = 99;
+  TEST_ASSERT_TRUE(store.put(5, &fixed, 1));
+
+  for (uint32_t n = 0; n < 5000; n++) {
+    Value v = makeValue(n);
+    TEST_ASSERT_TRUE(store.put(n % 3, &v, sizeof(v)));
+    if (n % 10 == 0) store.maintain();
+  }
+
+  uint32_t minErase = UINT32_MAX, maxErase = 0;
+  for (size_t s = 0; s < flash.sectorCount(); s++) {
+    minErase = flash.erases(s) < minErase ? flash.erases(s) : minErase;
+    maxErase = flash.erases(s) > maxErase ? flash.erases(s) : maxErase;
+  }
+  TEST_ASSERT_GREATER_THAN_UINT32(0, minErase);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(minErase + 1, maxErase);
+
+  LogStore again(flash);
+  TEST_ASSERT_TRUE(again.mount());
+  Value v;
+  TEST_ASSERT_TRUE(again.get(4997 % 3, &v, sizeof(v)));
+  TEST_ASSERT_EQUAL_UINT32(4997, v.counter);
+  uint8_t b = 0;
+  TEST_ASSERT_TRUE(again.get(5, &b, 1));
+  TEST_ASSERT_EQUAL_UINT8(99, b);
+}
+
+// Stromausfall an jeder Byteposition eines put() (inkl. Sektorwechsel und
+// Kompaktierung): danach gilt entweder der alte oder der neue Wert, andere Keys
+// bleiben unverändert.
+static void test_power_cut_at_every_byte() {
+  SimFlash flash(256, 3);
+  LogStore store(flash);
+  TEST_ASSERT_TRUE(store.mount());
+  uint8_t fixed = 7;
+  TEST_ASSERT_TRUE(store.put(2, &fixed, 1));
+
+  for (uint32_t n = 1; n < 60; n++) {
+    Value before = makeValue(n - 1);
+    TEST_ASSERT_TRUE(store.put(1, &before, sizeof(before)));
+    std::vector<uint8_t> image = flash.snapshot();
+
+    for (long cut = 0; ; cut++) {
+      flash.restore(image);
+      flash.powerOn();
+      LogStore victim(flash);
+      TEST_ASSERT_TRUE(victim.mount());
+      flash.cutAfter(cut);
+      Value after = makeValue(n);
+      victim.put(1, &after, sizeof(after));
+      bool finished = !flash.dead();
+      flash.powerOn();
+
+      LogStore rebooted(flash);
+      TEST_ASSERT_TRUE(rebooted.mount());
+      Value v;
+      TEST_ASSERT_TRUE(rebooted.get(1, &v, sizeof(v)));
+      TEST_ASSERT_TRUE(v.counter == n - 1 || v.counter == n);
+      if (finished) TEST_ASSERT_EQUAL_UINT32(n, v.counter);
+      uint8_t b = 0;
+      TEST_ASSERT_TRUE(rebooted.get(2, &b, 1));
+      TEST_ASSERT_EQUAL_UINT8(7, b);
+
+      // nach dem Neustart muss weiter geschrieben werden können
+      for (int k = 0; k < 8; k++) rebooted.maintain();
+      Value next = makeValue(1000 + n);
+      TEST_ASSERT_TRUE(rebooted.put(1, &next, sizeof(next)));
+      if (finished) break;
+    }
+    flash.restore(image);
+    flash.powerOn();
+    TEST_ASSERT_TRUE(store.mount());
+  }
+}
+
+static void test_rejects_oversized_and_unknown_keys() {
+  SimFlash flash(1024, 4);
+  LogStore store(flash);
+  TEST_ASSERT_TRUE(store.mount());
+  uint8_t big[LogStore::kMaxValue + 1] = {0};
+  TEST_ASSERT_FALSE(store.put(1, big, sizeof(big)));
+  TEST_ASSERT_FALSE(store.put(LogStore::kMaxKeys, big, 1));
+}
+
+static ConfigData makeConfig() {
+  ConfigData data;
+  memset(&data, 0, sizeof(data));
+  strcpy(data.sta.ssid, "heimnetz");
+  data.ap.ip[0] = 192; data.ap.ip[1] = 168; data.ap.ip[2] = 10; data.ap.ip[3] = 1;
+  data.byteValue = 17;
+  data.floatValue = 2.5f;
+  strcpy(data.text, "Hallo");
+  data.testObject.long_field = 123456;
+  return data;
+}
+
+// Schema: leeres Log = Version 1, gespeichert = aktuelle Version mit gültiger CRC
+static void test_schema_roundtrip() {
+  SimFlash flash(1024, 4);
+  LogStore store(flash);
+  TEST_ASSERT_TRUE(store.mount());
+  ConfigData data;
+  bool valid = true;
+  TEST_ASSERT_EQUAL_UINT16(1, ConfigSchema::load(store, data, valid));
+  TEST_ASSERT_FALSE(valid);
+
+  ConfigData saved = makeConfig();
+  TEST_ASSERT_TRUE(ConfigSchema::save(store, saved, ConfigSchema::kAllFields));
+  LogStore again(flash);
+  TEST_ASSERT_TRUE(again.mount());
+  TEST_ASSERT_EQUAL_UINT16(kConfigVersion, ConfigSchema::load(again, data, valid));
+  TEST_ASSERT_TRUE(valid);
+  TEST_ASSERT_EQUAL_STRING("heimnetz", data.sta.ssid);
+  TEST_ASSERT_EQUAL_UINT8(17, data.byteValue);
+  TEST_ASSERT_EQUAL_STRING("Hallo", data.text);
+  TEST_ASSERT_EQUAL_INT32(123456, data.testObject.long_field);
+}
+
+// Feld ohne neuen Header geschrieben (Stromausfall in save()): CRC passt nicht
+static void test_schema_detects_stale_header() {
+  SimFlash flash(1024, 4);
+  LogStore store(flash);
+  TEST_ASSERT_TRUE(store.mount());
+  ConfigData data = makeConfig();
+  TEST_ASSERT_TRUE(ConfigSchema::save(store, data, ConfigSchema::kAllFields));
+  uint8_t b = 99;
+  TEST_ASSERT_TRUE(store.put(KEY_BYTE, &b, 1));
+  bool valid = true;
+  TEST_ASSERT_EQUAL_UINT16(kConfigVersion, ConfigSchema::load(store, data, valid));
+  TEST_ASSERT_FALSE(valid);
+
+  // Übernahme-Marker aus Version 2
+  TEST_ASSERT_TRUE(store.put(KEY_HEADER, &b, 1));
+  TEST_ASSERT_EQUAL_UINT16(2, ConfigSchema::load(store, data, valid));
+  TEST_ASSERT_FALSE(valid);
+}
+
+static int migrationOrder[4];
+static int migrationCount;
+static bool step1(ConfigData &d) { migrationOrder[migrationCount++] = 1; d.byteValue = 1; return true; }
+static bool step2(ConfigData &d) { migrationOrder[migrationCount++] = 2; d.byteValue++; return true; }
+
+static void test_schema_migrations_run_in_order() {
+  const ConfigSchema::Migration table[] = { { 2, step2, "zwei" }, { 1, step1, "eins" } };
+  ConfigData data;
+  memset(&data, 0, sizeof(data));
+  migrationCount = 0;
+  TEST_ASSERT_TRUE(ConfigSchema::migrate(data, 1, table, 2));
+  TEST_ASSERT_EQUAL_INT(2, migrationCount);
+  TEST_ASSERT_EQUAL_INT(1, migrationOrder[0]);
+  TEST_ASSERT_EQUAL_INT(2, migrationOrder[1]);
+  TEST_ASSERT_EQUAL_UINT8(2, data.byteValue);
+
+  // fehlender Schritt -> Fehler
+  migrationCount = 0;
+  TEST_ASSERT_FALSE(ConfigSchema::migrate(data, 1, table + 1, 1));
+}
+
+// Übernahme aus der alten Ablage im selben Flash (EepromFlash): alte Daten in
+// Sektor 0, das Log beginnt in Sektor 1. Stromausfall an jeder Byteposition
+// von save(): der nächste Start übernimmt erneut und kommt zum selben Ergebnis.
+static SimFlash *legacyFlash;
+static bool fromLegacy(ConfigData &d) {
+  legacyFlash->read(0, d.text, MAX_TEXT);
+  legacyFlash->read(64, d.sta.ssid, MAX_SSID);
+  legacyFlash->read(96, &d.byteValue, 1);
+  return true;
+}
+static bool addHeader(ConfigData &) { return true; }
+
+static void bootLegacy(SimFlash &flash, ConfigData &data) {
+  static const ConfigSchema::Migration table[] = { { 1, fromLegacy, "alt" }, { 2, addHeader, "header" } };
+  LogStore store(flash, 1);
+  TEST_ASSERT_TRUE(store.mount());
+  bool valid = false;
+  uint16_t version = ConfigSchema::load(store, data, valid);
+  if (valid) return;
+  if (version < kConfigVersion) TEST_ASSERT_TRUE(ConfigSchema::migrate(data, version, table, 2));
+  ConfigSchema::save(store, data, ConfigSchema::kAllFields);
+}
+
+static void test_legacy_migration_survives_power_cut() {
+  SimFlash flash(1024, 4);
+  legacyFlash = &flash;
+  uint8_t old[EEPROM_SIZE];
+  memset(old, 0, sizeof(old));
+  strcpy((char*)old, "Alter Text");
+  strcpy((char*)old + 64, "altnetz");
+  old[96] = 42;
+  TEST_ASSERT_TRUE(flash.write(0, old, sizeof(old)));
+  std::vector<uint8_t> image = flash.snapshot();
+
+  for (long cut = 0; ; cut++) {
+    flash.restore(image);
+    flash.cutAfter(cut);
+    ConfigData data;
+    bootLegacy(flash, data);
+    bool finished = !flash.dead();
+    flash.powerOn();
+
+    bootLegacy(flash, data);
+    LogStore store(flash, 1);
+    TEST_ASSERT_TRUE(store.mount());
+    bool valid = false;
+    TEST_ASSERT_EQUAL_UINT16(kConfigVersion, ConfigSchema::load(store, data, valid));
+    TEST_ASSERT_TRUE(valid);
+    TEST_ASSERT_EQUAL_STRING("Alter Text", data.text);
+    TEST_ASSERT_EQUAL_STRING("altnetz", data.sta.ssid);
+    TEST_ASSERT_EQUAL_UINT8(42, data.byteValue);
+    if (finished) break;
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, flash.erases(0));
+}
+
+// Schreibzugriffe kurz hintereinander landen in einem Commit
+static void test_cache_coalesces_writes() {
+  SimFlash flash(1024, 4);
+  LogStore store(flash);
+  TEST_ASSERT_TRUE(store.mount());
+  ConfigCache cache;
+  uint32_t now = 0;
+  for (int i = 1; i <= 20; i++, now += 100) {
+    cache.modify(KEY_BYTE, now, [&](ConfigData &d) { d.byteValue = (uint8_t)i; });
+    cache.modify(KEY_FLOAT, now, [&](ConfigData &d) { d.floatValue = i * 0.5f; });
+    TEST_ASSERT_FALSE(cache.due(now));
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, store.stats().appends);
+  now += ConfigCache::kQuietMs;
+  TEST_ASSERT_TRUE(cache.due(now));
+  TEST_ASSERT_TRUE(cache.flush(store, now));
+  TEST_ASSERT_EQUAL_UINT32(1, cache.stats().commits);
+  TEST_ASSERT_EQUAL_UINT32(3, store.stats().appends);   // zwei Felder + Header
+  TEST_ASSERT_FALSE(cache.pending());
+
+  // gleicher Wert -> nichts zu tun
+  cache.modify(KEY_BYTE, now, [&](ConfigData &d) { d.byteValue = 20; });
+  TEST_ASSERT_FALSE(cache.pending());
+  TEST_ASSERT_EQUAL_UINT32(1, cache.stats().unchanged);
+
+  LogStore again(flash);
+  TEST_ASSERT_TRUE(again.mount());
+  ConfigData data;
+  bool valid = false;
+  ConfigSchema::load(again, data, valid);
+  TEST_ASSERT_TRUE(valid);
+  TEST_ASSERT_EQUAL_UINT8(20, data.byteValue);
+}
+
+// Dauerndes Schreiben: spätestens nach kMaxDelayMs wird gespeichert
+static void test_cache_commit_rate_is_bounded() {
+  SimFlash flash(1024, 4);
+  LogStore store(flash);
+  TEST_ASSERT_TRUE(store.mount());
+  ConfigCache cache;
+  for (uint32_t now = 0; now < 60000; now += 50) {
+    cache.modify(KEY_TEXT, now, [&](ConfigData &d) { snprintf(d.text, sizeof(d.text), "%lu", (unsigned long)now); });
+    if (cache.due(now)) TEST_ASSERT_TRUE(cache.flush(store, now));
+  }
+  TEST_ASSERT_EQUAL_UINT32(1200, cache.stats().writes);
+  TEST_ASSERT_EQUAL_UINT32(60000 / ConfigCache::kMaxDelayMs - 1, cache.stats().commits);
+  TEST_ASSERT_TRUE(cache.pending());
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+void setup() {
+  delay(2000);
+  UNITY_BEGIN();
+  RUN_TEST(test_roundtrip_and_replay);
+  RUN_TEST(test_unchanged_value_is_not_written);
+  RUN_TEST(test_wear_leveling);
+  RUN_TEST(test_power_cut_at_every_byte);
+  RUN_TEST(test_rejects_oversized_and_unknown_keys);
+  RUN_TEST(test_schema_roundtrip);
+  RUN_TEST(test_schema_detects_stale_header);
+  RUN_TEST(test_schema_migrations_run_in_order);
+  RUN_TEST(test_legacy_migration_survives_power_cut);
+  RUN_TEST(test_cache_coalesces_writes);
+  RUN_TEST(test_cache_commit_rate_is_bounded);
+  UNITY_END();
+}
+void loop() {}
+#else
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_roundtrip_and_replay);
+  RUN_TEST(test_unchanged_value_is_not_written);
+  RUN_TEST(test_wear_leveling);
+  RUN_TEST(test_power_cut_at_every_byte);
+  RUN_TEST(test_rejects_oversized_and_unknown_keys);
+  RUN_TEST(test_schema_roundtrip);
+  RUN_TEST(test_schema_detects_stale_header);
+  RUN_TEST(test_schema_migrations_run_in_order);
+  RUN_TEST(test_legacy_migration_survives_power_cut);
+  RUN_TEST(test_cache_coalesces_writes);
+  RUN_TEST(test_cache_commit_rate_is_bounded);
+  return UNITY_END();
+}
+#endif
@@ -0,0 +1,92 @@
+// Unity-Tests für DeviceState (pio test -e native, nebenläufig unter
+// ThreadSanitizer: pio test -e native_tsan)
+// Schreiber wie loop() und die Handler im AsyncTCP-Task halten eine
+// Invariante über alle Felder ein; Leser dürfen sie nie verletzt sehen.
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "DeviceState.h"
+
+// restartAt und led hängen am Zähler: ein gemischter Stand fällt auf
+static void advance(DeviceState::Snapshot &d) {
+  d.counter++;
+  d.led = d.counter & 1;
+  d.blink = !d.led;
+  d.restartAt = (uint32_t)d.counter * 3;
+}
+
+static bool consistent(const DeviceState::Snapshot &d) {
+  return d.led == (bool)(d.counter & 1) && d.blink == !d.led && d.restartAt == (uint32_t)d.counter * 3;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_starts_empty() {
+  DeviceState device;
+  DeviceState::Snapshot d = device.read();
+  TEST_ASSERT_EQUAL_INT32(0, d.counter);
+  TEST_ASSERT_FALSE(d.led);
+  TEST_ASSERT_FALSE(d.blink);
+  TEST_ASSERT_EQUAL_UINT32(0, d.restartAt);
+}
+
+void test_update_returns_new_state() {
+  DeviceState device;
+  device.update([](DeviceState::Snapshot &d) { d.counter = 41; d.blink = true; });
+  DeviceState::Snapshot d = device.update([](DeviceState::Snapshot &d) { d.counter++; });
+  TEST_ASSERT_EQUAL_INT32(42, d.counter);
+  TEST_ASSERT_TRUE(d.blink);
+  TEST_ASSERT_EQUAL_INT32(42, device.read().counter);
+  TEST_ASSERT_TRUE(device.read().blink);
+}
+
+void test_concurrent_readers_see_consistent_state() {
+  static const int kWriters = 2;
+  static const int kReaders = 3;
+  static const int kUpdates = 50000;
+  DeviceState device;
+  device.update([](DeviceState::Snapshot &d) { d.counter = -1; advance(d); });
+
+  std::atomic<bool> done{false};
+  std::atomic<uint32_t> torn{0};
+  std::atomic<uint32_t> reads{0};
+  std::vector<std::thread> threads;
+  for (int r = 0; r < kReaders; r++) {
+    threads.emplace_back([&] {
+      int32_t last = 0;
+      while (!done.load()) {
+        DeviceState::Snapshot d = device.read();
+        // Zähler läuft nur vorwärts
+        if (!consistent(d) || d.counter < last) torn.fetch_add(1);
+        last = d.counter;
+        reads.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  std::vector<std::thread> writers;
+  for (int w = 0; w < kWriters; w++) {
+    writers.emplace_back([&] {
+      for (int i = 0; i < kUpdates; i++) device.update(advance);
+    });
+  }
+  for (auto &t : writers) t.join();
+  done = true;
+  for (auto &t : threads) t.join();
+
+  TEST_ASSERT_EQUAL_UINT32(0, torn.load());
+  TEST_ASSERT_TRUE(reads.load() > 0);
+  // keine Erhöhung verloren: Schreiber schließen sich gegenseitig aus
+  DeviceState::Snapshot d = device.read();
+  TEST_ASSERT_EQUAL_INT32(kWriters * kUpdates, d.counter);
+  TEST_ASSERT_TRUE(consistent(d));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_starts_empty);
+  RUN_TEST(test_update_returns_new_state);
+  RUN_TEST(test_concurrent_readers_see_consistent_state);
+  return UNITY_END();
+}
@@ -0,0 +1,174 @@
+// Unity-Tests für EventStream (pio test -e native)
+// SSE-Clients kommen aus AsyncEventSource::hostConnect(), optional mit dem
+// Last-Event-ID-Header eines wiederverbindenden Browsers.
+#include <unity.h>
+#include "EventStream.h"
+
+static AsyncEventSource *source;
+static EventStream *events;
+
+static void reset() {
+  delete events;
+  delete source;
+  source = new AsyncEventSource("/events");
+  events = new EventStream(*source);
+  events->begin();
+}
+
+void setUp() { reset(); }
+void tearDown() {}
+
+void test_new_client_gets_full_state() {
+  events->set(EventStream::COUNTER, 7);
+  events->set(EventStream::LED, 1);
+  events->publish();
+  AsyncEventSourceClient *client = source->hostConnect();
+  TEST_ASSERT_EQUAL_STRING("retry: 2000\r\nid: 1\r\nevent: state\r\n"
+                           "data: {\"full\":true,\"counter\":7,\"led\":true}\r\n\r\n",
+                           client->hostReceived().c_str());
+  TEST_ASSERT_EQUAL_UINT32(1, events->stats().snapshots);
+}
+
+// Ein Event wird einmal formatiert, egal wie viele Clients zuhören
+void test_delta_formatted_once_for_all_clients() {
+  events->set(EventStream::COUNTER, 1);
+  events->publish();
+  AsyncEventSourceClient *clients[4];
+  for (auto &c : clients) {
+    c = source->hostConnect();
+    c->hostDrain();
+  }
+  uint32_t before = source->hostFormatted();
+  events->set(EventStream::COUNTER, 2);
+  events->set(EventStream::UPTIME, 60);
+  TEST_ASSERT_EQUAL(2, events->publish());
+  TEST_ASSERT_EQUAL_UINT32(before + 1, source->hostFormatted());
+  for (auto c : clients) {
+    TEST_ASSERT_EQUAL_STRING("id: 2\r\nevent: state\r\ndata: {\"counter\":2,\"uptime\":60}\r\n\r\n",
+                             c->hostReceived().c_str());
+  }
+}
+
+void test_unchanged_fields_send_nothing() {
+  events->set(EventStream::FREE_HEAP, 100000);
+  events->publish();
+  AsyncEventSourceClient *client = source->hostConnect();
+  client->hostDrain();
+  events->set(EventStream::FREE_HEAP, 100000);
+  TEST_ASSERT_EQUAL(0, events->publish());
+  TEST_ASSERT_EQUAL(0, client->hostDrain());
+}
+
+void test_resume_replays_missed_events() {
+  for (int i = 1; i <= 5; i++) {
+    events->set(EventStream::COUNTER, i);
+    events->publish();
+  }
+  AsyncEventSourceClient *client = source->hostConnect(3);
+  TEST_ASSERT_EQUAL_STRING("retry: 2000\r\nid: 4\r\nevent: state\r\ndata: {\"counter\":4}\r\n\r\n"
+                           "id: 5\r\nevent: state\r\ndata: {\"counter\":5}\r\n\r\n",
+                           client->hostReceived().c_str());
+  TEST_ASSERT_EQUAL_UINT32(2, events->stats().replayed);
+  TEST_ASSERT_EQUAL_UINT32(0, events->stats().snapshots);
+
+  // schon aktuell: nichts nachzureichen
+  AsyncEventSourceClient *current = source->hostConnect(5);
+  TEST_ASSERT_EQUAL(0, current->hostMessages());
+}
+
+void test_resume_too_old_falls_back_to_full_state() {
+  for (int i = 1; i <= (int)EventStream::kHistory + 5; i++) {
+    events->set(EventStream::COUNTER, i);
+    events->publish();
+  }
+  AsyncEventSourceClient *client = source->hostConnect(2);
+  TEST_ASSERT_EQUAL_UINT32(1, client->hostMessages());
+  TEST_ASSERT_TRUE(client->hostReceived().indexOf("\"full\":true,\"counter\":21") >= 0);
+  // id aus der Zukunft (Gerät neu gestartet): ebenfalls vollständig
+  AsyncEventSourceClient *stale = source->hostConnect(1000);
+  TEST_ASSERT_TRUE(stale->hostReceived().indexOf("\"full\":true") >= 0);
+  TEST_ASSERT_EQUAL_UINT32(2, events->stats().snapshots);
+}
+
+// Neustart: gleiche Zählung, andere Epoche – die alte id wird nicht fortgesetzt
+void test_ids_from_previous_boot_are_not_resumed() {
+  events->begin(1);
+  for (int i = 1; i <= 5; i++) {
+    events->set(EventStream::COUNTER, i);
+    events->publish();
+  }
+  uint32_t before = events->lastId();
+  TEST_ASSERT_EQUAL_UINT32(0x10005, before);
+
+  reset();
+  events->begin(2);
+  for (int i = 1; i <= 6; i++) {
+    events->set(EventStream::COUNTER, 100 + i);
+    events->publish();
+  }
+  AsyncEventSourceClient *client = source->hostConnect(before);
+  TEST_ASSERT_EQUAL_UINT32(1, client->hostMessages());
+  TEST_ASSERT_TRUE(client->hostReceived().indexOf("\"full\":true,\"counter\":106") >= 0);
+  TEST_ASSERT_EQUAL_UINT32(0, events->stats().replayed);
+}
+
+// Überlauf der ids bei hoher Epoche: Nachreichen über 2^32 hinweg, id 0 kommt nie vor
+void test_resume_across_id_wraparound() {
+  events->begin(0xFFFF);
+  int32_t n = 0;
+  while (events->lastId() != 0xFFFFFFFDu) {
+    events->set(EventStream::COUNTER, ++n);
+    events->publish();
+  }
+  uint32_t since = events->lastId();
+  for (int i = 0; i < 4; i++) {
+    events->set(EventStream::COUNTER, ++n);
+    events->publish();
+  }
+  TEST_ASSERT_EQUAL_UINT32(2, events->lastId());
+
+  AsyncEventSourceClient *client = source->hostConnect(since);
+  TEST_ASSERT_EQUAL_UINT32(4, client->hostMessages());
+  String expected = String("retry: 2000\r\nid: 4294967294\r\nevent: state\r\ndata: {\"counter\":") + String(n - 3) + "}\r\n\r\n"
+                    + "id: 4294967295\r\nevent: state\r\ndata: {\"counter\":" + String(n - 2) + "}\r\n\r\n"
+                    + "id: 1\r\nevent: state\r\ndata: {\"counter\":" + String(n - 1) + "}\r\n\r\n"
+                    + "id: 2\r\nevent: state\r\ndata: {\"counter\":" + String(n) + "}\r\n\r\n";
+  TEST_ASSERT_EQUAL_STRING(expected.c_str(), client->hostReceived().c_str());
+  TEST_ASSERT_EQUAL_UINT32(4, events->stats().replayed);
+
+  // aktuell nach dem Überlauf: nichts nachzureichen
+  AsyncEventSourceClient *current = source->hostConnect(2);
+  TEST_ASSERT_EQUAL(0, current->hostMessages());
+}
+
+// Status-Stream: Event "status" ohne id, Last-Event-ID bleibt bei den Deltas
+void test_status_event_keeps_delta_ids() {
+  TEST_ASSERT_FALSE(events->publishStatus("{\"uptime_sec\":1}"));   // keiner da
+  events->set(EventStream::COUNTER, 3);
+  events->publish();
+  AsyncEventSourceClient *client = source->hostConnect();
+  client->hostDrain();
+
+  TEST_ASSERT_TRUE(events->publishStatus("{\"uptime_sec\":2}"));
+  TEST_ASSERT_EQUAL_STRING("event: status\r\ndata: {\"uptime_sec\":2}\r\n\r\n",
+                           client->hostReceived().c_str());
+  TEST_ASSERT_EQUAL_UINT32(1, events->lastId());
+  TEST_ASSERT_EQUAL_UINT32(1, events->stats().statusEvents);
+
+  // Wiederverbinden nach dem Status-Event: nichts nachzureichen
+  AsyncEventSourceClient *again = source->hostConnect(1);
+  TEST_ASSERT_EQUAL(0, again->hostMessages());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_new_client_gets_full_state);
+  RUN_TEST(test_delta_formatted_once_for_all_clients);
+  RUN_TEST(test_unchanged_fields_send_nothing);
+  RUN_TEST(test_resume_replays_missed_events);
+  RUN_TEST(test_resume_too_old_falls_back_to_full_state);
+  RUN_TEST(test_ids_from_previous_boot_are_not_resumed);
+  RUN_TEST(test_resume_across_id_wraparound);
+  RUN_TEST(test_status_event_keeps_delta_ids);
+  return UNITY_END();
+}
@@ -0,0 +1,133 @@
+// Unity-Tests für NativeHost::HttpListener (pio test -e native)
+// Echte Sockets auf 127.0.0.1: der Client läuft in einem eigenen Thread und
+// arbeitet blockierend, der Server wird im Testthread mit poll() bedient.
+#include <unity.h>
+#include <HttpListener.h>
+#include <arpa/inet.h>
+#include <atomic>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+static AsyncWebServer server(8080);
+static NativeHost::HttpListener *listener;
+
+static int connectLocal() {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(listener->port());
+  if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static std::string readAll(int fd) {
+  std::string response;
+  char buffer[512];
+  ssize_t n;
+  while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) response.append(buffer, n);
+  return response;
+}
+
+// Request senden und bis zum Schließen lesen, Server solange bedienen
+static std::string exchange(const std::string &request) {
+  std::atomic<bool> done(false);
+  std::string response;
+  std::thread client([&] {
+    int fd = connectLocal();
+    if (fd >= 0) {
+      send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+      response = readAll(fd);
+      close(fd);
+    }
+    done = true;
+  });
+  while (!done) listener->poll(5);
+  client.join();
+  return response;
+}
+
+void setUp() {
+  listener = new NativeHost::HttpListener(server, 2);
+  TEST_ASSERT_TRUE(listener->begin());
+}
+
+void tearDown() {
+  delete listener;
+}
+
+void test_get_with_query() {
+  std::string response = exchange("GET /echo?name=Hallo%20Welt&x=1 HTTP/1.1\r\nHost: x\r\n\r\n");
+  TEST_ASSERT_EQUAL_STRING("HTTP/1.1 200 OK\r\n", response.substr(0, 17).c_str());
+  TEST_ASSERT_TRUE(response.find("Connection: close\r\n\r\n") != std::string::npos);
+  TEST_ASSERT_TRUE(response.find("\r\n\r\nget:Hallo Welt") != std::string::npos);
+}
+
+void test_post_form_in_two_segments() {
+  std::atomic<bool> done(false);
+  std::string response;
+  std::thread client([&] {
+    int fd = connectLocal();
+    const char head[] = "POST /echo HTTP/1.1\r\nContent-Type: application/x-www-form-urlencoded\r\n"
+                        "content-length: 14\r\n\r\nname=a";
+    send(fd, head, sizeof(head) - 1, MSG_NOSIGNAL);
+    usleep(20000);
+    send(fd, "%2Bb+c&y", 8, MSG_NOSIGNAL);
+    response = readAll(fd);
+    close(fd);
+    done = true;
+  });
+  while (!done) listener->poll(5);
+  client.join();
+  TEST_ASSERT_TRUE(response.find("\r\n\r\npost:a+b c") != std::string::npos);
+}
+
+void test_unknown_route_and_bad_request() {
+  std::string missing = exchange("GET /nirgends HTTP/1.1\r\n\r\n");
+  TEST_ASSERT_EQUAL_STRING("HTTP/1.1 404 Not Found\r\n", missing.substr(0, 24).c_str());
+  // kaputte Anfrage: Verbindung wird ohne Antwort geschlossen
+  TEST_ASSERT_EQUAL_STRING("", exchange("KAPUTT\r\n\r\n").c_str());
+  TEST_ASSERT_EQUAL_UINT32(1, listener->stats().badRequests);
+}
+
+void test_body_longer_than_one_segment() {
+  std::string response = exchange("GET /big HTTP/1.1\r\n\r\n");
+  size_t body = response.find("\r\n\r\n") + 4;
+  TEST_ASSERT_EQUAL_UINT32(5000, response.size() - body);
+}
+
+// Mehr Verbindungen als freie PCBs: die überzählige wird sofort geschlossen
+void test_refuses_above_max_connections() {
+  int fds[3];
+  for (int &fd : fds) fd = connectLocal();
+  for (int i = 0; i < 10; i++) listener->poll(5);
+  TEST_ASSERT_EQUAL_UINT32(2, listener->stats().open);
+  TEST_ASSERT_EQUAL_UINT32(1, listener->stats().refused);
+  char c;
+  TEST_ASSERT_TRUE(recv(fds[2], &c, 1, 0) <= 0);
+  for (int fd : fds) close(fd);
+}
+
+int main() {
+  server.on("/echo", HTTP_GET, [](AsyncWebServerRequest *request) {
+    request->send(200, "text/plain", "get:" + request->getParam("name")->value());
+  });
+  server.on("/echo", HTTP_POST, [](AsyncWebServerRequest *request) {
+    request->send(200, "text/plain", "post:" + request->getParam("name", true)->value());
+  });
+  server.on("/big", HTTP_GET, [](AsyncWebServerRequest *request) {
+    request->send(200, "text/plain", String(std::string(5000, 'x').c_str()));
+  });
+  UNITY_BEGIN();
+  RUN_TEST(test_get_with_query);
+  RUN_TEST(test_post_form_in_two_segments);
+  RUN_TEST(test_unknown_route_and_bad_request);
+  RUN_TEST(test_body_longer_than_one_segment);
+  RUN_TEST(test_refuses_above_max_connections);
+  return UNITY_END();
+}
@@ -0,0 +1,95 @@
+// Unity-Tests für RouteMetrics (pio test -e native)
+// Handler werden wie in setupRoutes() über wrap() registriert und mit
+// hostHandle() aufgerufen; geprüft wird die Prometheus-Ausgabe.
+#include <unity.h>
+#include "RouteMetrics.h"
+#include "TemplateEngine.h"
+
+static const char kPage[] = "<p>%NAME%</p>";
+
+static AsyncWebServer server(8081);
+static RouteMetrics *metrics;
+static TemplateEngine engine;
+
+static void get(const char *url, size_t chunk = 1436) {
+  AsyncWebServerRequest request(HTTP_GET, url);
+  server.hostHandle(request);
+  request.hostDrain(chunk);
+}
+
+static String scrape(size_t chunk = 1436) {
+  AsyncWebServerRequest request(HTTP_GET, "/metrics");
+  request.send(metrics->beginResponse(&request));
+  return request.hostBody(chunk);
+}
+
+static bool contains(const String &text, const char *line) {
+  return text.indexOf(String(line) + "\n") >= 0;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_counts_requests_errors_and_bytes() {
+  get("/page");
+  get("/page");
+  get("/missing");
+  String text = scrape();
+  TEST_ASSERT_TRUE(contains(text, "http_requests_total{route=\"/page\",method=\"GET\"} 2"));
+  TEST_ASSERT_TRUE(contains(text, "http_request_errors_total{route=\"/page\",method=\"GET\"} 0"));
+  // "<p>Welt</p>" zweimal, gezählt beim Streamen durch den Renderer
+  TEST_ASSERT_TRUE(contains(text, "http_response_bytes_total{route=\"/page\",method=\"GET\"} 22"));
+  TEST_ASSERT_TRUE(contains(text, "http_requests_total{route=\"/missing\",method=\"GET\"} 1"));
+  TEST_ASSERT_TRUE(contains(text, "http_request_errors_total{route=\"/missing\",method=\"GET\"} 1"));
+}
+
+void test_histogram_is_cumulative() {
+  String text = scrape();
+  // jeder Request landet genau einmal, +Inf = _count
+  TEST_ASSERT_TRUE(contains(text, "http_request_duration_seconds_bucket{route=\"/page\",method=\"GET\",le=\"+Inf\"} 2"));
+  TEST_ASSERT_TRUE(contains(text, "http_request_duration_seconds_count{route=\"/page\",method=\"GET\"} 2"));
+  TEST_ASSERT_TRUE(text.indexOf("# TYPE http_request_duration_seconds histogram\n") >= 0);
+  int last = -1;
+  for (size_t b = 0; b < RouteMetrics::kBuckets; b++) {
+    char prefix[128];
+    snprintf(prefix, sizeof(prefix), "http_request_duration_seconds_bucket{route=\"/page\",method=\"GET\",le=\"%g\"} ",
+             RouteMetrics::kBucketUs[b] / 1e6);
+    int pos = text.indexOf(prefix);
+    TEST_ASSERT_TRUE(pos >= 0);
+    int value = atoi(text.c_str() + pos + strlen(prefix));
+    TEST_ASSERT_TRUE(value >= last);
+    last = value;
+  }
+}
+
+void test_heap_gauges() {
+  String text = scrape();
+  TEST_ASSERT_TRUE(text.indexOf("\nesp_free_heap_bytes ") >= 0);
+  TEST_ASSERT_TRUE(text.indexOf("\nesp_min_free_heap_bytes ") >= 0);
+  TEST_ASSERT_TRUE(metrics->minFreeHeap() <= ESP.getFreeHeap());
+}
+
+// Zeilen dürfen über Segmentgrenzen reichen
+void test_output_independent_of_segment_size() {
+  String whole = scrape(1436);
+  TEST_ASSERT_TRUE(whole == scrape(7));
+  TEST_ASSERT_TRUE(whole.endsWith("\n"));
+}
+
+int main() {
+  metrics = new RouteMetrics();
+  engine.begin("_BODY_CONTENT_");
+  server.on("/page", HTTP_GET, metrics->wrap("/page", HTTP_GET, [](AsyncWebServerRequest *request) {
+    request->send(engine.beginResponse(request, engine.page(kPage), {{"NAME", "Welt"}}));
+  }));
+  server.on("/missing", HTTP_GET, metrics->wrap("/missing", HTTP_GET, [](AsyncWebServerRequest *request) {
+    RouteMetrics::current().status(404);
+    request->send(404);
+  }));
+  UNITY_BEGIN();
+  RUN_TEST(test_counts_requests_errors_and_bytes);
+  RUN_TEST(test_histogram_is_cumulative);
+  RUN_TEST(test_heap_gauges);
+  RUN_TEST(test_output_independent_of_segment_size);
+  return UNITY_END();
+}
@@ -0,0 +1,113 @@
+// Unity-Tests für RouteTable (pio test -e native)
+// Ein Dispatcher vorne in der Handler-Kette, dahinter server.on() und
+// onNotFound wie in WebServerClass. Die Handler schreiben ihren Namen in
+// den Body, damit sichtbar ist, wer geantwortet hat.
+#include <unity.h>
+#include <memory>
+#include <vector>
+#include "RouteTable.h"
+
+struct Pages {
+  void home(AsyncWebServerRequest *request)    { request->send(200, "text/plain", "home"); }
+  void counter(AsyncWebServerRequest *request) { request->send(200, "text/plain", "counter"); }
+  void save(AsyncWebServerRequest *request)    { request->send(200, "text/plain", "save"); }
+  void page(AsyncWebServerRequest *request)    { request->send(200, "text/html", "page"); }
+};
+
+static constexpr RouteTable::Route<Pages> kRoutes[] = {
+  {"/",            HTTP_GET,             AdmissionControl::CHEAP,     &Pages::home},
+  {"/counter",     HTTP_GET,             AdmissionControl::CHEAP,     &Pages::counter},
+  {"/save",        HTTP_GET | HTTP_POST, AdmissionControl::CHEAP,     &Pages::save},
+  {"/page",        HTTP_GET,             AdmissionControl::EXPENSIVE, &Pages::page},
+};
+static constexpr auto kIndex = RouteTable::index(kRoutes);
+
+// jeder Pfad landet schon beim Übersetzen in seinem eigenen Slot
+template <size_t I>
+constexpr bool placed() {
+  return kIndex.slots[kIndex.slot(RouteTable::hash(kRoutes[I].path, RouteTable::length(kRoutes[I].path)))] == I + 1;
+}
+static_assert(placed<0>() && placed<1>() && placed<2>() && placed<3>(), "Pfad ohne eigenen Slot");
+
+static AsyncWebServer server(8084);
+static Pages pages;
+static RouteMetrics *metrics;
+static AdmissionControl admission;
+static RouteTable::Dispatcher<Pages> routes;
+
+typedef std::unique_ptr<AsyncWebServerRequest> RequestPtr;
+
+static RequestPtr request(WebRequestMethod method, const char *url) {
+  RequestPtr request(new AsyncWebServerRequest(method, url));
+  server.hostHandle(*request);
+  return request;
+}
+
+static String body(WebRequestMethod method, const char *url) {
+  return request(method, url)->hostBody();
+}
+
+void setUp() {
+  admission.setLimits(AdmissionControl::Limits());
+  NativeHost::heapUsed = 0;
+}
+void tearDown() { NativeHost::heapUsed = 0; }
+
+void test_table_routes_match_exact_path() {
+  TEST_ASSERT_EQUAL_STRING("home", body(HTTP_GET, "/").c_str());
+  TEST_ASSERT_EQUAL_STRING("counter", body(HTTP_GET, "/counter").c_str());
+  TEST_ASSERT_EQUAL_STRING("save", body(HTTP_POST, "/save").c_str());
+  TEST_ASSERT_EQUAL_STRING("save", body(HTTP_GET, "/save").c_str());
+  // Präfixe und Unterpfade gehören nicht zur Tabelle
+  TEST_ASSERT_EQUAL_STRING("404", body(HTTP_GET, "/count").c_str());
+  TEST_ASSERT_EQUAL_STRING("404", body(HTTP_GET, "/counter/x").c_str());
+}
+
+void test_misses_fall_through_to_chain() {
+  // anderer Pfad: server.on() hinter dem Dispatcher
+  TEST_ASSERT_EQUAL_STRING("dynamic", body(HTTP_GET, "/dynamic").c_str());
+  // Pfad bekannt, Methode nicht: ebenfalls weiter in der Kette
+  TEST_ASSERT_EQUAL_STRING("chain", body(HTTP_POST, "/counter").c_str());
+  TEST_ASSERT_EQUAL_STRING("404", body(HTTP_DELETE, "/").c_str());
+}
+
+void test_metrics_per_table_route() {
+  size_t first = metrics->routes() - 4;
+  TEST_ASSERT_EQUAL_STRING("/counter", metrics->route(first + 1).uri);
+  uint32_t before = metrics->route(first + 1).requests.load();
+  body(HTTP_GET, "/counter");
+  body(HTTP_GET, "/counter");
+  TEST_ASSERT_EQUAL_UINT32(before + 2, metrics->route(first + 1).requests.load());
+  TEST_ASSERT_EQUAL_UINT32(0, RouteMetrics::inFlight());
+}
+
+void test_expensive_routes_go_through_admission() {
+  NativeHost::heapUsed = NativeHost::kHeapSize - 16 * 1024;
+  TEST_ASSERT_EQUAL(503, request(HTTP_GET, "/page")->hostResponse()->code());
+  TEST_ASSERT_EQUAL_STRING("counter", body(HTTP_GET, "/counter").c_str());
+  NativeHost::heapUsed = 0;
+  TEST_ASSERT_EQUAL_STRING("page", body(HTTP_GET, "/page").c_str());
+}
+
+int main() {
+  metrics = new RouteMetrics();
+  routes.install(&pages, kRoutes, kIndex)
+        .metrics(metrics, sizeof(kRoutes) / sizeof(kRoutes[0]))
+        .admission(&admission);
+  server.addHandler(&routes);
+  server.on("/dynamic", HTTP_GET, [](AsyncWebServerRequest *request) {
+    request->send(200, "text/plain", "dynamic");
+  });
+  server.on("/counter", HTTP_POST, [](AsyncWebServerRequest *request) {
+    request->send(200, "text/plain", "chain");
+  });
+  server.onNotFound([](AsyncWebServerRequest *request) {
+    request->send(404, "text/plain", "404");
+  });
+  UNITY_BEGIN();
+  RUN_TEST(test_table_routes_match_exact_path);
+  RUN_TEST(test_misses_fall_through_to_chain);
+  RUN_TEST(test_metrics_per_table_route);
+  RUN_TEST(test_expensive_routes_go_through_admission);
+  return UNITY_END();
+}
@@ -0,0 +1,104 @@
+// Unity-Tests für StatusSnapshot (pio test -e native)
+// Ein Erzeuger wie loop(), Leser wie die /status.json-Requests im
+// AsyncTCP-Task; geprüft werden Umschalten, gehaltene Puffer und dass ein
+// Leser nie einen halb geschriebenen Puffer sieht.
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include "StatusSnapshot.h"
+
+static bool publish(StatusSnapshot &status, const char *text) {
+  char *buffer = status.begin();
+  if (!buffer) return false;
+  size_t len = strlen(text);
+  memcpy(buffer, text, len);
+  status.commit(len);
+  return true;
+}
+
+static String body(StatusSnapshot &status, size_t chunk = 1436) {
+  AsyncWebServerRequest request(HTTP_GET, "/status.json");
+  request.send(status.beginResponse(&request));
+  return request.hostBody(chunk);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_unavailable_before_first_commit() {
+  StatusSnapshot status;
+  TEST_ASSERT_FALSE((bool)status.acquire());
+  AsyncWebServerRequest request(HTTP_GET, "/status.json");
+  request.send(status.beginResponse(&request));
+  TEST_ASSERT_EQUAL(503, request.hostResponse()->code());
+}
+
+void test_serves_latest_commit() {
+  StatusSnapshot status;
+  TEST_ASSERT_TRUE(publish(status, "{\"counter\":1}"));
+  TEST_ASSERT_TRUE(publish(status, "{\"counter\":2}"));
+  TEST_ASSERT_EQUAL_UINT32(2, status.version());
+  TEST_ASSERT_EQUAL_STRING("{\"counter\":2}", body(status).c_str());
+  TEST_ASSERT_EQUAL_STRING("{\"counter\":2}", body(status, 3).c_str());
+}
+
+// Ein laufender Leser blockiert nur den Puffer, den er hält
+void test_held_buffer_is_not_overwritten() {
+  StatusSnapshot status;
+  publish(status, "{\"a\":1}");
+  StatusSnapshot::Lease held = status.acquire();
+  TEST_ASSERT_TRUE(publish(status, "{\"a\":2}"));     // anderer Puffer
+  TEST_ASSERT_FALSE(publish(status, "{\"a\":3}"));    // wäre der gehaltene
+  TEST_ASSERT_EQUAL_UINT32(1, status.stats().skipped);
+  TEST_ASSERT_EQUAL_STRING_LEN("{\"a\":1}", held.data(), held.length());
+
+  StatusSnapshot::Lease copy = held;
+  held = StatusSnapshot::Lease();
+  TEST_ASSERT_FALSE(publish(status, "{\"a\":3}"));    // Kopie hält noch
+  copy = StatusSnapshot::Lease();
+  TEST_ASSERT_TRUE(publish(status, "{\"a\":3}"));
+  TEST_ASSERT_EQUAL_STRING("{\"a\":3}", body(status).c_str());
+}
+
+// Erzeuger füllt jeden Stand mit einer anderen Ziffer als den vorigen, ein
+// überschriebener Puffer enthält also gemischte Ziffern
+void test_readers_never_see_partial_buffers() {
+  StatusSnapshot status;
+  publish(status, "1111111111");     // Version 1
+  std::atomic<bool> stop{false};
+  std::thread producer([&] {
+    for (uint32_t i = 1; i < 200000 && !stop; i++) {
+      char *buffer = status.begin();
+      if (!buffer) continue;
+      size_t len = 10 + i % 100;
+      memset(buffer, '0' + (status.version() + 1) % 10, len);
+      status.commit(len);
+    }
+  });
+  uint32_t checked = 0;
+  for (int i = 0; i < 100000; i++) {
+    StatusSnapshot::Lease lease = status.acquire();
+    char expected = lease.data()[0];
+    for (size_t k = 0; k < lease.length(); k++) {
+      if (lease.data()[k] != expected) {
+        stop = true;
+        producer.join();
+        TEST_FAIL_MESSAGE("Puffer während des Lesens überschrieben");
+      }
+    }
+    checked++;
+  }
+  stop = true;
+  producer.join();
+  TEST_ASSERT_EQUAL_UINT32(100000, checked);
+  TEST_ASSERT_TRUE(status.stats().commits > 1);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_unavailable_before_first_commit);
+  RUN_TEST(test_serves_latest_commit);
+  RUN_TEST(test_held_buffer_is_not_overwritten);
+  RUN_TEST(test_readers_never_see_partial_buffers);
+  return UNITY_END();
+}
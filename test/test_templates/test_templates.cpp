@@ -0,0 +1,137 @@
+// Unity-Tests für TemplateEngine, StaticPage und PageCache (pio test -e native)
+// Vergleich mit dem früheren sendDynamicPage (String::replace auf der ganzen Seite).
+#include <unity.h>
+#include <SPIFFS.h>
+#include "TemplateEngine.h"
+#include "PageCache.h"
+#include "static_pages.h"
+
+static TemplateEngine engine;
+
+static String legacyRender(const char *content, const std::map<String, String> &values) {
+  String output = html_template;
+  output.replace("_BODY_CONTENT_", content);
+  for (auto const &pair : values) {
+    output.replace("%" + pair.first + "%", pair.second);
+  }
+  return output;
+}
+
+static String render(AsyncWebServerResponse *response, size_t chunk = 1436) {
+  AsyncWebServerRequest request(HTTP_GET, "/");
+  request.send(response);
+  return request.hostBody(chunk);
+}
+
+void setUp() {
+  SPIFFS.hostClear();
+  SPIFFS.hostStats() = {};
+  engine.clear();
+}
+
+void tearDown() {}
+
+void test_page_matches_legacy_replace() {
+  std::map<String, String> values = {
+    {"EEPROM_TEXT", "Hallo"}, {"COUNTER_VALUE", "17"}, {"SET_COUNTER", "0"}, {"CUR_COUNTER", "17"}
+  };
+  AsyncWebServerRequest request(HTTP_GET, "/status");
+  String expected = legacyRender(status_content, values);
+  for (size_t chunk : {1, 7, 64, 1436}) {
+    String body = render(engine.beginResponse(&request, engine.page(status_content), values), chunk);
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), body.c_str());
+  }
+}
+
+void test_unset_placeholder_stays() {
+  AsyncWebServerRequest request(HTTP_GET, "/status");
+  String body = render(engine.beginResponse(&request, engine.page(status_content), {}));
+  TEST_ASSERT_EQUAL_STRING(legacyRender(status_content, {}).c_str(), body.c_str());
+  TEST_ASSERT_TRUE(body.indexOf("%CUR_COUNTER%") >= 0);
+}
+
+// Datei über kMaxCachedFileSize: gestreamt, Platzhalter liegen auf Blockgrenzen.
+// Blöcke kleiner als kMaxPlaceholder (+8 Byte Chunk-Rahmen) sind nicht vorgesehen.
+void test_streamed_file_across_chunks() {
+  std::string big;
+  while (big.size() < TemplateEngine::kMaxCachedFileSize * 2) big += "<p>%A% und %LONG_NAME% 100% sicher</p>\n";
+  SPIFFS.hostPut("/big.html", big);
+  std::map<String, String> values = {{"A", "x"}, {"LONG_NAME", "wert"}};
+  String expected = legacyRender(big.c_str(), values);
+
+  TEST_ASSERT_TRUE(engine.file(SPIFFS, "/big.html") == nullptr);
+  AsyncWebServerRequest request(HTTP_GET, "/big");
+  for (size_t chunk : {40, 45, 77, 512, 1436}) {
+    String body = render(engine.beginFileResponse(&request, SPIFFS, "/big.html", values), chunk);
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), body.c_str());
+  }
+}
+
+void test_small_file_is_read_once() {
+  SPIFFS.hostPut("/small.html", "<p>%X%</p>");
+  AsyncWebServerRequest request(HTTP_GET, "/small");
+  for (int i = 0; i < 5; i++) {
+    String body = render(engine.beginResponse(&request, engine.file(SPIFFS, "/small.html"), {{"X", String(i)}}));
+    TEST_ASSERT_EQUAL_STRING(legacyRender("<p>%X%</p>", {{"X", String(i)}}).c_str(), body.c_str());
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, SPIFFS.hostStats().opens);
+}
+
+void test_static_page_equals_engine() {
+  StatusPage::Values values;
+  values.set(StatusSlot::EEPROM_TEXT, "Text");
+  values.set(StatusSlot::COUNTER_VALUE, "3");
+  values.set(StatusSlot::SET_COUNTER, "0");
+  values.set(StatusSlot::CUR_COUNTER, "3");
+  std::map<String, String> map = {
+    {"EEPROM_TEXT", "Text"}, {"COUNTER_VALUE", "3"}, {"SET_COUNTER", "0"}, {"CUR_COUNTER", "3"}
+  };
+  AsyncWebServerRequest request(HTTP_GET, "/status");
+  String fromStatic = render(StatusPage::beginResponse(&request, std::move(values)), 100);
+  String fromEngine = render(engine.beginResponse(&request, engine.page(status_content), map), 100);
+  TEST_ASSERT_EQUAL_STRING(fromEngine.c_str(), fromStatic.c_str());
+}
+
+void test_page_cache_hits_and_holes() {
+  PageCache cache;
+  uint32_t volatileMask = PageCache::slotMask({(int)StatusSlot::COUNTER_VALUE, (int)StatusSlot::CUR_COUNTER});
+  AsyncWebServerRequest request(HTTP_GET, "/status");
+
+  for (int i = 0; i < 3; i++) {
+    StatusPage::Values values;
+    values.set(StatusSlot::EEPROM_TEXT, "fest");
+    values.set(StatusSlot::COUNTER_VALUE, String(i));
+    values.set(StatusSlot::SET_COUNTER, "0");
+    values.set(StatusSlot::CUR_COUNTER, String(i));
+    auto entry = cache.fetch("/status", StatusPage::kTable.items, StatusPage::kSegments,
+                             StatusPage::Values::kCount, values, volatileMask);
+    String expected = render(StatusPage::beginResponse(&request, values));
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), render(PageCache::beginResponse(&request, entry, values)).c_str());
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, cache.stats().misses);
+  TEST_ASSERT_EQUAL_UINT32(2, cache.stats().hits);
+
+  // stabiler Slot geändert -> neuer Schlüssel
+  StatusPage::Values values;
+  values.set(StatusSlot::EEPROM_TEXT, "neu");
+  cache.fetch("/status", StatusPage::kTable.items, StatusPage::kSegments,
+              StatusPage::Values::kCount, values, volatileMask);
+  TEST_ASSERT_EQUAL_UINT32(2, cache.stats().misses);
+
+  cache.invalidate("/status");
+  cache.fetch("/status", StatusPage::kTable.items, StatusPage::kSegments,
+              StatusPage::Values::kCount, values, volatileMask);
+  TEST_ASSERT_EQUAL_UINT32(3, cache.stats().misses);
+}
+
+int main() {
+  engine.begin(html_template);
+  UNITY_BEGIN();
+  RUN_TEST(test_page_matches_legacy_replace);
+  RUN_TEST(test_unset_placeholder_stays);
+  RUN_TEST(test_streamed_file_across_chunks);
+  RUN_TEST(test_small_file_is_read_once);
+  RUN_TEST(test_static_page_equals_engine);
+  RUN_TEST(test_page_cache_hits_and_holes);
+  return UNITY_END();
+}
@@ -0,0 +1,133 @@
+// Unity-Tests für TraceBuffer (pio test -e native, mit -DWEB_TRACE)
+// Schreiber aus mehreren Threads stehen für AsyncTCP-Task und loop();
+// geprüft werden vollständige Einträge, Überlauf und das JSON von /trace.
+#include <unity.h>
+
+#ifdef WEB_TRACE
+
+#include <thread>
+#include <vector>
+#include "RouteMetrics.h"
+#include "TemplateEngine.h"
+
+static const char kPage[] = "<p>%NAME%</p>";
+
+static AsyncWebServer server(8082);
+static RouteMetrics *metrics;
+static TemplateEngine engine;
+
+static String dump(size_t chunk = 1436) {
+  AsyncWebServerRequest request(HTTP_GET, "/trace");
+  request.send(TraceBuffer::beginResponse(&request));
+  return request.hostBody(chunk);
+}
+
+static size_t count(const String &text, const char *needle) {
+  size_t n = 0;
+  for (int pos = text.indexOf(needle); pos >= 0; pos = text.indexOf(needle, pos + 1)) n++;
+  return n;
+}
+
+void setUp() { TraceBuffer::clear(); }
+void tearDown() {}
+
+void test_request_spans_share_one_track() {
+  AsyncWebServerRequest request(HTTP_GET, "/page");
+  server.hostHandle(request);
+  request.hostDrain(1436);
+  // Handler und Rendern liegen fertig vor, "request"/"send_done" erst nach dem Schließen
+  String text = dump();
+  TEST_ASSERT_EQUAL(1, count(text, "\"name\":\"handler\""));
+  TEST_ASSERT_EQUAL(1, count(text, "\"name\":\"send_queued\""));
+  TEST_ASSERT_TRUE(count(text, "\"name\":\"render\"") >= 1);
+
+  TraceBuffer::Event e;
+  uint32_t id = 0;
+  for (uint32_t i = TraceBuffer::first(); i < TraceBuffer::end(); i++) {
+    TEST_ASSERT_TRUE(TraceBuffer::read(i, e));
+    if (e.span == TraceBuffer::HANDLER) id = e.id;
+  }
+  for (uint32_t i = TraceBuffer::first(); i < TraceBuffer::end(); i++) {
+    TraceBuffer::read(i, e);
+    TEST_ASSERT_EQUAL_UINT32(id, e.id);
+  }
+}
+
+void test_json_shape() {
+  TraceBuffer::complete(TraceBuffer::RENDER, micros(), 7, "/x", 42);
+  TraceBuffer::instant(TraceBuffer::SEND_DONE, 7, "/x");
+  String text = dump();
+  TEST_ASSERT_TRUE(text.startsWith("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"));
+  TEST_ASSERT_TRUE(text.endsWith("\n]}\n"));
+  TEST_ASSERT_TRUE(text.indexOf("\"name\":\"render\",\"ph\":\"X\"") >= 0);
+  TEST_ASSERT_TRUE(text.indexOf("\"tid\":7,\"args\":{\"arg\":\"/x\",\"n\":42}") >= 0);
+  TEST_ASSERT_TRUE(text.indexOf("\"name\":\"send_done\",\"ph\":\"i\"") >= 0);
+  // Zeilen dürfen über Segmentgrenzen reichen
+  TEST_ASSERT_TRUE(text == dump(5));
+}
+
+void test_wraparound_keeps_newest() {
+  for (uint32_t i = 0; i < TraceBuffer::kEvents + 10; i++) {
+    TraceBuffer::instant(TraceBuffer::WS_PUBLISH, 0, nullptr, i);
+  }
+  TEST_ASSERT_EQUAL_UINT32(10, TraceBuffer::first());
+  TraceBuffer::Event e;
+  TEST_ASSERT_FALSE(TraceBuffer::read(9, e));
+  TEST_ASSERT_TRUE(TraceBuffer::read(10, e));
+  TEST_ASSERT_EQUAL_UINT32(10, e.n);
+  TEST_ASSERT_EQUAL(TraceBuffer::kEvents, count(dump(), "\"name\":\"ws_publish\""));
+}
+
+// Jeder gelesene Eintrag muss aus genau einem Schreibvorgang stammen
+void test_concurrent_writers() {
+  const uint32_t kThreads = 4, kPerThread = 20000;
+  std::vector<std::thread> writers;
+  for (uint32_t t = 1; t <= kThreads; t++) {
+    writers.emplace_back([t] {
+      for (uint32_t i = 0; i < kPerThread; i++) {
+        TraceBuffer::complete(TraceBuffer::RENDER, t * 1000, t, nullptr, t * 1000000 + i);
+      }
+    });
+  }
+  size_t seen = 0;
+  TraceBuffer::Event e;
+  while (TraceBuffer::end() < kThreads * kPerThread) {
+    uint32_t from = TraceBuffer::first(), to = TraceBuffer::end();
+    for (uint32_t i = from; i < to; i++) {
+      if (!TraceBuffer::read(i, e)) continue;
+      TEST_ASSERT_EQUAL_UINT32(e.id, e.n / 1000000);
+      TEST_ASSERT_EQUAL_UINT32(e.id * 1000, e.ts);
+      seen++;
+    }
+  }
+  for (auto &w : writers) w.join();
+  TEST_ASSERT_EQUAL_UINT32(kThreads * kPerThread, TraceBuffer::end());
+  for (uint32_t i = TraceBuffer::first(); i < TraceBuffer::end(); i++) {
+    TEST_ASSERT_TRUE(TraceBuffer::read(i, e));
+  }
+  TEST_ASSERT_TRUE(seen > 0);
+}
+
+int main() {
+  metrics = new RouteMetrics();
+  engine.begin("_BODY_CONTENT_");
+  server.on("/page", HTTP_GET, metrics->wrap("/page", HTTP_GET, [](AsyncWebServerRequest *request) {
+    request->send(engine.beginResponse(request, engine.page(kPage), {{"NAME", "Welt"}}));
+  }));
+  UNITY_BEGIN();
+  RUN_TEST(test_request_spans_share_one_track);
+  RUN_TEST(test_json_shape);
+  RUN_TEST(test_wraparound_keeps_newest);
+  RUN_TEST(test_concurrent_writers);
+  return UNITY_END();
+}
+
+#else
+
+// ohne -DWEB_TRACE gibt es nichts zu prüfen
+int main() {
+  UNITY_BEGIN();
+  return UNITY_END();
+}
+
+#endif
@@ -0,0 +1,163 @@
+// Unity-Tests für den WifiManager-Zustandsautomaten (pio test -e native)
+// Simulierter Treiber mit einstellbarer Verbindungsdauer, dazu EspWifiDriver auf
+// dem WiFi-Stand-in (lib/NativeHost).
+#include <unity.h>
+#include "WifiManager.h"
+#include "EspWifiDriver.h"
+
+class SimDriver : public WifiDriver {
+public:
+  // Verbindet connectDelayMs nach connectSta(), sofern reachable
+  bool reachable = false;
+  uint32_t connectDelayMs = 300;
+  uint8_t stations = 0;
+  uint32_t connects = 0;
+  bool ap = false;
+
+  void connectSta(const String &, const String &) override { connects++; _pendingAt = _now + connectDelayMs; _pending = true; }
+  void disconnectSta() override { _pending = false; _connected = false; }
+  bool staConnected() override { return _connected; }
+  void startAp() override { ap = true; }
+  void stopAp() override { ap = false; }
+  uint8_t apStations() override { return stations; }
+
+  void drop() {
+    _connected = false;
+    _manager->notify(WifiManager::EV_DISCONNECTED);
+  }
+  void attach(WifiManager &m) { _manager = &m; }
+
+  // Zeit vorstellen und dabei Ereignisse auslösen wie der WiFi-Event-Task
+  void step(uint32_t now) {
+    _now = now;
+    if (_pending && now >= _pendingAt) {
+      _pending = false;
+      if (reachable) {
+        _connected = true;
+        _manager->notify(WifiManager::EV_GOT_IP);
+      } else {
+        _manager->notify(WifiManager::EV_DISCONNECTED);
+      }
+    }
+  }
+
+private:
+  WifiManager *_manager = nullptr;
+  uint32_t _now = 0;
+  uint32_t _pendingAt = 0;
+  bool _pending = false;
+  bool _connected = false;
+};
+
+static void run(SimDriver &driver, WifiManager &wifi, uint32_t &now, uint32_t until) {
+  for (; now < until; now += 10) {
+    driver.step(now);
+    wifi.loop(now);
+  }
+}
+
+void test_connects_without_ap() {
+  SimDriver driver;
+  WifiManager wifi(driver);
+  driver.attach(wifi);
+  driver.reachable = true;
+  uint32_t now = 0;
+  wifi.begin("netz", "geheim", now);
+  TEST_ASSERT_TRUE(wifi.state() == WifiManager::State::CONNECTING);
+  run(driver, wifi, now, 1000);
+  TEST_ASSERT_TRUE(wifi.state() == WifiManager::State::CONNECTED);
+  TEST_ASSERT_FALSE(driver.ap);
+  TEST_ASSERT_EQUAL_UINT32(300, wifi.stats().lastConnectMs);
+}
+
+void test_backoff_grows_and_ap_starts() {
+  SimDriver driver;
+  WifiManager wifi(driver);
+  driver.attach(wifi);
+  uint32_t now = 0;
+  wifi.begin("netz", "geheim", now);
+  run(driver, wifi, now, 400);
+  TEST_ASSERT_TRUE(wifi.state() == WifiManager::State::BACKOFF);
+  TEST_ASSERT_TRUE(driver.ap);
+  TEST_ASSERT_EQUAL_UINT32(WifiManager::kBackoffBaseMs, wifi.backoffMs());
+
+  run(driver, wifi, now, 200000);
+  TEST_ASSERT_EQUAL_UINT32(WifiManager::kBackoffMaxMs, wifi.backoffMs());
+  TEST_ASSERT_TRUE(wifi.stats().attempts >= 6);
+  TEST_ASSERT_EQUAL_UINT32(wifi.stats().attempts, driver.connects);
+
+  // Netz wieder da: verbunden, AP bleibt bis kApLingerMs und solange Geräte daran hängen
+  driver.reachable = true;
+  driver.stations = 1;
+  run(driver, wifi, now, now + WifiManager::kBackoffMaxMs + 1000);
+  TEST_ASSERT_TRUE(wifi.state() == WifiManager::State::CONNECTED);
+  run(driver, wifi, now, now + WifiManager::kApLingerMs + 100);
+  TEST_ASSERT_TRUE(driver.ap);
+  driver.stations = 0;
+  run(driver, wifi, now, now + 100);
+  TEST_ASSERT_FALSE(driver.ap);
+}
+
+void test_drop_retries_quickly() {
+  SimDriver driver;
+  WifiManager wifi(driver);
+  driver.attach(wifi);
+  driver.reachable = true;
+  uint32_t now = 0;
+  wifi.begin("netz", "geheim", now);
+  run(driver, wifi, now, 1000);
+  driver.drop();
+  run(driver, wifi, now, 1010);
+  TEST_ASSERT_TRUE(wifi.state() == WifiManager::State::BACKOFF);
+  TEST_ASSERT_EQUAL_UINT32(WifiManager::kRetryDelayMs, wifi.backoffMs());
+  run(driver, wifi, now, 1000 + WifiManager::kRetryDelayMs + 400);
+  TEST_ASSERT_TRUE(wifi.state() == WifiManager::State::CONNECTED);
+  TEST_ASSERT_EQUAL_UINT32(1, wifi.stats().drops);
+}
+
+void test_no_credentials_ap_only() {
+  SimDriver driver;
+  WifiManager wifi(driver);
+  driver.attach(wifi);
+  uint32_t now = 0;
+  wifi.begin("", "", now);
+  run(driver, wifi, now, 60000);
+  TEST_ASSERT_TRUE(wifi.state() == WifiManager::State::AP_ONLY);
+  TEST_ASSERT_TRUE(driver.ap);
+  TEST_ASSERT_EQUAL_UINT32(0, driver.connects);
+}
+
+// EspWifiDriver über das WiFi-Stand-in: Ereignisse laufen über WiFi.onEvent()
+void test_esp_driver_on_host_wifi() {
+  EspWifiDriver driver;
+  WifiManager wifi(driver);
+  driver.configureAp("ESP32-Setup", "admin", IPAddress(192, 168, 10, 1),
+                     IPAddress(192, 168, 10, 1), IPAddress(255, 255, 255, 0));
+  driver.attach(wifi);
+
+  WiFi.hostSetReachable(false);
+  wifi.begin("netz", "geheim", 0);
+  wifi.loop(10);
+  TEST_ASSERT_TRUE(wifi.state() == WifiManager::State::BACKOFF);
+  TEST_ASSERT_TRUE(WiFi.getMode() & WIFI_AP);
+
+  WiFi.hostSetReachable(true);
+  wifi.loop(10 + WifiManager::kBackoffBaseMs);
+  wifi.loop(20 + WifiManager::kBackoffBaseMs);
+  TEST_ASSERT_TRUE(wifi.state() == WifiManager::State::CONNECTED);
+
+  WiFi.hostDrop();
+  wifi.loop(30 + WifiManager::kBackoffBaseMs);
+  TEST_ASSERT_EQUAL_UINT32(1, wifi.stats().drops);
+}
+
+int main() {
+  Serial.setOutput(nullptr);
+  UNITY_BEGIN();
+  RUN_TEST(test_connects_without_ap);
+  RUN_TEST(test_backoff_grows_and_ap_starts);
+  RUN_TEST(test_drop_retries_quickly);
+  RUN_TEST(test_no_credentials_ap_only);
+  RUN_TEST(test_esp_driver_on_host_wifi);
+  return UNITY_END();
+}
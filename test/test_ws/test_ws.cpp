@@ -0,0 +1,237 @@
+// Unity-Tests für WsFanout/StateChannel, WsReassembler und JsonPoolAllocator (pio test -e native)
+// Clients und Frames kommen aus den AsyncWebSocket-Stand-ins (lib/NativeHost).
+#include <unity.h>
+#include <random>
+#include <vector>
+#include "StateChannel.h"
+#include "WsReassembler.h"
+#include "JsonPoolAllocator.h"
+
+static AsyncWebSocketClient* findClient(AsyncWebSocket &ws, uint32_t id) {
+  for (auto *c : ws.getClients()) {
+    if (c->id() == id) return c;
+  }
+  return nullptr;
+}
+
+// 8 Clients, einer liest nicht mehr: seine Queue bleibt begrenzt, die anderen
+// bekommen jedes Delta, und nach kEvictAfterMs wird er getrennt.
+void test_fanout_stalled_client_is_bounded() {
+  AsyncWebSocket ws("/ws");
+  WsFanout fanout(ws);
+  StateChannel state(fanout);
+  for (int i = 0; i < 8; i++) ws.hostConnect();
+  const uint32_t stalledId = ws.getClients()[3]->id();
+  ws.getClients()[3]->hostStall(true);
+
+  size_t maxStalledQueue = 0;
+  for (int32_t i = 1; i <= 100; i++) {
+    NativeHost::advanceMillis(100);
+    state.set(StateChannel::COUNTER, i);
+    state.publish();
+    // nach der Trennung räumt cleanupClients() den Client weg
+    if (AsyncWebSocketClient *stalled = findClient(ws, stalledId)) {
+      maxStalledQueue = std::max(maxStalledQueue, stalled->queueLen());
+    }
+    ws.hostDrainAll();
+  }
+
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(WsFanout::kMaxQueue, maxStalledQueue);
+  TEST_ASSERT_EQUAL_UINT32(1, fanout.stats().evictions);
+  TEST_ASSERT_TRUE(fanout.stats().dropped > 0);
+  TEST_ASSERT_NULL(findClient(ws, stalledId));
+  TEST_ASSERT_EQUAL_UINT32(7, ws.count());
+  for (auto *c : ws.getClients()) {
+    // erster Stand als Snapshot, dann 99 Deltas; keine Kopien pro Client
+    TEST_ASSERT_EQUAL_UINT32(100, c->hostFramesSent());
+    TEST_ASSERT_EQUAL_UINT32(0, c->hostQueuedBytes());
+  }
+}
+
+void test_fanout_snapshot_after_recovery() {
+  AsyncWebSocket ws("/ws");
+  WsFanout fanout(ws);
+  StateChannel state(fanout);
+  AsyncWebSocketClient *slow = ws.hostConnect();
+  AsyncWebSocketClient *fast = ws.hostConnect();
+
+  slow->hostStall(true);
+  for (int32_t i = 1; i <= 10; i++) {
+    NativeHost::advanceMillis(10);
+    state.set(StateChannel::COUNTER, i);
+    state.publish();
+    fast->hostDrain();
+  }
+  slow->hostStall(false);
+  slow->hostDrain();
+  uint32_t before = slow->hostFramesSent();
+  NativeHost::advanceMillis(10);
+  state.publish();
+  // genau ein Snapshot statt der verpassten Deltas
+  TEST_ASSERT_EQUAL_UINT32(1, slow->queueLen());
+  slow->hostDrain();
+  TEST_ASSERT_EQUAL_UINT32(before + 1, slow->hostFramesSent());
+}
+
+// publish() zählt Felder unabhängig vom Format: nur Binär-Clients verbunden
+void test_publish_counts_fields_for_binary_clients() {
+  AsyncWebSocket ws("/ws");
+  WsFanout fanout(ws);
+  StateChannel state(fanout);
+  state.set(StateChannel::LED, 1);
+  state.set(StateChannel::COUNTER, 5);
+  TEST_ASSERT_EQUAL(0, state.publish());     // niemand verbunden
+
+  AsyncWebServerRequest upgrade(HTTP_GET, "/ws");
+  upgrade.hostHeader("Sec-WebSocket-Protocol", WsProtocol::kSubprotocol);
+  AsyncWebSocketClient *client = ws.hostConnect(&upgrade);
+  TEST_ASSERT_EQUAL(2, state.publish());     // Snapshot an den neuen Client
+  client->hostDrain();
+  state.set(StateChannel::COUNTER, 6);
+  TEST_ASSERT_EQUAL(1, state.publish());     // Delta
+  client->hostDrain();
+  TEST_ASSERT_EQUAL_UINT32(2, client->hostFramesSent());
+}
+
+static AwsFrameInfo frame(uint32_t num, uint8_t opcode, uint8_t messageOpcode, bool final,
+                          uint64_t len, uint64_t index) {
+  AwsFrameInfo info = {};
+  info.num = num;
+  info.opcode = opcode;
+  info.message_opcode = messageOpcode;
+  info.final = final;
+  info.len = len;
+  info.index = index;
+  return info;
+}
+
+// Nachricht in zufällige Frames und jeden Frame in zufällige Events zerlegen
+struct Event {
+  uint32_t client;
+  AwsFrameInfo info;
+  std::vector<uint8_t> data;
+};
+
+static void split(uint32_t client, const std::vector<uint8_t> &msg, std::mt19937 &rng, std::vector<Event> &out) {
+  size_t frames = 1 + rng() % 4;
+  size_t pos = 0;
+  for (size_t f = 0; f < frames; f++) {
+    size_t left = msg.size() - pos;
+    size_t flen = f + 1 == frames ? left : rng() % (left + 1);
+    size_t index = 0;
+    do {
+      size_t part = flen - index == 0 ? 0 : 1 + rng() % (flen - index);
+      AwsFrameInfo info = frame(f, f == 0 ? WS_TEXT : WS_CONTINUATION, WS_TEXT, f + 1 == frames, flen, index);
+      out.push_back({client, info, std::vector<uint8_t>(msg.begin() + pos + index, msg.begin() + pos + index + part)});
+      index += part;
+    } while (index < flen);
+    pos += flen;
+  }
+}
+
+void test_reassembler_fuzz_interleaved_clients() {
+  std::mt19937 rng(1234);
+  WsReassembler rx;
+  for (int round = 0; round < 500; round++) {
+    const uint32_t clients = 1 + rng() % WsReassembler::kSlots;
+    std::vector<std::vector<uint8_t>> msgs(clients);
+    std::vector<std::vector<Event>> perClient(clients);
+    for (uint32_t c = 0; c < clients; c++) {
+      msgs[c].resize(1 + rng() % WsReassembler::kMaxMessage);
+      for (auto &b : msgs[c]) b = (uint8_t)rng();
+      split(c + 1, msgs[c], rng, perClient[c]);
+    }
+    // Events der Clients zufällig verschränken, Reihenfolge pro Client bleibt
+    std::vector<size_t> next(clients, 0);
+    size_t remaining = 0;
+    for (auto &v : perClient) remaining += v.size();
+    std::vector<bool> done(clients, false);
+    while (remaining) {
+      uint32_t c = rng() % clients;
+      if (next[c] >= perClient[c].size()) continue;
+      const Event &e = perClient[c][next[c]++];
+      remaining--;
+      size_t len = 0;
+      uint8_t opcode = 0;
+      // leere Frames: AsyncTCP liefert trotzdem einen Zeiger in das Paket
+      const uint8_t *data = e.data.empty() ? msgs[c].data() : e.data.data();
+      const uint8_t *msg = rx.feed(e.client, e.info, data, e.data.size(), len, opcode);
+      if (msg) {
+        TEST_ASSERT_FALSE(done[c]);
+        TEST_ASSERT_EQUAL_UINT32(msgs[c].size(), len);
+        TEST_ASSERT_EQUAL_MEMORY(msgs[c].data(), msg, len);
+        TEST_ASSERT_EQUAL_UINT8(WS_TEXT, opcode);
+        done[c] = true;
+      }
+    }
+    for (uint32_t c = 0; c < clients; c++) TEST_ASSERT_TRUE(done[c]);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, rx.stats().protocol);
+  TEST_ASSERT_EQUAL_UINT32(0, rx.stats().noSlot);
+}
+
+// Gekürzte, doppelte und zu große Teile: nichts wird ausgeliefert, der Slot wird frei
+void test_reassembler_rejects_broken_sequences() {
+  WsReassembler rx;
+  uint8_t data[300] = {};
+  size_t len = 0;
+  uint8_t opcode = 0;
+
+  // Lücke: zweites Event beginnt nicht am Ende des ersten
+  TEST_ASSERT_NULL(rx.feed(1, frame(0, WS_TEXT, WS_TEXT, true, 20, 0), data, 5, len, opcode));
+  TEST_ASSERT_NULL(rx.feed(1, frame(0, WS_TEXT, WS_TEXT, true, 20, 10), data, 10, len, opcode));
+  TEST_ASSERT_EQUAL_UINT32(1, rx.stats().protocol);
+
+  // zu groß, schon am Frame-Header erkennbar
+  TEST_ASSERT_NULL(rx.feed(2, frame(0, WS_TEXT, WS_TEXT, true, 300, 0), data, 100, len, opcode));
+  TEST_ASSERT_NULL(rx.feed(2, frame(0, WS_TEXT, WS_TEXT, true, 300, 100), data, 200, len, opcode));
+  TEST_ASSERT_EQUAL_UINT32(1, rx.stats().oversized);
+
+  // Fortsetzung ohne Anfang wird ignoriert
+  TEST_ASSERT_NULL(rx.feed(3, frame(1, WS_CONTINUATION, WS_TEXT, true, 4, 0), data, 4, len, opcode));
+
+  // danach funktioniert derselbe Client wieder
+  const uint8_t ok[] = "{\"led\":true}";
+  const uint8_t *msg = rx.feed(1, frame(0, WS_TEXT, WS_TEXT, true, sizeof(ok) - 1, 0), ok, sizeof(ok) - 1, len, opcode);
+  TEST_ASSERT_TRUE(msg == ok);   // ein Event: ohne Kopie
+  TEST_ASSERT_EQUAL_UINT32(sizeof(ok) - 1, len);
+}
+
+// Pool wie in handleWsMessage: ein Befehl passt in 2048 Bytes, ein größeres
+// Dokument meldet NoMemory statt auf den Heap auszuweichen
+void test_json_pool_parses_command_and_rejects_oversized() {
+  static JsonPoolAllocator<2048> pool;
+
+  {
+    const char cmd[] = "{\"led\":true,\"blink\":false}";
+    JsonDocument doc(&pool);
+    DeserializationError err = deserializeJson(doc, cmd, sizeof(cmd) - 1);
+    TEST_ASSERT_TRUE(err == DeserializationError::Ok);
+    TEST_ASSERT_TRUE(doc["led"].is<bool>());
+    TEST_ASSERT_TRUE(doc["led"].as<bool>());
+    TEST_ASSERT_TRUE(pool.used() > 0);
+    TEST_ASSERT_TRUE(pool.used() <= 2048);
+  }
+
+  pool.reset();
+  {
+    String big = "{\"text\":\"";
+    for (int i = 0; i < 3000; i++) big += 'x';
+    big += "\"}";
+    JsonDocument doc(&pool);
+    DeserializationError err = deserializeJson(doc, big.c_str(), big.length());
+    TEST_ASSERT_TRUE(err == DeserializationError::NoMemory);
+  }
+}
+
+int main() {
+  Serial.setOutput(nullptr);
+  UNITY_BEGIN();
+  RUN_TEST(test_fanout_stalled_client_is_bounded);
+  RUN_TEST(test_fanout_snapshot_after_recovery);
+  RUN_TEST(test_publish_counts_fields_for_binary_clients);
+  RUN_TEST(test_reassembler_fuzz_interleaved_clients);
+  RUN_TEST(test_reassembler_rejects_broken_sequences);
+  RUN_TEST(test_json_pool_parses_command_and_rejects_oversized);
+  return UNITY_END();
+}
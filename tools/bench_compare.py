@@ -0,0 +1,70 @@
+# Vergleicht zwei Ergebnisdateien von env:native_bench (bench/bench_main.cpp).
+#
+#   python tools/bench_compare.py alt.json neu.json [--threshold 10]
+#
+# Zeigt pro Fall Durchsatz, Allokationen und Heap-Spitze mit Änderung in %.
+# Exit-Code 1, wenn ein Fall beim Durchsatz um mehr als --threshold Prozent
+# langsamer wurde oder mehr Allokationen/Heap braucht.
+
+import json
+import sys
+
+COLUMNS = [
+    # Schlüssel, Überschrift, größer ist besser
+    ("ops_per_sec", "ops/s", True),
+    ("allocs_per_op", "allocs/op", False),
+    ("bytes_per_op", "bytes/op", False),
+    ("peak_heap", "peak heap", False),
+    ("wire_bytes", "wire", False),
+]
+
+
+def load(path):
+    with open(path) as f:
+        return {r["name"]: r for r in json.load(f)["results"]}
+
+
+def change(old, new):
+    if old == 0:
+        return 0.0 if new == 0 else float("inf")
+    return (new - old) * 100.0 / old
+
+
+def main(argv):
+    threshold = 10.0
+    if "--threshold" in argv:
+        i = argv.index("--threshold")
+        threshold = float(argv[i + 1])
+        del argv[i:i + 2]
+    if len(argv) != 3:
+        print("usage: bench_compare.py alt.json neu.json [--threshold N]")
+        return 2
+
+    old, new = load(argv[1]), load(argv[2])
+    regressions = []
+    print("%-28s" % "Fall" + "".join("%24s" % title for _, title, _ in COLUMNS))
+    for name in sorted(set(old) | set(new)):
+        if name not in old or name not in new:
+            print("%-28s %s" % (name, "nur in " + (argv[2] if name in new else argv[1])))
+            continue
+        cells = []
+        for key, _, higher_is_better in COLUMNS:
+            a, b = old[name].get(key, 0), new[name].get(key, 0)
+            pct = change(a, b)
+            cells.append("%12.6g %+9.1f%% " % (b, pct))
+            worse = -pct if higher_is_better else pct
+            # Durchsatz schwankt, daher mit Schwelle; Speicher ist bis auf
+            # Mittelung über unterschiedlich viele Durchläufe deterministisch
+            if key == "ops_per_sec" and worse > threshold:
+                regressions.append("%s: %s %.1f%% langsamer" % (name, key, worse))
+            elif key in ("allocs_per_op", "peak_heap") and worse > 1.0:
+                regressions.append("%s: %s %g -> %g" % (name, key, a, b))
+        print("%-28s" % name + "".join(cells))
+
+    for r in regressions:
+        print("REGRESSION " + r)
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
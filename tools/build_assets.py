@@ -0,0 +1,184 @@
+# PlatformIO pre-Script: bereitet data/ für das SPIFFS-Image vor.
+#  - kopiert alle Dateien nach data_dir (.pio/data)
+#  - legt eine .gz-Variante an, wenn sie merklich kleiner ist
+#  - erzeugt src/assets_generated.h mit ETag (Inhalts-Hash), Größen und
+#    ASSET_VERSION (Hash über alle Dateien, für ?v= in html_template.h)
+#  - packt alles in ein Asset-Bundle (.pio/assets.bin) für die Partition
+#    "assets", Format siehe src/AssetBundle.h; schreiben mit
+#    pio run -t uploadassets
+#
+# Auch ohne PlatformIO nutzbar:  python tools/build_assets.py <data> <out> <header> [bundle]
+# (bundle ohne Angabe: assets.bin neben <out>)
+
+import gzip
+import hashlib
+import os
+import shutil
+import struct
+import sys
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".htm": "text/html",
+    ".css": "text/css",
+    ".js": "application/javascript",
+    ".json": "application/json",
+    ".png": "image/png",
+    ".jpg": "image/jpeg",
+    ".gif": "image/gif",
+    ".ico": "image/x-icon",
+    ".svg": "image/svg+xml",
+    ".txt": "text/plain",
+}
+GZIP_MIN_SAVING = 0.9   # .gz nur behalten, wenn < 90 % der Originalgröße
+
+BUNDLE_MAGIC = 0x31425341       # "ASB1"
+BUNDLE_HEADER = struct.Struct("<III8s")
+BUNDLE_ENTRY = struct.Struct("<8I")
+BUNDLE_PARTITION = "assets"
+
+
+def content_type(name):
+    return CONTENT_TYPES.get(os.path.splitext(name)[1].lower(), "application/octet-stream")
+
+
+def write_if_changed(path, data):
+    """Nur schreiben wenn geändert, sonst baut PlatformIO jedes Mal neu."""
+    mode = "b" if isinstance(data, bytes) else ""
+    old = None
+    if os.path.exists(path):
+        with open(path, "r" + mode) as f:
+            old = f.read()
+    if old != data:
+        with open(path, "w" + mode) as f:
+            f.write(data)
+
+
+def pack_bundle(assets, version):
+    """Kopf, nach Pfad sortierter Index, Strings, Daten (4-Byte-ausgerichtet).
+    Offsets relativ zum Bundle-Anfang; Strings und Rohdaten enden mit '\\0',
+    damit Seiten direkt aus dem Flash als C-String gelesen werden können."""
+    index_end = BUNDLE_HEADER.size + BUNDLE_ENTRY.size * len(assets)
+    blob = bytearray()
+
+    def put(data, align=1):
+        while (index_end + len(blob)) % align:
+            blob.append(0)
+        offset = index_end + len(blob)
+        blob.extend(data)
+        return offset
+
+    strings = []
+    for path, ctype, etag, data, packed in assets:
+        strings.append((put(path.encode() + b"\0"), put(ctype.encode() + b"\0"), put(etag.encode() + b"\0")))
+    entries = []
+    for (path, ctype, etag, data, packed), (path_off, ctype_off, etag_off) in zip(assets, strings):
+        data_off = put(data + b"\0", 4)
+        gz_off = put(packed, 4) if packed else 0
+        entries.append(BUNDLE_ENTRY.pack(path_off, len(path.encode()), ctype_off, etag_off,
+                                         data_off, len(data), gz_off, len(packed) if packed else 0))
+    while len(blob) % 4:
+        blob.append(0)
+
+    size = index_end + len(blob)
+    head = BUNDLE_HEADER.pack(BUNDLE_MAGIC, len(assets), size, version.encode())
+    return head + b"".join(entries) + bytes(blob)
+
+
+def build(src_dir, out_dir, header, bundle=None):
+    if os.path.isdir(out_dir):
+        shutil.rmtree(out_dir)
+    os.makedirs(out_dir)
+
+    assets = []
+    contents = {}
+    version = hashlib.sha256()
+    for root, dirs, files in os.walk(src_dir):
+        dirs.sort()
+        for name in sorted(files):
+            src = os.path.join(root, name)
+            rel = "/" + os.path.relpath(src, src_dir).replace(os.sep, "/")
+            dst = os.path.join(out_dir, rel[1:])
+            os.makedirs(os.path.dirname(dst), exist_ok=True)
+
+            with open(src, "rb") as f:
+                data = f.read()
+            shutil.copyfile(src, dst)
+
+            etag = hashlib.sha256(data).hexdigest()[:16]
+            version.update(rel.encode() + etag.encode())
+
+            packed = gzip.compress(data, compresslevel=9, mtime=0)
+            gz_size = 0
+            if len(packed) < len(data) * GZIP_MIN_SAVING:
+                with open(dst + ".gz", "wb") as f:
+                    f.write(packed)
+                gz_size = len(packed)
+            contents[rel] = (data, packed if gz_size else None)
+
+            assets.append((rel, content_type(name), etag, len(data), gz_size))
+
+    # sortiert nach Pfad (Bytes wie strcmp) -> binäre Suche in StaticAssetHandler/AssetBundle
+    assets.sort(key=lambda a: a[0].encode())
+    lines = [
+        "// Erzeugt von tools/build_assets.py – nicht von Hand ändern",
+        "#pragma once",
+        "",
+        '#define ASSET_VERSION "%s"' % version.hexdigest()[:8],
+        "#define ASSET_TABLE_ENTRIES \\",
+    ]
+    for path, ctype, etag, size, gz_size in assets:
+        lines.append('    {"%s", "%s", "%s", %d, %d}, \\' % (path, ctype, etag, size, gz_size))
+    lines.append("")
+    write_if_changed(header, "\n".join(lines) + "\n")
+
+    if bundle is None:
+        bundle = os.path.join(os.path.dirname(os.path.abspath(out_dir)), "assets.bin")
+    image = pack_bundle([(path, ctype, etag) + contents[path] for path, ctype, etag, size, gz_size in assets],
+                         version.hexdigest()[:8])
+    write_if_changed(bundle, image)
+
+    print("Assets: %d Dateien, Version %s, Bundle %d Bytes"
+          % (len(assets), version.hexdigest()[:8], len(image)))
+    return bundle
+
+
+def partition_offset(table, label):
+    """Offset der Partition label aus partitions.csv, None wenn nicht vorhanden."""
+    with open(table) as f:
+        for line in f:
+            fields = [x.strip() for x in line.split("#")[0].split(",")]
+            if len(fields) >= 5 and fields[0] == label:
+                return fields[3], int(fields[4], 0)
+    return None
+
+
+if __name__ == "__main__":
+    build(sys.argv[1], sys.argv[2], sys.argv[3], sys.argv[4] if len(sys.argv) > 4 else None)
+else:
+    Import("env")  # noqa: F821 (SCons)
+    bundle = build(os.path.join(env.subst("$PROJECT_DIR"), "data"),       # noqa: F821
+                   env.subst("$PROJECT_DATA_DIR"),                        # noqa: F821
+                   os.path.join(env.subst("$PROJECT_SRC_DIR"), "assets_generated.h"))  # noqa: F821
+
+    # pio run -t uploadassets: Bundle per esptool in die Partition "assets"
+    # schreiben; das App-Image (und ein OTA-Update) enthält es nicht
+    table = os.path.join(env.subst("$PROJECT_DIR"),                       # noqa: F821
+                         env.GetProjectOption("board_build.partitions", "partitions.csv"))  # noqa: F821
+    if env.get("PIOPLATFORM") == "espressif32" and os.path.exists(table):  # noqa: F821
+        partition = partition_offset(table, BUNDLE_PARTITION)
+        if partition and os.path.getsize(bundle) > partition[1]:
+            sys.stderr.write("Asset-Bundle (%d Bytes) passt nicht in die Partition \"%s\" (%d Bytes)\n"
+                             % (os.path.getsize(bundle), BUNDLE_PARTITION, partition[1]))
+            env.Exit(1)  # noqa: F821
+        if partition:
+            def upload_bundle(target, source, env):
+                cmd = ['"$PYTHONEXE"', '"$UPLOADER"', "--chip", "esp32"]
+                if env.subst("$UPLOAD_PORT"):
+                    cmd += ["--port", '"$UPLOAD_PORT"']
+                cmd += ["--baud", "$UPLOAD_SPEED", "write_flash", partition[0], '"%s"' % bundle]
+                return env.Execute(" ".join(cmd))
+
+            env.AddCustomTarget(  # noqa: F821
+                name="uploadassets", dependencies=None, actions=[upload_bundle],
+                title="Upload Assets", description="Asset-Bundle in die Partition \"assets\" schreiben")
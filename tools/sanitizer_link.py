@@ -0,0 +1,7 @@
+# PlatformIO-Script für env:native_tsan: -fsanitize=... aus build_flags landet
+# nur beim Übersetzen, der Linker braucht es ebenfalls (Laufzeitbibliothek).
+
+Import("env")
+
+flags = [f for f in env.get("CCFLAGS", []) if str(f).startswith("-fsanitize=")]
+env.Append(LINKFLAGS=flags)